@@ -5,6 +5,7 @@
 #include <drivers/gpio.hpp>
 #include <system/defer.hpp>
 #include <system/ringBuffer.hpp>
+#include <system/spscRingBuffer.hpp>
 #include <blob.hpp>
 
 class ConnComInterface {
@@ -17,10 +18,10 @@ public:
           _reader( _uart, Dma::allocate( DMA1 ) ),
           _writer( _uart, Dma::allocate( DMA1 ) ),
           _busy( false ),
-          _inQueue( memory::Pool::allocate( 64 ), 64 ),
           _outQueue( memory::Pool::allocate( 64 ), 64 )
     {
         _uart.enable();
+        Crc::useDma( Dma::allocate( DMA1 ) );
         _receiveFrame();
     }
 
@@ -37,11 +38,17 @@ public:
         Defer::job([&, b = std::move( blob )]() mutable {
             HAL_Delay(100);
             int length = blobLen( b );
-            uint32_t crc = Crc::compute( blobBody( b ), length );
-            crcField( b ) = crc;
-            _outQueue.push_back( std::move( b ) );
-            if ( !_busy )
-                _transmitFrame( _outQueue.pop_front() );
+            const uint8_t *body = blobBody( b );
+            // The callback might run in the DMA interrupt, return to the main
+            // loop before touching the queue
+            Crc::computeAsync( body, length, [&, b = std::move( b )]( uint32_t crc ) mutable {
+                Defer::job([&, b = std::move( b ), crc ]() mutable {
+                    crcField( b ) = crc;
+                    _outQueue.push_back( std::move( b ) );
+                    if ( !_busy )
+                        _transmitFrame( _outQueue.pop_front() );
+                });
+            });
         });
     }
 
@@ -105,20 +112,28 @@ private:
                 Dbg::warning( "Invalid blob size, %d", length );
                 return;
             }
-            uint32_t crc = Crc::compute( blobBody( blob ), length );
-            if ( crc != crcField( blob ) ) {
-                Dbg::warning( "Blob CRC mismatch" );
-                return;
-            }
-            Dbg::info( "New blob received: %d, %.*s", length, length, blob.get() + 4 );
-            if ( !_inQueue.push_back( std::move( blob ) ) ) {
-                Dbg::info( "Queue is full" );
-            }
-            if ( _notifyNewBlob )
-                _notifyNewBlob();
+            const uint8_t *body = blobBody( blob );
+            Crc::computeAsync( body, length, [&, blob = std::move( blob ), length ]( uint32_t crc ) mutable {
+                Defer::job([&, blob = std::move( blob ), length, crc ]() mutable {
+                    _onBlobChecksum( std::move( blob ), length, crc );
+                } );
+            } );
         } );
     }
 
+    void _onBlobChecksum( Block blob, int length, uint32_t crc ) {
+        if ( crc != crcField( blob ) ) {
+            Dbg::warning( "Blob CRC mismatch" );
+            return;
+        }
+        Dbg::info( "New blob received: %d, %.*s", length, length, blob.get() + 4 );
+        if ( !_inQueue.push_back( std::move( blob ) ) ) {
+            Dbg::info( "Queue is full" );
+        }
+        if ( _notifyNewBlob )
+            _notifyNewBlob();
+    }
+
     void _transmitFrame( Block blob ) {
         Dbg::error("Starting to trasmit!");
         while ( _busy );
@@ -154,7 +169,12 @@ private:
     UartReader< memory::Pool > _reader;
     UartWriter< memory::Pool > _writer;
     volatile bool _busy;
-    RingBuffer< Block, memory::Pool > _inQueue, _outQueue;
+    // Received blobs are pushed from the main loop and popped by the SPI
+    // command handler
+    SpscRingBuffer< Block, 16 > _inQueue;
+    // Blobs to send are popped either from the main loop or from the DMA
+    // interrupt, so they do not fit the single consumer scheme
+    RingBuffer< Block, memory::Pool > _outQueue;
     std::function< void(void) > _notifyNewBlob;
     Block _txBlock;
     static const int _timeout = 64;
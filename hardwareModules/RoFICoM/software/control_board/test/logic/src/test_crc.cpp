@@ -0,0 +1,45 @@
+#include <catch.hpp>
+#include <system/softCrc.hpp>
+#include <cstring>
+#include <vector>
+
+TEST_CASE( "softCrc: check value" ) {
+    // CRC-32/MPEG-2 check value - matches the STM32 CRC unit in its default
+    // configuration
+    const char *check = "123456789";
+    auto data = reinterpret_cast< const uint8_t * >( check );
+    CHECK( SoftCrc::compute( data, 9 ) == 0x0376E6E7 );
+    CHECK( SoftCrc::computeBitwise( data, 9 ) == 0x0376E6E7 );
+    CHECK( SoftCrc::compute( data, 0 ) == SoftCrc::INIT );
+}
+
+TEST_CASE( "softCrc: slicing matches bitwise reference" ) {
+    std::vector< uint8_t > data( 600 );
+    uint32_t seed = 42;
+    for ( auto& x : data ) {
+        seed = seed * 1103515245 + 12345;
+        x = seed >> 24;
+    }
+
+    for ( int length : { 1, 3, 7, 8, 9, 15, 16, 17, 63, 64, 511, 512, 600 } ) {
+        INFO( "Length " << length );
+        for ( int offset : { 0, 1, 3 } ) {
+            if ( offset + length > int( data.size() ) )
+                continue;
+            CHECK( SoftCrc::compute( data.data() + offset, length )
+                == SoftCrc::computeBitwise( data.data() + offset, length ) );
+        }
+    }
+}
+
+TEST_CASE( "softCrc: incremental update" ) {
+    std::vector< uint8_t > data( 100 );
+    for ( int i = 0; i != 100; i++ )
+        data[ i ] = uint8_t( i * 7 );
+    uint32_t whole = SoftCrc::compute( data.data(), 100 );
+    for ( int split : { 0, 5, 8, 50, 99 } ) {
+        uint32_t crc = SoftCrc::compute( data.data(), split );
+        crc = SoftCrc::update( crc, data.data() + split, 100 - split );
+        CHECK( crc == whole );
+    }
+}
@@ -0,0 +1,132 @@
+#include <catch.hpp>
+#include <system/spscRingBuffer.hpp>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <deque>
+#include <thread>
+
+TEST_CASE( "spscRingBuffer: basic" ) {
+    SpscRingBuffer< int, 8 > buffer;
+    CHECK( buffer.capacity() == 8 );
+    CHECK( buffer.size() == 0 );
+    CHECK( buffer.available() == 8 );
+    CHECK( buffer.empty() );
+    CHECK( !buffer.full() );
+    CHECK( !buffer.try_pop_front() );
+
+    for ( int i = 0; i != 20; i++ ) {
+        INFO( "Iteration " << i );
+        for ( int j = 0; j != 8; j++ )
+            CHECK( buffer.push_back( i + j ) );
+        CHECK( buffer.full() );
+        CHECK( !buffer.push_back( 42 ) );
+        CHECK( buffer.size() == 8 );
+
+        CHECK( buffer.front() == i );
+        for ( int j = 0; j != 5; j++ )
+            CHECK( buffer.pop_front() == i + j );
+        CHECK( buffer.size() == 3 );
+        CHECK( buffer.available() == 5 );
+        auto x = buffer.try_pop_front();
+        REQUIRE( x );
+        CHECK( *x == i + 5 );
+        buffer.clear();
+        CHECK( buffer.empty() );
+    }
+}
+
+TEST_CASE( "spscRingBuffer: move-only elements" ) {
+    SpscRingBuffer< std::unique_ptr< int >, 4 > buffer;
+    CHECK( buffer.push_back( std::make_unique< int >( 1 ) ) );
+    CHECK( buffer.emplace_back( new int( 2 ) ) );
+    CHECK( *buffer.pop_front() == 1 );
+    CHECK( *buffer.pop_front() == 2 );
+}
+
+TEST_CASE( "spscRingBuffer: concurrent producer and consumer" ) {
+    const uint32_t count = 1 << 20;
+    SpscRingBuffer< uint32_t, 64 > buffer;
+
+    std::thread producer( [&] {
+        for ( uint32_t i = 0; i != count; ) {
+            if ( buffer.push_back( i ) )
+                i++;
+            else
+                std::this_thread::yield();
+        }
+    } );
+
+    uint32_t expected = 0;
+    bool ordered = true;
+    while ( expected != count ) {
+        auto x = buffer.try_pop_front();
+        if ( !x ) {
+            std::this_thread::yield();
+            continue;
+        }
+        ordered = ordered && *x == expected;
+        expected++;
+    }
+    producer.join();
+
+    CHECK( ordered );
+    CHECK( buffer.empty() );
+}
+
+namespace {
+
+template < typename Push, typename Pop >
+double measureThroughput( uint32_t count, Push push, Pop pop ) {
+    auto start = std::chrono::steady_clock::now();
+    std::thread producer( [&] {
+        for ( uint32_t i = 0; i != count; ) {
+            if ( push( i ) )
+                i++;
+            else
+                std::this_thread::yield();
+        }
+    } );
+    for ( uint32_t received = 0; received != count; ) {
+        if ( pop() )
+            received++;
+        else
+            std::this_thread::yield();
+    }
+    producer.join();
+    std::chrono::duration< double > elapsed = std::chrono::steady_clock::now() - start;
+    return count / elapsed.count() / 1e6;
+}
+
+} // namespace
+
+TEST_CASE( "spscRingBuffer: throughput", "[.][benchmark]" ) {
+    const uint32_t count = 1 << 24;
+
+    SpscRingBuffer< uint32_t, 1024 > spsc;
+    double spscRate = measureThroughput( count,
+        [&]( uint32_t i ) { return spsc.push_back( i ); },
+        [&] { return spsc.try_pop_front().has_value(); } );
+
+    std::mutex m;
+    std::deque< uint32_t > deque;
+    double lockedRate = measureThroughput( count,
+        [&]( uint32_t i ) {
+            std::lock_guard< std::mutex > lk( m );
+            if ( deque.size() == 1024 )
+                return false;
+            deque.push_back( i );
+            return true;
+        },
+        [&] {
+            std::lock_guard< std::mutex > lk( m );
+            if ( deque.empty() )
+                return false;
+            deque.pop_front();
+            return true;
+        } );
+
+    std::cout << "SpscRingBuffer: " << spscRate << " Mitems/s\n"
+              << "mutex + deque:  " << lockedRate << " Mitems/s\n";
+}
@@ -1,11 +1,69 @@
 #include <stm32g0xx_hal.h>
 #include <system/dbg.hpp>
+#include <system/softCrc.hpp>
+#include <drivers/crc.hpp>
+
+Dbg& dbgInstance() {
+    static Dbg inst(
+        USART1, Dma::allocate( DMA1, 1 ), Dma::allocate( DMA1, 2 ),
+        TxOn( GpioB[ 6 ] ),
+        RxOn( GpioB[ 7 ] ),
+        Baudrate( 115200 ) );
+    return inst;
+}
+
+// Run the computation repeatedly for given amount of bytes and report the cost
+// per byte in nanoseconds
+template < typename F >
+void benchmark( const char *name, int length, F compute ) {
+    const int totalBytes = 1 << 20;
+    const int iterations = totalBytes / length;
+    uint32_t sink = 0;
+    uint32_t start = HAL_GetTick();
+    for ( int i = 0; i != iterations; i++ )
+        sink ^= compute();
+    uint32_t elapsed = HAL_GetTick() - start;
+    int nsPerByte = int( uint64_t( elapsed ) * 1000000 / ( uint64_t( iterations ) * length ) );
+    Dbg::info( "%s, %d B: %d ns/B (%lu ms, checksum %08lx)",
+        name, length, nsPerByte, elapsed, sink );
+}
 
 int main() {
     HAL_Init();
 
-    Dbg::info("Test started");
+    Dbg::info( "CRC benchmark started" );
+
+    static uint8_t buffer[ 512 ];
+    for ( int i = 0; i != 512; i++ )
+        buffer[ i ] = uint8_t( i * 31 + 7 );
+
+    Crc::useDma( Dma::allocate( DMA1 ) );
+    Crc::setDmaThreshold( 0 );
+
+    for ( int length : { 16, 64, 128, 512 } ) {
+        uint32_t soft = SoftCrc::compute( buffer, length );
+        uint32_t hard = Crc::compute( buffer, length );
+        if ( soft != hard )
+            Dbg::error( "Checksum mismatch, %d B: %08lx vs %08lx", length, soft, hard );
+
+        benchmark( "software", length, [&] {
+            return SoftCrc::compute( buffer, length );
+        } );
+        benchmark( "hardware", length, [&] {
+            return Crc::compute( buffer, length );
+        } );
+        benchmark( "hardware+dma", length, [&] {
+            volatile bool done = false;
+            uint32_t result = 0;
+            Crc::computeAsync( buffer, length, [&]( uint32_t crc ) {
+                result = crc;
+                done = true;
+            } );
+            while ( !done );
+            return result;
+        } );
+    }
 
-    Dbg::info("Test finished");
+    Dbg::info( "CRC benchmark finished" );
     while( true );
-}
\ No newline at end of file
+}
@@ -24,7 +24,8 @@ function(add_rust_library TARGET_NAME)
     endif()
 
     if(RRC_FEATURES)
-        set(FEATURES_FLAG --features "${RRC_FEATURES}")
+        list(JOIN RRC_FEATURES "," FEATURES_LIST)
+        set(FEATURES_FLAG --features "${FEATURES_LIST}")
     else()
         set(FEATURES_FLAG "")
     endif()
@@ -82,7 +83,8 @@ function(add_rust_executable TARGET_NAME)
     endif()
 
     if(RRC_FEATURES)
-        set(FEATURES_FLAG --features "${RRC_FEATURES}")
+        list(JOIN RRC_FEATURES "," FEATURES_LIST)
+        set(FEATURES_FLAG --features "${FEATURES_LIST}")
     else()
         set(FEATURES_FLAG "")
     endif()
@@ -131,7 +133,8 @@ function(add_rust_tests TARGET_NAME)
     endif()
 
     if(RRC_FEATURES)
-        set(FEATURES_FLAG --features "${RRC_FEATURES}")
+        list(JOIN RRC_FEATURES "," FEATURES_LIST)
+        set(FEATURES_FLAG --features "${FEATURES_LIST}")
     else()
         set(FEATURES_FLAG "")
     endif()
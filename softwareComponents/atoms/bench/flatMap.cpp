@@ -0,0 +1,100 @@
+// Lookup and iteration comparison of FlatMap and the node-based maps.
+//
+// Usage: bench-atoms-flatmap [lookupsPerSize]
+
+#include <atoms/flat_map.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// Prevent the compiler from optimizing the measured work away
+volatile long sink = 0;
+
+/**
+ * \brief Return nanoseconds per random successful lookup
+ */
+template < typename Map >
+double measureLookup( const Map & map, const std::vector< int > & queries )
+{
+    long sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for ( int key : queries ) {
+        sum += map.find( key )->second;
+    }
+    std::chrono::duration< double, std::nano > elapsed = std::chrono::steady_clock::now() - start;
+    sink = sum;
+    return elapsed.count() / double( queries.size() );
+}
+
+/**
+ * \brief Return nanoseconds per element of a full iteration
+ */
+template < typename Map >
+double measureIteration( const Map & map, int repetitions )
+{
+    long sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for ( int i = 0; i != repetitions; i++ ) {
+        for ( const auto & [ key, value ] : map ) {
+            sum += value;
+        }
+    }
+    std::chrono::duration< double, std::nano > elapsed = std::chrono::steady_clock::now() - start;
+    sink = sum;
+    return elapsed.count() / double( repetitions ) / double( map.size() );
+}
+
+template < typename Map >
+void report( const std::string & name, const std::vector< int > & keys,
+             const std::vector< int > & queries )
+{
+    std::vector< std::pair< int, int > > values;
+    for ( int key : keys ) {
+        values.emplace_back( key, key );
+    }
+    // Bulk construction, inserting one by one is quadratic for FlatMap
+    Map map( values.begin(), values.end() );
+    int repetitions = std::max( 1, int( queries.size() / keys.size() ) );
+    std::cout << std::left << std::setw( 16 ) << name << std::right << std::setw( 8 ) << keys.size()
+              << std::setw( 12 ) << std::fixed << std::setprecision( 2 )
+              << measureLookup( map, queries ) << std::setw( 12 )
+              << measureIteration( map, repetitions ) << "\n";
+}
+
+} // namespace
+
+int main( int argc, char ** argv )
+{
+    int lookups = argc > 1 ? std::atoi( argv[ 1 ] ) : 1 << 22;
+
+    std::cout << std::left << std::setw( 16 ) << "map" << std::right << std::setw( 8 ) << "size"
+              << std::setw( 12 ) << "lookup ns" << std::setw( 12 ) << "iter ns" << "\n";
+
+    std::mt19937 gen( 42 );
+    for ( int size : { 8, 64, 512, 4096, 32768, 262144 } ) {
+        // Sparse keys in random order to avoid the best case of a sorted input
+        std::vector< int > keys( size );
+        std::iota( keys.begin(), keys.end(), 0 );
+        std::ranges::transform( keys, keys.begin(), []( int x ) { return 3 * x + 1; } );
+        std::ranges::shuffle( keys, gen );
+
+        std::uniform_int_distribution< int > dist( 0, size - 1 );
+        std::vector< int > queries( lookups );
+        std::ranges::generate( queries, [ & ] { return keys[ dist( gen ) ]; } );
+
+        report< std::map< int, int > >( "std::map", keys, queries );
+        report< std::unordered_map< int, int > >( "unordered_map", keys, queries );
+        report< atoms::FlatMap< int, int > >( "FlatMap", keys, queries );
+    }
+}
@@ -0,0 +1,102 @@
+// Throughput comparison of ConcurrentQueue and the lock-free bounded queues.
+//
+// Usage: bench-atoms-queues [itemsPerProducer]
+
+#include <atoms/concurrent_queue.hpp>
+#include <atoms/lockfree_queue.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/**
+ * \brief Run given number of producers and consumers and return throughput in
+ * millions of items per second
+ */
+template < typename Queue >
+double measure( Queue & queue, int producers, int consumers, int itemsPerProducer )
+{
+    const long total = long( producers ) * itemsPerProducer;
+    std::atomic< long > consumed = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        std::vector< std::jthread > threads;
+        for ( int p = 0; p != producers; p++ ) {
+            threads.emplace_back( [ & ] {
+                for ( int i = 0; i != itemsPerProducer; i++ ) {
+                    queue.push( i );
+                }
+            } );
+        }
+        for ( int c = 0; c != consumers; c++ ) {
+            threads.emplace_back( [ & ]( std::stop_token stoken ) {
+                while ( queue.pop( stoken ) ) {
+                    if ( consumed.fetch_add( 1, std::memory_order_relaxed ) + 1 == total ) {
+                        break;
+                    }
+                }
+            } );
+        }
+        while ( consumed.load() < total ) {
+            std::this_thread::sleep_for( std::chrono::microseconds( 100 ) );
+        }
+        for ( auto & t : threads ) {
+            t.request_stop();
+        }
+    }
+    std::chrono::duration< double > elapsed = std::chrono::steady_clock::now() - start;
+    return double( total ) / elapsed.count() / 1e6;
+}
+
+void report( const std::string & name, int producers, int consumers, double rate )
+{
+    std::cout << std::left << std::setw( 18 ) << name << std::right << std::setw( 4 ) << producers
+              << std::setw( 4 ) << consumers << std::setw( 12 ) << std::fixed << std::setprecision( 2 )
+              << rate << "\n";
+}
+
+} // namespace
+
+int main( int argc, char ** argv )
+{
+    int itemsPerProducer = argc > 1 ? std::atoi( argv[ 1 ] ) : 1 << 20;
+
+    std::cout << std::left << std::setw( 18 ) << "queue" << std::right << std::setw( 4 ) << "P"
+              << std::setw( 4 ) << "C" << std::setw( 12 ) << "Mitems/s" << "\n";
+
+    {
+        atoms::ConcurrentQueue< int > q;
+        report( "ConcurrentQueue", 1, 1, measure( q, 1, 1, itemsPerProducer ) );
+    }
+    {
+        atoms::SpscQueue< int > q;
+        report( "SpscQueue", 1, 1, measure( q, 1, 1, itemsPerProducer ) );
+    }
+
+    // Total number of threads goes from 2 up to 16
+    for ( int threads : { 2, 4, 8, 16 } ) {
+        for ( int producers : { 1, threads / 2, threads - 1 } ) {
+            int consumers = threads - producers;
+            if ( producers == 1 && threads == 2 ) {
+                continue; // Covered by SPSC comparison above
+            }
+            {
+                atoms::ConcurrentQueue< int > q;
+                report( "ConcurrentQueue", producers, consumers,
+                        measure( q, producers, consumers, itemsPerProducer / producers ) );
+            }
+            {
+                atoms::MpmcQueue< int > q;
+                report( "MpmcQueue", producers, consumers,
+                        measure( q, producers, consumers, itemsPerProducer / producers ) );
+            }
+        }
+    }
+}
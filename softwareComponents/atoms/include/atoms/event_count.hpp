@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <stop_token>
+
+static_assert( __cpp_lib_atomic_wait >= 201907L, "atomic wait and notify required" );
+static_assert( __cpp_lib_jthread >= 201911L, "jthread and stop_token required" );
+
+
+namespace atoms
+{
+/**
+ * \brief Condition-variable-like primitive for lock-free data structures
+ *
+ * Allows threads to block until a lock-free condition becomes true without
+ * any mutex. A waiter announces itself via `prepareWait()`, re-checks the
+ * condition and then either calls `cancelWait()` or `wait()`. The notifier
+ * changes the condition and calls `notifyOne()` or `notifyAll()`. The
+ * condition may be published by a release store only; the notifications
+ * contain a full fence, so they cannot miss a waiter.
+ *
+ * The notification is almost free when there are no waiters - it does not
+ * enter the kernel. Blocking uses `std::atomic::wait`, which is futex-based
+ * on Linux.
+ */
+class EventCount
+{
+public:
+    using Key = uint32_t;
+
+    /**
+     * \brief Announce intention to wait and get a key for `wait()`
+     *
+     * Check the condition again after calling this and call either
+     * `cancelWait()` or `wait()`.
+     */
+    Key prepareWait() noexcept
+    {
+        _waiters.fetch_add( 1, std::memory_order_seq_cst );
+        // Pairs with the fence in notify - either the notifier sees the waiter
+        // or the waiter sees the changed condition
+        std::atomic_thread_fence( std::memory_order_seq_cst );
+        return _epoch.load( std::memory_order_seq_cst );
+    }
+
+    void cancelWait() noexcept
+    {
+        _waiters.fetch_sub( 1, std::memory_order_seq_cst );
+    }
+
+    /**
+     * \brief Block until a notification after `prepareWait()` was issued
+     */
+    void wait( Key key ) noexcept
+    {
+        while ( _epoch.load( std::memory_order_seq_cst ) == key ) {
+            _epoch.wait( key, std::memory_order_seq_cst );
+        }
+        _waiters.fetch_sub( 1, std::memory_order_seq_cst );
+    }
+
+    /**
+     * \brief Block until a notification after `prepareWait()` was issued
+     * or stop is requested
+     *
+     * \returns `false` if stop was requested
+     */
+    bool wait( Key key, std::stop_token stoken ) noexcept
+    {
+        // Wake the waiter on stop request by faking a notification
+        std::stop_callback onStop( stoken, [ this ] { notifyAll(); } );
+        while ( _epoch.load( std::memory_order_seq_cst ) == key && !stoken.stop_requested() ) {
+            _epoch.wait( key, std::memory_order_seq_cst );
+        }
+        _waiters.fetch_sub( 1, std::memory_order_seq_cst );
+        return !stoken.stop_requested();
+    }
+
+    void notifyOne() noexcept
+    {
+        std::atomic_thread_fence( std::memory_order_seq_cst );
+        if ( _waiters.load( std::memory_order_seq_cst ) == 0 ) {
+            return;
+        }
+        _epoch.fetch_add( 1, std::memory_order_seq_cst );
+        _epoch.notify_one();
+    }
+
+    void notifyAll() noexcept
+    {
+        std::atomic_thread_fence( std::memory_order_seq_cst );
+        if ( _waiters.load( std::memory_order_seq_cst ) == 0 ) {
+            return;
+        }
+        _epoch.fetch_add( 1, std::memory_order_seq_cst );
+        _epoch.notify_all();
+    }
+
+private:
+    std::atomic< Key > _epoch = 0;
+    std::atomic< uint32_t > _waiters = 0;
+};
+
+} // namespace atoms
@@ -0,0 +1,337 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace atoms {
+
+/**
+ * \brief Tag for FlatMap constructors taking already sorted input without
+ * duplicate keys.
+ */
+struct sorted_unique_t { explicit sorted_unique_t() = default; };
+inline constexpr sorted_unique_t sorted_unique{};
+
+/**
+ * \brief Associative container storing its elements in a sorted contiguous
+ * vector.
+ *
+ * Lookup is a binary search over contiguous memory and iteration is a linear
+ * walk, so both are considerably faster than in node-based std::map for small
+ * and medium sizes. Insertion and erasure of a single element is linear as the
+ * elements have to be shifted; prefer bulk construction or bulk insert() when
+ * building the map.
+ *
+ * If `Compare` is transparent (e.g., the default `std::less<>`), lookup
+ * functions accept any type comparable with the key.
+ *
+ * Unlike std::map, any insertion or erasure invalidates iterators, pointers
+ * and references to the elements.
+ */
+template < typename Key, typename Value, typename Compare = std::less<> >
+class FlatMap {
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair< Key, Value >;
+    using key_compare = Compare;
+    using container_type = std::vector< value_type >;
+    using size_type = typename container_type::size_type;
+    using difference_type = typename container_type::difference_type;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using iterator = typename container_type::iterator;
+    using const_iterator = typename container_type::const_iterator;
+
+private:
+    template < typename K >
+    static constexpr bool isKeyLike = std::is_convertible_v< const K&, const Key& >
+                                   || requires { typename Compare::is_transparent; };
+
+public:
+    FlatMap() = default;
+
+    explicit FlatMap( const Compare& compare ): _compare( compare ) {}
+
+    /**
+     * \brief Build the map from unsorted values in O(n log n)
+     *
+     * For duplicate keys, the first occurrence is kept.
+     */
+    explicit FlatMap( container_type values, const Compare& compare = Compare() )
+        : _container( std::move( values ) ), _compare( compare )
+    {
+        _sortAndUnique( _container.begin() );
+    }
+
+    /**
+     * \brief Adopt values that are already sorted and unique in O(1)
+     */
+    FlatMap( sorted_unique_t, container_type values, const Compare& compare = Compare() )
+        : _container( std::move( values ) ), _compare( compare )
+    {
+        assert( std::ranges::adjacent_find( _container, [&]( const auto& a, const auto& b ) {
+            return !_compare( a.first, b.first );
+        } ) == _container.end() && "Input is not sorted or contains duplicates" );
+    }
+
+    template < typename InputIt >
+    FlatMap( InputIt first, InputIt last, const Compare& compare = Compare() )
+        : FlatMap( container_type( first, last ), compare )
+    {}
+
+    FlatMap( std::initializer_list< value_type > list, const Compare& compare = Compare() )
+        : FlatMap( container_type( list ), compare )
+    {}
+
+    iterator begin() noexcept { return _container.begin(); }
+    const_iterator begin() const noexcept { return _container.begin(); }
+    const_iterator cbegin() const noexcept { return _container.cbegin(); }
+    iterator end() noexcept { return _container.end(); }
+    const_iterator end() const noexcept { return _container.end(); }
+    const_iterator cend() const noexcept { return _container.cend(); }
+
+    [[nodiscard]] bool empty() const noexcept { return _container.empty(); }
+    size_type size() const noexcept { return _container.size(); }
+    size_type capacity() const noexcept { return _container.capacity(); }
+
+    void reserve( size_type newCapacity ) { _container.reserve( newCapacity ); }
+    void shrink_to_fit() { _container.shrink_to_fit(); }
+    void clear() noexcept { _container.clear(); }
+
+    /**
+     * \brief Release the underlying sorted vector
+     */
+    container_type extract() && {
+        return std::move( _container );
+    }
+
+    const container_type& values() const noexcept {
+        return _container;
+    }
+
+    key_compare key_comp() const {
+        return _compare;
+    }
+
+    template < typename K = Key > requires isKeyLike< K >
+    iterator lower_bound( const K& key ) {
+        return begin() + _lowerBoundIndex( key );
+    }
+
+    template < typename K = Key > requires isKeyLike< K >
+    const_iterator lower_bound( const K& key ) const {
+        return begin() + _lowerBoundIndex( key );
+    }
+
+    template < typename K = Key > requires isKeyLike< K >
+    iterator upper_bound( const K& key ) {
+        return std::upper_bound( begin(), end(), key, _lessKey() );
+    }
+
+    template < typename K = Key > requires isKeyLike< K >
+    const_iterator upper_bound( const K& key ) const {
+        return std::upper_bound( begin(), end(), key, _lessKey() );
+    }
+
+    template < typename K = Key > requires isKeyLike< K >
+    iterator find( const K& key ) {
+        auto it = lower_bound( key );
+        return it != end() && !_compare( key, it->first ) ? it : end();
+    }
+
+    template < typename K = Key > requires isKeyLike< K >
+    const_iterator find( const K& key ) const {
+        auto it = lower_bound( key );
+        return it != end() && !_compare( key, it->first ) ? it : end();
+    }
+
+    template < typename K = Key > requires isKeyLike< K >
+    bool contains( const K& key ) const {
+        return find( key ) != end();
+    }
+
+    template < typename K = Key > requires isKeyLike< K >
+    size_type count( const K& key ) const {
+        return contains( key ) ? 1 : 0;
+    }
+
+    /**
+     * \brief Access element with given key
+     *
+     * \throws std::out_of_range if there is no such element
+     */
+    template < typename K = Key > requires isKeyLike< K >
+    Value& at( const K& key ) {
+        auto it = find( key );
+        if ( it == end() )
+            throw std::out_of_range( "FlatMap::at: key not found" );
+        return it->second;
+    }
+
+    template < typename K = Key > requires isKeyLike< K >
+    const Value& at( const K& key ) const {
+        auto it = find( key );
+        if ( it == end() )
+            throw std::out_of_range( "FlatMap::at: key not found" );
+        return it->second;
+    }
+
+    Value& operator[]( const Key& key ) {
+        return try_emplace( key ).first->second;
+    }
+
+    /**
+     * \brief Insert element if the key is not present
+     *
+     * The value is constructed from `args` only if the insertion happens.
+     */
+    template < typename... Args >
+    std::pair< iterator, bool > try_emplace( const Key& key, Args&&... args ) {
+        auto it = lower_bound( key );
+        if ( it != end() && !_compare( key, it->first ) )
+            return { it, false };
+        it = _container.emplace( it, std::piecewise_construct,
+            std::forward_as_tuple( key ), std::forward_as_tuple( std::forward< Args >( args )... ) );
+        return { it, true };
+    }
+
+    template < typename... Args >
+    std::pair< iterator, bool > try_emplace( Key&& key, Args&&... args ) {
+        auto it = lower_bound( key );
+        if ( it != end() && !_compare( key, it->first ) )
+            return { it, false };
+        it = _container.emplace( it, std::piecewise_construct,
+            std::forward_as_tuple( std::move( key ) ),
+            std::forward_as_tuple( std::forward< Args >( args )... ) );
+        return { it, true };
+    }
+
+    template < typename... Args >
+    std::pair< iterator, bool > emplace( Args&&... args ) {
+        value_type value( std::forward< Args >( args )... );
+        return try_emplace( std::move( value.first ), std::move( value.second ) );
+    }
+
+    std::pair< iterator, bool > insert( const value_type& value ) {
+        return try_emplace( value.first, value.second );
+    }
+
+    std::pair< iterator, bool > insert( value_type&& value ) {
+        return try_emplace( std::move( value.first ), std::move( value.second ) );
+    }
+
+    template < typename V >
+    std::pair< iterator, bool > insert_or_assign( const Key& key, V&& value ) {
+        auto [ it, inserted ] = try_emplace( key, std::forward< V >( value ) );
+        if ( !inserted )
+            it->second = std::forward< V >( value );
+        return { it, inserted };
+    }
+
+    /**
+     * \brief Insert a range of elements in O(n + m log m)
+     *
+     * Elements with keys already present in the map are ignored, for
+     * duplicates within the range the first occurrence is kept.
+     */
+    template < typename InputIt >
+    void insert( InputIt first, InputIt last ) {
+        auto oldSize = static_cast< difference_type >( size() );
+        _container.insert( end(), first, last );
+        _sortAndUnique( begin() + oldSize );
+    }
+
+    void insert( std::initializer_list< value_type > list ) {
+        insert( list.begin(), list.end() );
+    }
+
+    iterator erase( const_iterator pos ) {
+        return _container.erase( pos );
+    }
+
+    iterator erase( const_iterator first, const_iterator last ) {
+        return _container.erase( first, last );
+    }
+
+    template < typename K = Key >
+        requires( isKeyLike< K > && !std::is_convertible_v< const K&, const_iterator > )
+    size_type erase( const K& key ) {
+        auto it = find( key );
+        if ( it == end() )
+            return 0;
+        _container.erase( it );
+        return 1;
+    }
+
+    /**
+     * \brief Erase all elements satisfying the predicate
+     *
+     * \returns the number of erased elements
+     */
+    template < typename Pred >
+    friend size_type erase_if( FlatMap& map, Pred pred ) {
+        return std::erase_if( map._container, pred );
+    }
+
+    void swap( FlatMap& other ) noexcept {
+        using std::swap;
+        swap( _container, other._container );
+        swap( _compare, other._compare );
+    }
+
+    friend void swap( FlatMap& a, FlatMap& b ) noexcept {
+        a.swap( b );
+    }
+
+    bool operator==( const FlatMap& other ) const {
+        return _container == other._container;
+    }
+
+private:
+    // Branchless binary search; the halving does not depend on the result of
+    // the comparison, so random lookups do not suffer from branch
+    // mispredictions
+    template < typename K >
+    difference_type _lowerBoundIndex( const K& key ) const {
+        if ( _container.empty() )
+            return 0;
+        const value_type* base = _container.data();
+        size_type length = _container.size();
+        while ( length > 1 ) {
+            size_type half = length / 2;
+            base += half * static_cast< size_type >( _compare( base[ half - 1 ].first, key ) );
+            length -= half;
+        }
+        return ( base - _container.data() ) + ( _compare( base->first, key ) ? 1 : 0 );
+    }
+
+    auto _lessKey() const {
+        return [ this ]( const auto& key, const value_type& a ) { return _compare( key, a.first ); };
+    }
+
+    // Sort the range [ unsortedBegin, end ), merge it with the preceding sorted
+    // range and remove duplicates while keeping the first occurrence
+    void _sortAndUnique( iterator unsortedBegin ) {
+        auto less = [ this ]( const value_type& a, const value_type& b ) {
+            return _compare( a.first, b.first );
+        };
+        std::stable_sort( unsortedBegin, end(), less );
+        std::inplace_merge( begin(), unsortedBegin, end(), less );
+        auto last = std::unique( begin(), end(), [ this ]( const value_type& a, const value_type& b ) {
+            return !_compare( a.first, b.first );
+        } );
+        _container.erase( last, end() );
+    }
+
+    container_type _container;
+    [[no_unique_address]] Compare _compare;
+};
+
+} // namespace atoms
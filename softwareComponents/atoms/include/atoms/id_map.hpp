@@ -0,0 +1,199 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <atoms/flat_map.hpp>
+
+namespace atoms {
+
+/**
+ * \brief Associative container optimized for mostly dense integral ids.
+ *
+ * Small non-negative keys are stored in a direct-indexed vector, so the lookup
+ * is a single bounds check and an indexed load. Keys that would make the
+ * vector too sparse (large or negative ids) go to a FlatMap fallback.
+ *
+ * The invariant is that every key in `[ 0, denseSize() )` is stored in the
+ * dense part and all other keys in the sparse part. The dense part grows
+ * only while at least `1 / maxSparsity` of its slots would be occupied, so
+ * the memory stays linear in the number of elements.
+ *
+ * Any insertion or erasure may invalidate references to the elements.
+ */
+template < std::integral Key, typename Value >
+class IdMap {
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using size_type = std::size_t;
+
+    static constexpr size_type minDenseSize = 64;
+    static constexpr size_type maxSparsity = 4;
+
+    IdMap() = default;
+
+    [[nodiscard]] bool empty() const noexcept { return _size == 0; }
+    size_type size() const noexcept { return _size; }
+    size_type denseSize() const noexcept { return _dense.size(); }
+
+    void clear() noexcept {
+        _dense.clear();
+        _sparse.clear();
+        _size = 0;
+    }
+
+    /**
+     * \brief Get pointer to the value with given key or nullptr if there is no
+     * such element
+     */
+    const Value* find( Key key ) const {
+        if ( _isDense( key ) ) {
+            const auto& slot = _dense[ static_cast< size_type >( key ) ];
+            return slot ? &*slot : nullptr;
+        }
+        auto it = _sparse.find( key );
+        return it != _sparse.end() ? &it->second : nullptr;
+    }
+
+    Value* find( Key key ) {
+        return const_cast< Value* >( std::as_const( *this ).find( key ) );
+    }
+
+    bool contains( Key key ) const {
+        return find( key ) != nullptr;
+    }
+
+    /**
+     * \brief Access element with given key
+     *
+     * \throws std::out_of_range if there is no such element
+     */
+    const Value& at( Key key ) const {
+        auto* value = find( key );
+        if ( !value )
+            throw std::out_of_range( "IdMap::at: key not found" );
+        return *value;
+    }
+
+    Value& at( Key key ) {
+        return const_cast< Value& >( std::as_const( *this ).at( key ) );
+    }
+
+    Value& operator[]( Key key ) {
+        return *try_emplace( key ).first;
+    }
+
+    /**
+     * \brief Insert element if the key is not present
+     *
+     * \returns pointer to the element with given key and whether the insertion
+     * happened
+     */
+    template < typename... Args >
+    std::pair< Value*, bool > try_emplace( Key key, Args&&... args ) {
+        if ( !_isDense( key ) && _shouldGrowDense( key ) )
+            _growDense( static_cast< size_type >( key ) );
+
+        if ( _isDense( key ) ) {
+            auto& slot = _dense[ static_cast< size_type >( key ) ];
+            if ( slot )
+                return { &*slot, false };
+            slot.emplace( std::forward< Args >( args )... );
+            _size++;
+            return { &*slot, true };
+        }
+        auto [ it, inserted ] = _sparse.try_emplace( key, std::forward< Args >( args )... );
+        if ( inserted )
+            _size++;
+        return { &it->second, inserted };
+    }
+
+    std::pair< Value*, bool > insert( const std::pair< Key, Value >& value ) {
+        return try_emplace( value.first, value.second );
+    }
+
+    size_type erase( Key key ) {
+        if ( _isDense( key ) ) {
+            auto& slot = _dense[ static_cast< size_type >( key ) ];
+            if ( !slot )
+                return 0;
+            slot.reset();
+            _size--;
+            return 1;
+        }
+        auto erased = _sparse.erase( key );
+        _size -= erased;
+        return erased;
+    }
+
+    void swap( IdMap& other ) noexcept {
+        using std::swap;
+        swap( _dense, other._dense );
+        swap( _sparse, other._sparse );
+        swap( _size, other._size );
+    }
+
+    friend void swap( IdMap& a, IdMap& b ) noexcept {
+        a.swap( b );
+    }
+
+    /**
+     * \brief Call `f( key, value )` for all elements in the increasing order of
+     * keys
+     */
+    template < typename F >
+    void forEach( F&& f ) const {
+        auto sparseIt = _sparse.begin();
+        for ( ; sparseIt != _sparse.end() && sparseIt->first < 0; ++sparseIt )
+            f( sparseIt->first, sparseIt->second );
+        for ( size_type i = 0; i != _dense.size(); i++ ) {
+            if ( _dense[ i ] )
+                f( static_cast< Key >( i ), *_dense[ i ] );
+        }
+        for ( ; sparseIt != _sparse.end(); ++sparseIt )
+            f( sparseIt->first, sparseIt->second );
+    }
+
+private:
+    bool _isDense( Key key ) const noexcept {
+        if constexpr ( std::is_signed_v< Key > ) {
+            if ( key < 0 )
+                return false;
+        }
+        return static_cast< std::make_unsigned_t< Key > >( key ) < _dense.size();
+    }
+
+    bool _shouldGrowDense( Key key ) const noexcept {
+        if constexpr ( std::is_signed_v< Key > ) {
+            if ( key < 0 )
+                return false;
+        }
+        auto limit = std::max( minDenseSize, maxSparsity * ( _size + 1 ) );
+        return static_cast< std::make_unsigned_t< Key > >( key ) < limit;
+    }
+
+    // Grow the dense part to hold `key` and move the sparse elements that fall
+    // into the new range
+    void _growDense( size_type key ) {
+        auto newSize = std::max( minDenseSize, std::bit_ceil( key + 1 ) );
+        _dense.resize( newSize );
+
+        auto first = _sparse.lower_bound( Key( 0 ) );
+        auto last = first;
+        for ( ; last != _sparse.end() && static_cast< size_type >( last->first ) < newSize; ++last )
+            _dense[ static_cast< size_type >( last->first ) ].emplace( std::move( last->second ) );
+        _sparse.erase( first, last );
+    }
+
+    std::vector< std::optional< Value > > _dense;
+    FlatMap< Key, Value > _sparse;
+    size_type _size = 0;
+};
+
+} // namespace atoms
@@ -0,0 +1,361 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <stop_token>
+#include <thread>
+#include <utility>
+
+#include <atoms/event_count.hpp>
+
+
+namespace atoms
+{
+namespace detail
+{
+    // Avoid false sharing between producer and consumer data
+    inline constexpr std::size_t cacheLineSize = 64;
+
+    inline std::size_t roundUpCapacity( std::size_t capacity )
+    {
+        assert( capacity > 0 );
+        return std::bit_ceil( capacity );
+    }
+
+    /**
+     * \brief Bounded lock-free ring for a single producer and single consumer
+     */
+    template < typename T >
+    class SpscRing
+    {
+    public:
+        explicit SpscRing( std::size_t capacity )
+                : _mask( roundUpCapacity( capacity ) - 1 )
+                , _cells( std::make_unique< std::optional< T >[] >( _mask + 1 ) )
+        {}
+
+        std::size_t capacity() const noexcept
+        {
+            return _mask + 1;
+        }
+
+        template < typename... Args >
+        bool tryEmplace( Args &&... args )
+        {
+            std::size_t tail = _tail.load( std::memory_order_relaxed );
+            if ( tail - _cachedHead == capacity() ) {
+                _cachedHead = _head.load( std::memory_order_acquire );
+                if ( tail - _cachedHead == capacity() ) {
+                    return false;
+                }
+            }
+            _cells[ tail & _mask ].emplace( std::forward< Args >( args )... );
+            _tail.store( tail + 1, std::memory_order_release );
+            return true;
+        }
+
+        std::optional< T > tryPop()
+        {
+            std::size_t head = _head.load( std::memory_order_relaxed );
+            if ( head == _cachedTail ) {
+                _cachedTail = _tail.load( std::memory_order_acquire );
+                if ( head == _cachedTail ) {
+                    return std::nullopt;
+                }
+            }
+            auto & cell = _cells[ head & _mask ];
+            std::optional< T > r = std::move( cell );
+            cell.reset();
+            _head.store( head + 1, std::memory_order_release );
+            return r;
+        }
+
+        bool empty() const noexcept
+        {
+            return _head.load( std::memory_order_acquire ) == _tail.load( std::memory_order_acquire );
+        }
+
+    private:
+        const std::size_t _mask;
+        std::unique_ptr< std::optional< T >[] > _cells;
+
+        alignas( cacheLineSize ) std::atomic< std::size_t > _head = 0;
+        std::size_t _cachedTail = 0;
+        alignas( cacheLineSize ) std::atomic< std::size_t > _tail = 0;
+        std::size_t _cachedHead = 0;
+    };
+
+    /**
+     * \brief Bounded lock-free ring for multiple producers and consumers
+     *
+     * Implementation of Dmitry Vyukov's bounded MPMC queue - each cell carries
+     * a sequence number which tells whether it is ready for writing or reading
+     * in the current lap.
+     */
+    template < typename T >
+    class MpmcRing
+    {
+        struct Cell {
+            std::atomic< std::size_t > sequence;
+            std::optional< T > value;
+        };
+
+    public:
+        explicit MpmcRing( std::size_t capacity )
+                : _mask( roundUpCapacity( capacity ) - 1 )
+                , _cells( std::make_unique< Cell[] >( _mask + 1 ) )
+        {
+            for ( std::size_t i = 0; i <= _mask; i++ ) {
+                _cells[ i ].sequence.store( i, std::memory_order_relaxed );
+            }
+        }
+
+        std::size_t capacity() const noexcept
+        {
+            return _mask + 1;
+        }
+
+        template < typename... Args >
+        bool tryEmplace( Args &&... args )
+        {
+            std::size_t pos = _tail.load( std::memory_order_relaxed );
+            Cell * cell = nullptr;
+            while ( true ) {
+                cell = &_cells[ pos & _mask ];
+                std::size_t seq = cell->sequence.load( std::memory_order_acquire );
+                auto diff = static_cast< std::ptrdiff_t >( seq ) - static_cast< std::ptrdiff_t >( pos );
+                if ( diff == 0 ) {
+                    if ( _tail.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) ) {
+                        break;
+                    }
+                } else if ( diff < 0 ) {
+                    return false; // Full
+                } else {
+                    pos = _tail.load( std::memory_order_relaxed );
+                }
+            }
+            cell->value.emplace( std::forward< Args >( args )... );
+            cell->sequence.store( pos + 1, std::memory_order_release );
+            return true;
+        }
+
+        std::optional< T > tryPop()
+        {
+            std::size_t pos = _head.load( std::memory_order_relaxed );
+            Cell * cell = nullptr;
+            while ( true ) {
+                cell = &_cells[ pos & _mask ];
+                std::size_t seq = cell->sequence.load( std::memory_order_acquire );
+                auto diff = static_cast< std::ptrdiff_t >( seq ) - static_cast< std::ptrdiff_t >( pos + 1 );
+                if ( diff == 0 ) {
+                    if ( _head.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) ) {
+                        break;
+                    }
+                } else if ( diff < 0 ) {
+                    return std::nullopt; // Empty
+                } else {
+                    pos = _head.load( std::memory_order_relaxed );
+                }
+            }
+            std::optional< T > r = std::move( cell->value );
+            cell->value.reset();
+            cell->sequence.store( pos + _mask + 1, std::memory_order_release );
+            return r;
+        }
+
+        bool empty() const noexcept
+        {
+            std::size_t pos = _head.load( std::memory_order_acquire );
+            std::size_t seq = _cells[ pos & _mask ].sequence.load( std::memory_order_acquire );
+            return seq != pos + 1;
+        }
+
+    private:
+        const std::size_t _mask;
+        std::unique_ptr< Cell[] > _cells;
+
+        alignas( cacheLineSize ) std::atomic< std::size_t > _head = 0;
+        alignas( cacheLineSize ) std::atomic< std::size_t > _tail = 0;
+    };
+
+} // namespace detail
+
+
+/**
+ * \brief Bounded lock-free queue with blocking operations
+ *
+ * Offers the same interface as ConcurrentQueue, but the elements are stored in
+ * a preallocated ring and the non-blocking operations do not take any lock.
+ * Blocking operations spin for a short while and then sleep on an EventCount,
+ * so notifications are cheap when nobody waits.
+ *
+ * As the queue is bounded, push blocks while the queue is full; use `tryPush`
+ * to avoid blocking.
+ *
+ * Use SpscQueue or MpmcQueue aliases based on the number of producers and
+ * consumers.
+ */
+template < typename T, template < typename > class Ring >
+class BoundedQueue
+{
+public:
+    static constexpr std::size_t defaultCapacity = 1024;
+
+    explicit BoundedQueue( std::size_t capacity = defaultCapacity ) : _ring( capacity ) {}
+
+    BoundedQueue( const BoundedQueue & ) = delete;
+    BoundedQueue & operator=( const BoundedQueue & ) = delete;
+
+    std::size_t capacity() const noexcept
+    {
+        return _ring.capacity();
+    }
+
+    T pop()
+    {
+        while ( true ) {
+            if ( auto r = _tryPopSpinning() ) {
+                return std::move( *r );
+            }
+            auto key = _notEmpty.prepareWait();
+            if ( auto r = _ring.tryPop() ) {
+                _notEmpty.cancelWait();
+                _notFull.notifyOne();
+                return std::move( *r );
+            }
+            _notEmpty.wait( key );
+        }
+    }
+
+    // Returns nullopt if stop is requested
+    std::optional< T > pop( std::stop_token stoken )
+    {
+        while ( !stoken.stop_requested() ) {
+            if ( auto r = _tryPopSpinning() ) {
+                return r;
+            }
+            auto key = _notEmpty.prepareWait();
+            if ( auto r = _ring.tryPop() ) {
+                _notEmpty.cancelWait();
+                _notFull.notifyOne();
+                return r;
+            }
+            _notEmpty.wait( key, stoken );
+        }
+        return {};
+    }
+
+    std::optional< T > tryPop()
+    {
+        auto r = _ring.tryPop();
+        if ( r ) {
+            _notFull.notifyOne();
+        }
+        return r;
+    }
+
+    template < typename... Args >
+    void emplace( Args &&... args )
+    {
+        // The construction cannot be repeated when the queue is full
+        push( T( std::forward< Args >( args )... ) );
+    }
+
+    void push( const T & x )
+    {
+        push( T( x ) );
+    }
+
+    void push( T && x )
+    {
+        while ( !_tryEmplaceSpinning( std::move( x ) ) ) {
+            auto key = _notFull.prepareWait();
+            if ( _ring.tryEmplace( std::move( x ) ) ) {
+                _notFull.cancelWait();
+                break;
+            }
+            _notFull.wait( key );
+        }
+        _notEmpty.notifyOne();
+    }
+
+    /**
+     * \brief Push the element if there is a space in the queue
+     *
+     * \returns `false` if the queue is full
+     */
+    template < typename U >
+    bool tryPush( U && x )
+    {
+        if ( !_ring.tryEmplace( std::forward< U >( x ) ) ) {
+            return false;
+        }
+        _notEmpty.notifyOne();
+        return true;
+    }
+
+    /**
+     * \brief Check if the queue is empty
+     *
+     * The result is only a snapshot when other threads access the queue.
+     */
+    [[nodiscard]] bool empty() const
+    {
+        return _ring.empty();
+    }
+
+    void clear()
+    {
+        while ( tryPop() ) {}
+    }
+
+private:
+    std::optional< T > _tryPopSpinning()
+    {
+        // Spinning pays off when producers are active; yielding is cheaper
+        // than sleeping on the event count for short gaps
+        for ( int i = 0; i != _spinCount; i++ ) {
+            if ( auto r = _ring.tryPop() ) {
+                _notFull.notifyOne();
+                return r;
+            }
+            std::this_thread::yield();
+        }
+        return std::nullopt;
+    }
+
+    bool _tryEmplaceSpinning( T && x )
+    {
+        for ( int i = 0; i != _spinCount; i++ ) {
+            if ( _ring.tryEmplace( std::move( x ) ) ) {
+                return true;
+            }
+            std::this_thread::yield();
+        }
+        return false;
+    }
+
+    static constexpr int _spinCount = 16;
+
+    Ring< T > _ring;
+    EventCount _notEmpty;
+    EventCount _notFull;
+};
+
+/**
+ * \brief Bounded lock-free queue for a single producer and a single consumer
+ */
+template < typename T >
+using SpscQueue = BoundedQueue< T, detail::SpscRing >;
+
+/**
+ * \brief Bounded lock-free queue for multiple producers and consumers
+ */
+template < typename T >
+using MpmcQueue = BoundedQueue< T, detail::MpmcRing >;
+
+} // namespace atoms
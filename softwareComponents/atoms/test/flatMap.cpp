@@ -0,0 +1,111 @@
+#include <catch2/catch.hpp>
+
+#include <atoms/flat_map.hpp>
+#include <map>
+#include <random>
+#include <string>
+#include <string_view>
+
+using atoms::FlatMap;
+
+TEST_CASE( "FlatMap basic operations" ) {
+    FlatMap< int, std::string > map;
+    REQUIRE( map.empty() );
+    REQUIRE( map.find( 1 ) == map.end() );
+
+    auto [ it, inserted ] = map.insert( { 5, "five" } );
+    REQUIRE( inserted );
+    REQUIRE( it->first == 5 );
+    REQUIRE( !map.insert( { 5, "other" } ).second );
+    REQUIRE( map.at( 5 ) == "five" );
+
+    map.emplace( 1, "one" );
+    map.try_emplace( 3, "three" );
+    map[ 4 ] = "four";
+    REQUIRE( map.size() == 4 );
+
+    SECTION( "elements are sorted" ) {
+        std::vector< int > keys;
+        for ( const auto& [ k, v ] : map )
+            keys.push_back( k );
+        REQUIRE( keys == std::vector{ 1, 3, 4, 5 } );
+    }
+
+    SECTION( "lookup" ) {
+        REQUIRE( map.contains( 3 ) );
+        REQUIRE( !map.contains( 2 ) );
+        REQUIRE( map.count( 4 ) == 1 );
+        REQUIRE( map.lower_bound( 2 )->first == 3 );
+        REQUIRE( map.upper_bound( 3 )->first == 4 );
+        REQUIRE_THROWS_AS( map.at( 42 ), std::out_of_range );
+    }
+
+    SECTION( "erase" ) {
+        REQUIRE( map.erase( 3 ) == 1 );
+        REQUIRE( map.erase( 3 ) == 0 );
+        map.erase( map.begin() );
+        REQUIRE( map.size() == 2 );
+        REQUIRE( map.begin()->first == 4 );
+        REQUIRE( erase_if( map, []( const auto& x ) { return x.first == 5; } ) == 1 );
+        REQUIRE( map.size() == 1 );
+    }
+
+    SECTION( "insert_or_assign" ) {
+        REQUIRE( !map.insert_or_assign( 1, "uno" ).second );
+        REQUIRE( map.at( 1 ) == "uno" );
+        REQUIRE( map.insert_or_assign( 2, "dos" ).second );
+        REQUIRE( map.at( 2 ) == "dos" );
+    }
+}
+
+TEST_CASE( "FlatMap bulk construction and insertion" ) {
+    FlatMap< int, int > map( { { 3, 30 }, { 1, 10 }, { 2, 20 }, { 1, 11 } } );
+    REQUIRE( map.size() == 3 );
+    REQUIRE( map.at( 1 ) == 10 ); // The first occurrence is kept
+
+    map.insert( { { 5, 50 }, { 2, 21 }, { 0, 0 }, { 5, 51 } } );
+    REQUIRE( map.size() == 5 );
+    REQUIRE( map.at( 2 ) == 20 ); // Existing elements take precedence
+    REQUIRE( map.at( 5 ) == 50 );
+    REQUIRE( std::is_sorted( map.begin(), map.end() ) );
+
+    FlatMap< int, int > sorted( atoms::sorted_unique, { { 1, 1 }, { 2, 2 } } );
+    REQUIRE( sorted.size() == 2 );
+    REQUIRE( sorted.at( 2 ) == 2 );
+}
+
+TEST_CASE( "FlatMap heterogeneous lookup" ) {
+    FlatMap< std::string, int > map{ { "alpha", 1 }, { "beta", 2 } };
+    std::string_view key = "beta";
+    REQUIRE( map.find( key ) != map.end() );
+    REQUIRE( map.at( key ) == 2 );
+    REQUIRE( map.contains( "alpha" ) );
+    REQUIRE( map.erase( std::string_view( "alpha" ) ) == 1 );
+}
+
+TEST_CASE( "FlatMap behaves like std::map" ) {
+    std::mt19937 gen( 42 );
+    std::uniform_int_distribution< int > dist( 0, 200 );
+
+    FlatMap< int, int > flat;
+    std::map< int, int > reference;
+    for ( int i = 0; i != 2000; i++ ) {
+        int key = dist( gen );
+        switch ( i % 3 ) {
+            case 0:
+                flat.insert( { key, i } );
+                reference.insert( { key, i } );
+                break;
+            case 1:
+                REQUIRE( flat.erase( key ) == reference.erase( key ) );
+                break;
+            case 2:
+                flat[ key ] += i;
+                reference[ key ] += i;
+                break;
+        }
+    }
+    REQUIRE( flat.size() == reference.size() );
+    REQUIRE( std::equal( flat.begin(), flat.end(), reference.begin(), reference.end(),
+        []( const auto& a, const auto& b ) { return a.first == b.first && a.second == b.second; } ) );
+}
@@ -0,0 +1,90 @@
+#include <catch2/catch.hpp>
+
+#include <atoms/id_map.hpp>
+#include <map>
+#include <random>
+#include <string>
+
+using atoms::IdMap;
+
+TEST_CASE( "IdMap basic operations" ) {
+    IdMap< int, std::string > map;
+    REQUIRE( map.empty() );
+    REQUIRE( !map.contains( 0 ) );
+    REQUIRE( map.find( -5 ) == nullptr );
+
+    REQUIRE( map.insert( { 1, "one" } ).second );
+    REQUIRE( !map.insert( { 1, "uno" } ).second );
+    REQUIRE( map.at( 1 ) == "one" );
+    map[ 2 ] = "two";
+    map.try_emplace( -3, "minus three" );
+    map.try_emplace( 1'000'000, "million" );
+    REQUIRE( map.size() == 4 );
+
+    SECTION( "small ids are dense, others sparse" ) {
+        REQUIRE( map.denseSize() == IdMap< int, std::string >::minDenseSize );
+        REQUIRE( map.at( -3 ) == "minus three" );
+        REQUIRE( map.at( 1'000'000 ) == "million" );
+        REQUIRE_THROWS_AS( map.at( 3 ), std::out_of_range );
+    }
+
+    SECTION( "erase" ) {
+        REQUIRE( map.erase( 2 ) == 1 );
+        REQUIRE( map.erase( 2 ) == 0 );
+        REQUIRE( map.erase( 1'000'000 ) == 1 );
+        REQUIRE( map.size() == 2 );
+        REQUIRE( !map.contains( 2 ) );
+    }
+
+    SECTION( "iteration is ordered" ) {
+        std::vector< int > keys;
+        map.forEach( [ & ]( int key, const std::string& ) { keys.push_back( key ); } );
+        REQUIRE( keys == std::vector{ -3, 1, 2, 1'000'000 } );
+    }
+}
+
+TEST_CASE( "IdMap moves sparse elements to the dense part when it grows" ) {
+    IdMap< int, int > map;
+    map[ 300 ] = 300; // Too sparse for now
+    REQUIRE( map.denseSize() == 0 );
+    for ( int i = 0; i != 100; i++ )
+        map[ i ] = i;
+    map[ 301 ] = 301;
+    REQUIRE( map.denseSize() > 301 );
+    REQUIRE( map.size() == 102 );
+    REQUIRE( map.at( 300 ) == 300 );
+    REQUIRE( map.at( 301 ) == 301 );
+}
+
+TEST_CASE( "IdMap behaves like std::map" ) {
+    std::mt19937 gen( 42 );
+    std::uniform_int_distribution< int > denseKey( 0, 500 );
+    std::uniform_int_distribution< int > sparseKey( -100'000, 100'000 );
+
+    IdMap< int, int > idMap;
+    std::map< int, int > reference;
+    for ( int i = 0; i != 5000; i++ ) {
+        int key = i % 5 == 0 ? sparseKey( gen ) : denseKey( gen );
+        switch ( i % 3 ) {
+            case 0:
+                REQUIRE( idMap.insert( { key, i } ).second == reference.insert( { key, i } ).second );
+                break;
+            case 1:
+                REQUIRE( idMap.erase( key ) == reference.erase( key ) );
+                break;
+            case 2:
+                idMap[ key ] += i;
+                reference[ key ] += i;
+                break;
+        }
+    }
+    REQUIRE( idMap.size() == reference.size() );
+    auto it = reference.begin();
+    idMap.forEach( [ & ]( int key, int value ) {
+        REQUIRE( it != reference.end() );
+        REQUIRE( key == it->first );
+        REQUIRE( value == it->second );
+        ++it;
+    } );
+    REQUIRE( it == reference.end() );
+}
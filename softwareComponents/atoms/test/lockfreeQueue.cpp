@@ -0,0 +1,178 @@
+#include <catch2/catch.hpp>
+
+#include <atoms/lockfree_queue.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using atoms::MpmcQueue;
+using atoms::SpscQueue;
+
+TEMPLATE_TEST_CASE( "Bounded queue basic operations", "[lockfree]",
+                    SpscQueue< int >, MpmcQueue< int > )
+{
+    TestType q( 6 );
+    REQUIRE( q.capacity() == 8 );
+    REQUIRE( q.empty() );
+    REQUIRE( !q.tryPop() );
+
+    for ( int i = 0; i != 8; i++ ) {
+        REQUIRE( q.tryPush( i ) );
+    }
+    REQUIRE( !q.tryPush( 42 ) );
+    REQUIRE( !q.empty() );
+
+    for ( int i = 0; i != 8; i++ ) {
+        REQUIRE( q.pop() == i );
+    }
+    REQUIRE( q.empty() );
+
+    // Wrap around several times
+    for ( int i = 0; i != 100; i++ ) {
+        q.push( i );
+        q.emplace( i + 1 );
+        REQUIRE( q.pop() == i );
+        REQUIRE( q.tryPop() == i + 1 );
+    }
+
+    q.push( 1 );
+    q.push( 2 );
+    q.clear();
+    REQUIRE( q.empty() );
+}
+
+TEMPLATE_TEST_CASE( "Bounded queue supports move-only types", "[lockfree]",
+                    SpscQueue< std::unique_ptr< int > >, MpmcQueue< std::unique_ptr< int > > )
+{
+    TestType q( 4 );
+    q.push( std::make_unique< int >( 1 ) );
+    q.emplace( std::make_unique< int >( 2 ) );
+    REQUIRE( *q.pop() == 1 );
+    REQUIRE( *q.pop() == 2 );
+}
+
+TEMPLATE_TEST_CASE( "Bounded queue pop respects stop token", "[lockfree]",
+                    SpscQueue< int >, MpmcQueue< int > )
+{
+    TestType q( 4 );
+    std::optional< int > result = 0;
+    std::jthread consumer( [ & ]( std::stop_token stoken ) { result = q.pop( stoken ); } );
+    consumer.request_stop();
+    consumer.join();
+    REQUIRE( !result );
+
+    q.push( 5 );
+    std::jthread consumer2( [ & ]( std::stop_token stoken ) { result = q.pop( stoken ); } );
+    consumer2.join();
+    REQUIRE( result == 5 );
+}
+
+TEST_CASE( "SpscQueue keeps order under concurrent access", "[lockfree]" )
+{
+    const int count = 200000;
+    SpscQueue< int > q( 16 );
+
+    std::jthread producer( [ & ] {
+        for ( int i = 0; i != count; i++ ) {
+            q.push( i );
+        }
+    } );
+
+    bool ordered = true;
+    for ( int i = 0; i != count; i++ ) {
+        ordered = ordered && q.pop() == i;
+    }
+    REQUIRE( ordered );
+    REQUIRE( q.empty() );
+}
+
+TEST_CASE( "MpmcQueue delivers every element exactly once", "[lockfree]" )
+{
+    const int producers = 4;
+    const int consumers = 3;
+    const int perProducer = 50000;
+    MpmcQueue< int > q( 64 );
+
+    std::vector< std::vector< int > > received( consumers );
+    {
+        std::vector< std::jthread > threads;
+        for ( int p = 0; p != producers; p++ ) {
+            threads.emplace_back( [ &, p ] {
+                for ( int i = 0; i != perProducer; i++ ) {
+                    q.push( p * perProducer + i );
+                }
+            } );
+        }
+        for ( int c = 0; c != consumers; c++ ) {
+            threads.emplace_back( [ &, c ]( std::stop_token stoken ) {
+                while ( auto x = q.pop( stoken ) ) {
+                    received[ c ].push_back( *x );
+                }
+            } );
+        }
+        for ( int p = 0; p != producers; p++ ) {
+            threads[ p ].join();
+        }
+        while ( !q.empty() ) {
+            std::this_thread::yield();
+        }
+        for ( auto & t : threads ) {
+            t.request_stop();
+        }
+    }
+
+    std::vector< int > all;
+    for ( const auto & r : received ) {
+        // Elements of a single producer are received in order by each consumer
+        for ( int p = 0; p != producers; p++ ) {
+            std::vector< int > fromProducer;
+            std::copy_if( r.begin(), r.end(), std::back_inserter( fromProducer ), [ & ]( int x ) {
+                return x / perProducer == p;
+            } );
+            REQUIRE( std::is_sorted( fromProducer.begin(), fromProducer.end() ) );
+        }
+        all.insert( all.end(), r.begin(), r.end() );
+    }
+    std::sort( all.begin(), all.end() );
+    REQUIRE( all.size() == producers * perProducer );
+    for ( int i = 0; i != producers * perProducer; i++ ) {
+        REQUIRE( all[ i ] == i );
+    }
+}
+
+TEMPLATE_TEST_CASE( "Bounded queue wakes a blocked consumer", "[lockfree]",
+                    SpscQueue< int >, MpmcQueue< int > )
+{
+    // A lost wakeup leaves the consumer blocked on a non-empty queue; the
+    // stop token then lets the test fail instead of hanging
+    const int rounds = 10000;
+    TestType q( 4 );
+    std::atomic< int > consumed = 0;
+    std::jthread consumer( [ & ]( std::stop_token stoken ) {
+        while ( auto x = q.pop( stoken ) ) {
+            consumed.store( *x + 1 );
+        }
+    } );
+
+    int woken = 0;
+    for ( int i = 0; i != rounds; i++ ) {
+        // Let the consumer go to sleep on the empty queue in some rounds
+        if ( i % 2 ) {
+            std::this_thread::sleep_for( std::chrono::microseconds( i % 64 ) );
+        }
+        q.push( i );
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds( 5 );
+        while ( consumed.load() != i + 1 && std::chrono::steady_clock::now() < deadline ) {
+            std::this_thread::yield();
+        }
+        if ( consumed.load() != i + 1 ) {
+            break;
+        }
+        woken++;
+    }
+    consumer.request_stop();
+    REQUIRE( woken == rounds );
+}
@@ -0,0 +1,106 @@
+// Timing of the collision check of legacy Configuration after a single action.
+//
+// Usage: bench-legacy-collision [actions] [moduleCount...]
+//
+// For each size, a snake is reconfigured by random rotations and each
+// successor is checked by all the CollisionCheck modes. Only the collision
+// check itself is measured.
+
+#include <legacy/configuration/Configuration.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+Configuration buildSnake(ID moduleCount) {
+    Configuration config;
+    for (ID id = 0; id < moduleCount; ++id)
+        config.addModule(0, 0, 0, id);
+    for (ID id = 0; id + 1 < moduleCount; ++id)
+        config.addEdge({id, B, ZMinus, 0, ZMinus, A, id + 1});
+    return config;
+}
+
+struct Timing {
+    std::string name;
+    CollisionCheck check;
+    std::chrono::duration<double, std::micro> total{};
+};
+
+void benchmark(ID moduleCount, int actions) {
+    Configuration config = buildSnake(moduleCount);
+    if (!config.isValid()) {
+        std::cerr << "Invalid snake\n";
+        std::abort();
+    }
+
+    std::vector<Timing> timings = {
+        {"allPairs", CollisionCheck::AllPairs},
+        {"grid", CollisionCheck::Grid},
+        {"incremental", CollisionCheck::Incremental}
+    };
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<ID> idDist(0, moduleCount - 1);
+    std::uniform_int_distribution<int> jointDist(Alpha, Gamma);
+    int checked = 0;
+    int colliding = 0;
+    for (int i = 0; i < actions; ++i) {
+        Configuration next = config;
+        Action rot(Action::Rotate{idDist(gen), static_cast<Joint>(jointDist(gen)), i % 2 ? 90.0 : -90.0});
+        if (!next.execute(rot) || !next.computeMatrices())
+            continue;
+
+        std::optional<bool> result;
+        Configuration checkedConfig = next;
+        for (auto& timing : timings) {
+            // Each mode gets its own copy, so it does not see a cached result
+            Configuration copy = next;
+            auto start = std::chrono::steady_clock::now();
+            bool res = copy.collisionFree(timing.check);
+            timing.total += std::chrono::steady_clock::now() - start;
+            if (result && *result != res) {
+                std::cerr << "Collision checks disagree\n";
+                std::abort();
+            }
+            result = res;
+            checkedConfig = std::move(copy);
+        }
+        checked++;
+        if (*result)
+            config = std::move(checkedConfig);
+        else
+            colliding++;
+    }
+
+    for (const auto& timing : timings) {
+        std::cout << std::left << std::setw(8) << moduleCount << std::setw(14) << timing.name
+                  << std::right << std::setw(12) << std::fixed << std::setprecision(2)
+                  << timing.total.count() / std::max(checked, 1)
+                  << std::setw(10) << checked << std::setw(10) << colliding << "\n";
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int actions = argc > 1 ? std::atoi(argv[1]) : 200;
+    std::vector<ID> sizes;
+    for (int i = 2; i < argc; ++i)
+        sizes.push_back(std::atoi(argv[i]));
+    if (sizes.empty())
+        sizes = {100, 250, 500, 1000};
+
+    std::cout << std::left << std::setw(8) << "modules" << std::setw(14) << "check"
+              << std::right << std::setw(12) << "us/check" << std::setw(10) << "checked"
+              << std::setw(10) << "colliding" << "\n";
+    for (ID moduleCount : sizes)
+        benchmark(moduleCount, actions);
+}
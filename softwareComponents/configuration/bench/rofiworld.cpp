@@ -0,0 +1,137 @@
+// Timing of the common RofiWorld operations on large worlds.
+//
+// Usage: bench-configuration [moduleCount] [repetitions]
+//
+// Each operation is measured for a world with dense module ids (0, 1, 2, ...)
+// and for a world with sparse ids, which go through the fallback id mapping.
+
+#include <configuration/binary.hpp>
+#include <configuration/builder.hpp>
+#include <configuration/serialization.hpp>
+#include <configuration/universalModule.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace rofi::configuration;
+using namespace rofi::configuration::matrices;
+
+/**
+ * \brief Build a straight snake of universal modules with given ids
+ */
+RofiWorld buildSnake( const std::vector< ModuleId >& ids ) {
+    RofiWorld world;
+    Module* previous = nullptr;
+    for ( ModuleId id : ids ) {
+        auto& m = world.insert( UniversalModule( id, 0_deg, 0_deg, 0_deg ) );
+        if ( previous ) {
+            connect( previous->connectors()[ 3 ], m.connectors()[ 0 ], roficom::Orientation::South );
+        } else {
+            connect< RigidJoint >( m.bodies()[ 0 ], { 0, 0, 0 }, identity );
+        }
+        previous = &m;
+    }
+    return world;
+}
+
+/**
+ * \brief Build the same snake as buildSnake() via RofiWorldBuilder
+ */
+RofiWorld buildSnakeInBulk( const std::vector< ModuleId >& ids ) {
+    RofiWorldBuilder builder;
+    builder.reserve( ids.size(), ids.size() );
+    for ( ModuleId id : ids ) {
+        auto m = builder.addModule( UniversalModule( id, 0_deg, 0_deg, 0_deg ) );
+        if ( m > 0 ) {
+            builder.addRoficomJoint( m - 1, 3, m, 0, roficom::Orientation::South );
+        } else {
+            builder.addSpaceJoint< RigidJoint >( m, 0, { 0, 0, 0 }, identity );
+        }
+    }
+    return builder.build();
+}
+
+/**
+ * \brief Return milliseconds of the fastest of the repeated calls of f
+ *
+ * The minimum is less affected by other load on the machine than the mean.
+ */
+template < typename F >
+double measure( int repetitions, F&& f ) {
+    double best = std::numeric_limits< double >::infinity();
+    for ( int i = 0; i != repetitions; i++ ) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        std::chrono::duration< double, std::milli > elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min( best, elapsed.count() );
+    }
+    return best;
+}
+
+void report( const std::string& ids, const std::string& operation, double ms ) {
+    std::cout << std::left << std::setw( 8 ) << ids << std::setw( 12 ) << operation
+              << std::right << std::setw( 12 ) << std::fixed << std::setprecision( 3 ) << ms << "\n";
+}
+
+void benchmark( const std::string& name, const std::vector< ModuleId >& ids, int repetitions ) {
+    report( name, "build", measure( repetitions, [ & ] { buildSnake( ids ); } ) );
+    report( name, "builder", measure( repetitions, [ & ] { buildSnakeInBulk( ids ); } ) );
+
+    RofiWorld world = buildSnake( ids );
+    // prepare() always recomputes all the positions
+    report( name, "prepare", measure( repetitions, [ & ] {
+        world.prepare().get_or_throw_as< std::logic_error >();
+    } ) );
+    report( name, "isValid", measure( repetitions, [ & ] {
+        world.isValid().get_or_throw_as< std::logic_error >();
+    } ) );
+
+    std::mt19937 gen( 42 );
+    std::vector< ModuleId > queries( 100'000 );
+    std::uniform_int_distribution< size_t > dist( 0, ids.size() - 1 );
+    for ( auto& q : queries )
+        q = ids[ dist( gen ) ];
+    report( name, "getModule", measure( repetitions, [ & ] {
+        for ( ModuleId id : queries ) {
+            if ( !world.getModule( id ) )
+                std::abort();
+        }
+    } ) );
+
+    nlohmann::json json;
+    report( name, "toJSON", measure( repetitions, [ & ] { json = serialization::toJSON( world ); } ) );
+    report( name, "fromJSON", measure( repetitions, [ & ] { serialization::fromJSON( json ); } ) );
+
+    std::vector< std::byte > data;
+    report( name, "toBinary", measure( repetitions, [ & ] { data = binary::toBinary( world ); } ) );
+    report( name, "fromBinary", measure( repetitions, [ & ] { binary::fromBinary( data ); } ) );
+    std::cout << name << " size: json " << json.dump().size() << " B, binary " << data.size() << " B\n";
+}
+
+} // namespace
+
+int main( int argc, char** argv ) {
+    int moduleCount = argc > 1 ? std::atoi( argv[ 1 ] ) : 1000;
+    int repetitions = argc > 2 ? std::atoi( argv[ 2 ] ) : 10;
+
+    std::vector< ModuleId > dense( moduleCount );
+    std::vector< ModuleId > sparse( moduleCount );
+    for ( int i = 0; i != moduleCount; i++ ) {
+        dense[ i ] = i;
+        sparse[ i ] = 1009 * i + 17;
+    }
+
+    std::cout << std::left << std::setw( 8 ) << "ids" << std::setw( 12 ) << "operation"
+              << std::right << std::setw( 12 ) << "ms" << "\n";
+    benchmark( "dense", dense, repetitions );
+    benchmark( "sparse", sparse, repetitions );
+}
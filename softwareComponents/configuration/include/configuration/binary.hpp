@@ -0,0 +1,278 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <vector>
+
+#include <configuration/rofiworld.hpp>
+
+/**
+ * \brief Compact binary format of RofiWorld
+ *
+ * A world is stored as a Header followed by sections of fixed-size records
+ * in this order:
+ *
+ * - `moduleCount` ModuleRecord
+ * - `roficomJointCount` RoficomJointRecord
+ * - `spaceJointCount` SpaceJointRecord
+ * - `jointCount` JointRecord - interned joints used by space joints and by
+ *   unknown modules
+ * - `shapeWordCount` words of interned shapes of unknown modules
+ * - `positionCount` joint positions of unknown modules
+ *
+ * Every section except the last two starts aligned to 8 bytes and the whole
+ * world is padded to a multiple of 8 bytes, so a mapped file can be read in
+ * place and worlds of a sequence can be stored one after another. Numbers are
+ * stored little-endian, angles in radians.
+ *
+ * A world of a sequence can also be stored as a delta frame - a DeltaHeader
+ * followed by `jointChangeCount` JointChangeRecord, `removedConnectionCount`
+ * and `addedConnectionCount` ConnectionRecord. The delta frame applies to the
+ * previous world of the sequence, which has to contain the same modules and
+ * the same space joints.
+ */
+namespace rofi::configuration::binary {
+
+constexpr std::array< char, 4 > magic = { 'R', 'W', 'B', 'F' };
+constexpr std::array< char, 4 > deltaMagic = { 'R', 'W', 'B', 'D' };
+constexpr std::uint32_t version = 1;
+
+struct Header {
+    std::array< char, 4 > magic;
+    std::uint32_t version;
+    std::uint64_t size; ///< size of the whole world in bytes including the header
+    std::uint32_t moduleCount;
+    std::uint32_t roficomJointCount;
+    std::uint32_t spaceJointCount;
+    std::uint32_t jointCount;
+    std::uint32_t shapeWordCount;
+    std::uint32_t positionCount;
+};
+
+/**
+ * \brief Module with its joint positions
+ *
+ * Parameters depend on the module type:
+ * - universal module: `positions` are alpha, beta and gamma
+ * - pad: `params` are width and height
+ * - cube: no parameters
+ * - unknown module: `params` are offsets of its shape and of its positions
+ *
+ * Shape of an unknown module consists of the component count, connector
+ * count, joint count, the type of each component and the source
+ * component, destination component and interned joint of each joint.
+ */
+struct ModuleRecord {
+    std::int32_t id;
+    std::uint8_t type;
+    std::array< std::uint8_t, 3 > reserved;
+    std::array< std::uint32_t, 2 > params;
+    std::array< float, 3 > positions;
+    std::uint32_t reserved2;
+};
+
+/**
+ * \brief Roficom connection, modules are indices of the module records
+ */
+struct RoficomJointRecord {
+    std::uint32_t sourceModule;
+    std::uint32_t destModule;
+    std::uint16_t sourceConnector;
+    std::uint16_t destConnector;
+    std::uint8_t orientation;
+    std::array< std::uint8_t, 3 > reserved;
+};
+
+/**
+ * \brief Space joint, the module is an index of the module records
+ * and the joint is an index of the joint records
+ */
+struct SpaceJointRecord {
+    std::uint32_t destModule;
+    std::uint32_t destComponent;
+    std::uint32_t joint;
+    float position;
+    std::array< double, 4 > refPoint;
+};
+
+/**
+ * \brief Joint without its position
+ *
+ * Rigid joint stores its sourceToDest in `pre`. Matrices are row-major.
+ */
+struct JointRecord {
+    enum Kind : std::uint32_t { Rigid, Rotation };
+
+    std::uint32_t kind;
+    std::array< float, 2 > limits;
+    std::uint32_t reserved;
+    std::array< double, 16 > pre;
+    std::array< double, 16 > post;
+    std::array< double, 4 > axis;
+};
+
+struct DeltaHeader {
+    std::array< char, 4 > magic;
+    std::uint32_t version;
+    std::uint64_t size; ///< size of the whole frame in bytes including the header
+    std::uint32_t jointChangeCount;
+    std::uint32_t removedConnectionCount;
+    std::uint32_t addedConnectionCount;
+    std::uint32_t reserved;
+};
+
+/**
+ * \brief New position of a single-parameter joint of a module
+ */
+struct JointChangeRecord {
+    std::int32_t module; ///< module id
+    std::uint32_t joint;
+    float position;
+    std::uint32_t reserved;
+};
+
+/**
+ * \brief Roficom connection between modules given by their ids
+ */
+struct ConnectionRecord {
+    std::int32_t sourceModule;
+    std::int32_t destModule;
+    std::uint16_t sourceConnector;
+    std::uint16_t destConnector;
+    std::uint8_t orientation;
+    std::array< std::uint8_t, 3 > reserved;
+};
+
+static_assert( sizeof( Header ) == 40 );
+static_assert( sizeof( ModuleRecord ) == 32 );
+static_assert( sizeof( RoficomJointRecord ) == 16 );
+static_assert( sizeof( SpaceJointRecord ) == 48 );
+static_assert( sizeof( JointRecord ) == 304 );
+static_assert( sizeof( DeltaHeader ) == 32 );
+static_assert( sizeof( JointChangeRecord ) == 16 );
+static_assert( sizeof( ConnectionRecord ) == 16 );
+
+/**
+ * \brief Serialize given RofiWorld to the binary format
+ */
+std::vector< std::byte > toBinary( const RofiWorld& world );
+
+/**
+ * \brief Write given RofiWorld in the binary format to \p out
+ */
+void writeBinary( std::ostream& out, const RofiWorld& world );
+
+/**
+ * \brief Get the size of the world or of the delta frame at the beginning of \p data
+ *
+ * \throws std::runtime_error if \p data does not start with a valid header
+ */
+std::size_t binarySize( std::span< const std::byte > data );
+
+/**
+ * \brief Load a RofiWorld from the beginning of \p data
+ *
+ * The data can be a memory-mapped file, the records are read in place.
+ *
+ * \throws std::runtime_error if the data is malformed
+ */
+RofiWorld fromBinary( std::span< const std::byte > data );
+
+/**
+ * \brief Read a single RofiWorld in the binary format from \p in
+ *
+ * \throws std::runtime_error if the data is malformed or incomplete
+ */
+RofiWorld readBinary( std::istream& in );
+
+/**
+ * \brief Read a single world or delta frame from \p in without decoding it
+ *
+ * \returns nullopt if the stream is at its end
+ * \throws std::runtime_error if the data is malformed or incomplete
+ */
+std::optional< std::vector< std::byte > > readFrame( std::istream& in );
+
+/**
+ * \brief Decide if \p data starts with a delta frame
+ */
+bool isDelta( std::span< const std::byte > data );
+
+/**
+ * \brief Decide if \p a and \p b consist of the same modules in the same
+ * order with the same reference points
+ *
+ * Such worlds differ at most in joint positions and roficom connections.
+ */
+bool sameStructure( const RofiWorld& a, const RofiWorld& b );
+
+/**
+ * \brief Decide if \p a and \p b have the same roficom connections
+ */
+bool sameConnections( const RofiWorld& a, const RofiWorld& b );
+
+/**
+ * \brief Encode \p next as a delta frame relative to \p previous
+ *
+ * \returns nullopt if the worlds differ in more than joint positions and
+ * roficom connections, or in joints with more than one parameter
+ */
+std::optional< std::vector< std::byte > > toBinaryDelta( const RofiWorld& previous,
+                                                         const RofiWorld& next );
+
+/**
+ * \brief Apply the delta frame in \p data to \p world
+ *
+ * \throws std::runtime_error if the data is malformed or does not match the world
+ */
+void applyBinaryDelta( RofiWorld& world, std::span< const std::byte > data );
+
+/**
+ * \brief Read worlds of a sequence one at a time
+ *
+ * Only the last world is kept in memory, so that the following delta frame
+ * can be applied to it.
+ */
+class SeqReader {
+public:
+    explicit SeqReader( std::istream& in ) : _in( in ) {}
+
+    /**
+     * \brief Read the next world of the sequence
+     *
+     * \returns nullopt at the end of the sequence
+     * \throws std::runtime_error if the data is malformed
+     */
+    std::optional< RofiWorld > next();
+
+private:
+    std::istream& _in;
+    std::optional< RofiWorld > _previous;
+};
+
+/**
+ * \brief Write worlds of a sequence one at a time
+ *
+ * If \p deltaFrames is set, worlds that differ from the previous one only in
+ * joint positions and roficom connections are written as delta frames.
+ */
+class SeqWriter {
+public:
+    explicit SeqWriter( std::ostream& out, bool deltaFrames = true )
+    : _out( out ), _deltaFrames( deltaFrames )
+    {}
+
+    void write( const RofiWorld& world );
+
+private:
+    std::ostream& _out;
+    bool _deltaFrames;
+    std::optional< RofiWorld > _previous;
+};
+
+} // namespace rofi::configuration::binary
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include <configuration/rofiworld.hpp>
+
+namespace rofi::configuration {
+
+/**
+ * \brief Builder of a RofiWorld from modules and joints given in bulk
+ *
+ * Modules are referred to by their index in the builder (the order of
+ * addModule() calls) and components by their index in the module, so adding a
+ * joint needs no id or component lookups. The world is assembled at once by
+ * build(); buildPrepared() additionally computes the module positions in a
+ * single traversal.
+ *
+ * Intended for loaders and generators creating many worlds; use
+ * RofiWorld::insert() and connect() to edit an existing world.
+ */
+class RofiWorldBuilder {
+public:
+    using ModuleIdx = std::size_t;
+
+    /**
+     * \brief Reserve capacity for the given number of modules and joints
+     */
+    void reserve( std::size_t moduleCount, std::size_t roficomJointCount, std::size_t spaceJointCount = 1 );
+
+    /**
+     * \brief Add a copy of module \p m
+     *
+     * \returns index of the module in the builder
+     */
+    ModuleIdx addModule( const Module& m ) {
+        return addModule( atoms::ValuePtr< Module >( m ) );
+    }
+
+    /**
+     * \brief Add module \p m
+     *
+     * \returns index of the module in the builder
+     */
+    ModuleIdx addModule( atoms::ValuePtr< Module > m );
+
+    /**
+     * \brief Get module with given index in the builder
+     */
+    const Module& module( ModuleIdx idx ) const {
+        return *_modules.at( idx );
+    }
+
+    /**
+     * \brief Connect connector \p sourceConnector of module \p sourceModule
+     * with connector \p destConnector of module \p destModule
+     *
+     * \throws std::logic_error if the module or the connector does not exist
+     */
+    void addRoficomJoint( ModuleIdx sourceModule, int sourceConnector,
+                          ModuleIdx destModule, int destConnector,
+                          roficom::Orientation o );
+
+    /**
+     * \brief Connect component \p component of module \p module to a point in
+     * space via given joint
+     *
+     * \throws std::logic_error if the module or the component does not exist
+     */
+    void addSpaceJoint( ModuleIdx module, int component, Vector refPoint, atoms::ValuePtr< Joint > joint );
+
+    /**
+     * \brief Connect component \p component of module \p module to a point in
+     * space via given joint type
+     *
+     * \tparam JointT connection joint type
+     * \param args arguments to forward to \p JointT creation
+     */
+    template < typename JointT, typename... Args >
+    void addSpaceJoint( ModuleIdx module, int component, Vector refPoint, Args&&... args ) {
+        static_assert( std::is_base_of_v< Joint, JointT > );
+        addSpaceJoint( module, component, std::move( refPoint ),
+            atoms::ValuePtr< Joint >( std::make_unique< JointT >( std::forward< Args >( args )... ) ) );
+    }
+
+    /**
+     * \brief Assemble the world without computing module positions
+     *
+     * The builder is left empty.
+     *
+     * \throws std::logic_error if two modules have the same id
+     */
+    RofiWorld build();
+
+    /**
+     * \brief Assemble the world and compute module positions
+     *
+     * The builder is left empty.
+     *
+     * \throws std::logic_error if two modules have the same id
+     * \returns the prepared world or error if the world is inconsistent
+     */
+    atoms::Result< RofiWorld > buildPrepared();
+
+    /**
+     * \brief Remove all modules and joints from the builder
+     */
+    void clear();
+
+private:
+    struct RoficomJointSpec {
+        ModuleIdx sourceModule;
+        ModuleIdx destModule;
+        int sourceConnector;
+        int destConnector;
+        roficom::Orientation orientation;
+    };
+
+    struct SpaceJointSpec {
+        ModuleIdx module;
+        int component;
+        Vector refPoint;
+        atoms::ValuePtr< Joint > joint;
+    };
+
+    std::vector< atoms::ValuePtr< Module > > _modules;
+    std::vector< RoficomJointSpec > _roficomJoints;
+    std::vector< SpaceJointSpec > _spaceJoints;
+};
+
+} // namespace rofi::configuration
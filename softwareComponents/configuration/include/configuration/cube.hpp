@@ -30,6 +30,16 @@ class Cube : public Module {
     Cube( int id ) : Module( ModuleType::Cube, _initComponents(), 6, _initJoints(), id ){}
 
     ATOMS_CLONEABLE( Cube );
+
+protected:
+    /**
+     * The cube has no movable joints, so its components are always at the
+     * same positions; they are computed only once.
+     */
+    atoms::Result< std::vector< Matrix > > _computeComponentRelativePositions() const override {
+        static const auto positions = Cube( 0 ).Module::_computeComponentRelativePositions();
+        return positions;
+    }
 };
 
 
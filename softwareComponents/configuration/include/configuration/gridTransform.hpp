@@ -0,0 +1,187 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+
+#include <configuration/Matrix.h>
+
+namespace rofi::configuration::matrices {
+
+namespace detail {
+    /**
+     * \brief Lookup tables of the 24 axis-aligned rotations
+     *
+     * A rotation is encoded by the column of the nonzero entry of each row
+     * (2 bits per row) and the signs of these entries (1 bit per row).
+     */
+    struct RotationTables {
+        std::array< std::int8_t, 512 > index; ///< rotation index for each code, -1 for no rotation
+        std::array< std::uint16_t, 24 > code; ///< code for each rotation index
+    };
+
+    constexpr RotationTables makeRotationTables() {
+        RotationTables tables = {};
+        tables.index.fill( -1 );
+        std::int8_t next = 0;
+        for ( int c0 = 0; c0 < 3; c0++ ) {
+            for ( int c1 = 0; c1 < 3; c1++ ) {
+                for ( int c2 = 0; c2 < 3; c2++ ) {
+                    if ( c0 == c1 || c0 == c2 || c1 == c2 )
+                        continue;
+                    int inversions = ( c0 > c1 ) + ( c0 > c2 ) + ( c1 > c2 );
+                    for ( int signs = 0; signs < 8; signs++ ) {
+                        int negatives = ( signs & 1 ) + ( ( signs >> 1 ) & 1 ) + ( ( signs >> 2 ) & 1 );
+                        // Skip reflections
+                        if ( ( inversions + negatives ) % 2 != 0 )
+                            continue;
+                        auto code = std::uint16_t( c0 | c1 << 2 | c2 << 4 | signs << 6 );
+                        tables.index[ code ] = next;
+                        tables.code[ static_cast< std::size_t >( next ) ] = code;
+                        next++;
+                    }
+                }
+            }
+        }
+        return tables;
+    }
+
+    inline constexpr RotationTables rotationTables = makeRotationTables();
+    static_assert( rotationTables.index[ 0 | 1 << 2 | 2 << 4 ] == 0, "Identity has index 0" );
+} // namespace detail
+
+/**
+ * \brief Rigid transformation aligned to the grid
+ *
+ * The rotation is one of the 24 axis-aligned rotations and the translation is
+ * integral. Such transformations (e.g., positions of modules and connectors
+ * with joints at right angles) are compared and hashed as integers.
+ *
+ * A matrix is converted only if all its entries are within 1 / (4 * precision)
+ * of the grid. Two converted matrices are then equal iff they are equal
+ * according to equals().
+ */
+class GridTransform {
+public:
+    /**
+     * \brief Convert the matrix to a grid transformation
+     *
+     * \returns `nullopt` if the matrix is not aligned to the grid
+     */
+    static std::optional< GridTransform > fromMatrix( const Matrix& m ) {
+        const double tolerance = 1 / ( 4 * precision );
+        auto isNear = [ & ]( double value, double target ) {
+            return std::abs( value - target ) <= tolerance;
+        };
+
+        int code = 0;
+        for ( int r = 0; r < 3; r++ ) {
+            int column = -1;
+            for ( int c = 0; c < 3; c++ ) {
+                double value = m( r, c );
+                if ( isNear( value, 0 ) )
+                    continue;
+                if ( column != -1 || !isNear( std::abs( value ), 1 ) )
+                    return std::nullopt;
+                column = c;
+                if ( value < 0 )
+                    code |= 1 << ( 6 + r );
+            }
+            if ( column == -1 )
+                return std::nullopt;
+            code |= column << ( 2 * r );
+        }
+        // Repeated columns and reflections have no index
+        auto rotation = detail::rotationTables.index[ static_cast< std::size_t >( code ) ];
+        if ( rotation < 0 )
+            return std::nullopt;
+
+        if ( !isNear( m( 3, 0 ), 0 ) || !isNear( m( 3, 1 ), 0 ) || !isNear( m( 3, 2 ), 0 ) || !isNear( m( 3, 3 ), 1 ) )
+            return std::nullopt;
+
+        GridTransform result;
+        result._rotation = rotation;
+        for ( int r = 0; r < 3; r++ ) {
+            double rounded = std::round( m( r, 3 ) );
+            if ( !isNear( m( r, 3 ), rounded )
+                || std::abs( rounded ) > std::numeric_limits< std::int32_t >::max() )
+                return std::nullopt;
+            result._translation[ static_cast< std::size_t >( r ) ] = static_cast< std::int32_t >( rounded );
+        }
+        return result;
+    }
+
+    Matrix toMatrix() const {
+        auto code = detail::rotationTables.code[ static_cast< std::size_t >( _rotation ) ];
+        Matrix m = arma::mat( 4, 4, arma::fill::zeros );
+        for ( int r = 0; r < 3; r++ ) {
+            int column = ( code >> ( 2 * r ) ) & 3;
+            m( r, column ) = ( code >> ( 6 + r ) ) & 1 ? -1 : 1;
+            m( r, 3 ) = _translation[ static_cast< std::size_t >( r ) ];
+        }
+        m( 3, 3 ) = 1;
+        return m;
+    }
+
+    /**
+     * \brief Get index of the rotation, identity has index 0
+     */
+    int rotation() const {
+        return _rotation;
+    }
+
+    const std::array< std::int32_t, 3 >& translation() const {
+        return _translation;
+    }
+
+    std::size_t hash() const {
+        auto h = std::uint64_t( std::uint8_t( _rotation ) ) * 0x27D4EB2F165667C5ull;
+        h ^= std::uint64_t( std::uint32_t( _translation[ 0 ] ) ) * 0x9E3779B97F4A7C15ull;
+        h ^= std::uint64_t( std::uint32_t( _translation[ 1 ] ) ) * 0xC2B2AE3D27D4EB4Full;
+        h ^= std::uint64_t( std::uint32_t( _translation[ 2 ] ) ) * 0x165667B19E3779F9ull;
+        return static_cast< std::size_t >( h ^ ( h >> 29 ) );
+    }
+
+    friend auto operator<=>( const GridTransform&, const GridTransform& ) = default;
+
+private:
+    GridTransform() = default;
+
+    std::int8_t _rotation = 0;
+    std::array< std::int32_t, 3 > _translation = {};
+};
+
+/**
+ * \brief Matrix together with its grid form if it has one
+ *
+ * Use it when a matrix is compared many times.
+ */
+struct QuantizedMatrix {
+    explicit QuantizedMatrix( const Matrix& m ): matrix( m ), grid( GridTransform::fromMatrix( m ) ) {}
+
+    Matrix matrix;
+    std::optional< GridTransform > grid;
+};
+
+/**
+ * \brief Same as equals() on the matrices; an integer compare if both are aligned to the grid
+ */
+inline bool equals( const QuantizedMatrix& a, const QuantizedMatrix& b ) {
+    if ( a.grid && b.grid )
+        return *a.grid == *b.grid;
+    return equals( a.matrix, b.matrix );
+}
+
+} // namespace rofi::configuration::matrices
+
+template <>
+struct std::hash< rofi::configuration::matrices::GridTransform > {
+    std::size_t operator()( const rofi::configuration::matrices::GridTransform& t ) const {
+        return t.hash();
+    }
+};
@@ -47,6 +47,22 @@ public:
     explicit Pad( ModuleId id, int size ) : Pad( id, size, size ) {};
 
     ATOMS_CLONEABLE( Pad );
+
+protected:
+    /**
+     * Connectors of the pad form a regular grid, so their positions are
+     * computed directly.
+     */
+    atoms::Result< std::vector< Matrix > > _computeComponentRelativePositions() const override {
+        std::vector< Matrix > positions;
+        positions.reserve( to_unsigned( width * height ) );
+        for ( int i = 0; i < width; i++ ) {
+            for ( int j = 0; j < height; j++ ) {
+                positions.push_back( rofi::configuration::matrices::translate( { 0, double( i ), double( j ) } ) );
+            }
+        }
+        return atoms::result_value( std::move( positions ) );
+    }
 };
 
 
@@ -10,6 +10,7 @@
 #include <ranges>
 
 #include <atoms/containers.hpp>
+#include <atoms/id_map.hpp>
 #include <atoms/result.hpp>
 #include <atoms/units.hpp>
 #include <atoms/util.hpp>
@@ -83,6 +84,7 @@ struct RoficomJoint;
 struct SpaceJoint;
 
 class RofiWorld;
+class RofiWorldBuilder;
 class Module;
 
 /**
@@ -275,38 +277,11 @@ public:
      * \returns result error if the components are inconsistent
      */
     atoms::Result< std::monostate > prepare() {
-        using namespace rofi::configuration::matrices;
-        std::vector< Matrix > relPositions( _components.size() );
-        std::vector< bool > initialized( _components.size() );
-
-        auto dfsTraverse = [&]( int compIdx, Matrix relPosition, auto& self ) -> atoms::Result< std::monostate >
-        {
-            if ( initialized[ compIdx ] ) {
-                if ( !equals( relPosition, relPositions[ compIdx ] ) ) {
-                    return atoms::result_error< std::string >( "Inconsistent component relative positions" );
-                }
-                return atoms::result_value( std::monostate() );
-            }
-            relPositions[ compIdx ] = relPosition;
-            initialized[ compIdx ] = true;
-            for ( int outJointIdx : _components[ compIdx ].outJoints ) {
-                const ComponentJoint& j = _joints[ outJointIdx ];
-                auto result = self( j.destinationComponent, relPosition * j.joint->sourceToDest(), self );
-                if ( !result ) {
-                    return result;
-                }
-            }
-            return atoms::result_value( std::monostate() );
-        };
-
-        if ( auto result = dfsTraverse( _rootComponent.value(), identity, dfsTraverse ); !result ) {
-            return result;
+        auto relPositions = _computeComponentRelativePositions();
+        if ( !relPositions ) {
+            return atoms::result_error( std::move( relPositions.assume_error() ) );
         }
-
-        if ( !std::ranges::all_of( initialized, std::identity{} ) ) {
-            return atoms::result_error< std::string >( "There are components without relative position" );
-        }
-        _componentRelativePositions = std::move( relPositions );
+        _componentRelativePositions = std::move( *relPositions );
         return atoms::result_value( std::monostate() );
     }
 
@@ -378,6 +353,50 @@ public:
     ModuleType type; ///< module type
     RofiWorld* parent; ///< pointer to parenting RofiWorld
 
+protected:
+    /**
+     * \brief Compute component relative positions by traversing the component joints
+     *
+     * Module types with a fixed structure override it with a cheaper
+     * computation, e.g., a table lookup.
+     *
+     * \returns result error if the components are inconsistent
+     */
+    virtual atoms::Result< std::vector< Matrix > > _computeComponentRelativePositions() const {
+        using namespace rofi::configuration::matrices;
+        std::vector< Matrix > relPositions( _components.size() );
+        std::vector< bool > initialized( _components.size() );
+
+        auto dfsTraverse = [&]( int compIdx, Matrix relPosition, auto& self ) -> atoms::Result< std::monostate >
+        {
+            if ( initialized[ compIdx ] ) {
+                if ( !equals( relPosition, relPositions[ compIdx ] ) ) {
+                    return atoms::result_error< std::string >( "Inconsistent component relative positions" );
+                }
+                return atoms::result_value( std::monostate() );
+            }
+            relPositions[ compIdx ] = relPosition;
+            initialized[ compIdx ] = true;
+            for ( int outJointIdx : _components[ compIdx ].outJoints ) {
+                const ComponentJoint& j = _joints[ outJointIdx ];
+                auto result = self( j.destinationComponent, relPosition * j.joint->sourceToDest(), self );
+                if ( !result ) {
+                    return result;
+                }
+            }
+            return atoms::result_value( std::monostate() );
+        };
+
+        if ( auto result = dfsTraverse( _rootComponent.value(), identity, dfsTraverse ); !result ) {
+            return atoms::result_error( std::move( result.assume_error() ) );
+        }
+
+        if ( !std::ranges::all_of( initialized, std::identity{} ) ) {
+            return atoms::result_error< std::string >( "There are components without relative position" );
+        }
+        return atoms::result_value( std::move( relPositions ) );
+    }
+
 private:
     ModuleId _id = 0; ///< integral identifier unique within a context of a single module
     std::vector< Component > _components; ///< All module components, first _connectorCount are connectors
@@ -418,6 +437,7 @@ private:
     }
 
     friend class RofiWorld;
+    friend class RofiWorldBuilder;
 };
 
 /**
@@ -555,9 +575,10 @@ public:
      *
      */
     Module* getModule( ModuleId id ) const {
-        if ( !_idMapping.contains( id ) )
+        auto* handle = _idMapping.find( id );
+        if ( !handle )
             return nullptr;
-        return _modules[ _idMapping.at( id ) ].module.get();
+        return _modules[ *handle ].module.get();
     }
 
     /**
@@ -593,9 +614,10 @@ public:
      *
      */
     void remove( ModuleId id ) {
-        if ( !_idMapping.contains( id ) )
+        auto* handlePtr = _idMapping.find( id );
+        if ( !handlePtr )
             return;
-        auto handle = _idMapping[ id ];
+        auto handle = *handlePtr;
         const ModuleInfo& info = _modules[ handle ];
         for ( auto idx : info.inJointsIdx )
             _moduleJoints.erase( idx );
@@ -682,9 +704,10 @@ public:
     Matrix getModulePosition( ModuleId id ) {
         if ( !_prepared )
             prepare().get_or_throw_as< std::logic_error >();
-        if ( !_idMapping.contains( id ) )
+        auto* handle = _idMapping.find( id );
+        if ( !handle )
             throw std::logic_error( "bad access: rofi world does not containt module with such id" );
-        return _modules[ _idMapping[ id ] ].absPosition.value();
+        return _modules[ *handle ].absPosition.value();
     }
 
     void disconnect( RoficomJointHandle h );
@@ -746,11 +769,14 @@ private:
     atoms::HandleSet< ModuleInfo > _modules;
     atoms::HandleSet< RoficomJoint > _moduleJoints;
     atoms::HandleSet< SpaceJoint > _spaceJoints;
-    std::map< ModuleId, ModuleInfoHandle > _idMapping;
+    // Module ids are mostly small dense integers, so most of the lookups are
+    // just an indexed load
+    atoms::IdMap< ModuleId, ModuleInfoHandle > _idMapping;
     bool _prepared = false;
 
     friend RoficomJointHandle connect( const Component& c1, const Component& c2, roficom::Orientation o );
     friend class Module;
+    friend class RofiWorldBuilder;
     template < typename JointT, typename... Args >
     friend SpaceJointHandle connect( const Component& c, Vector refpoint, Args&&... args );
 };
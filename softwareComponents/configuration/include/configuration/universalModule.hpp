@@ -73,6 +73,14 @@ public:
 
     static int translateComponent( std::string_view cStr );
     static std::string_view translateComponent( int c );
+
+protected:
+    /**
+     * Joint positions at multiples of the right angle (the states used by
+     * reconfiguration) are looked up in a precomputed table, other positions
+     * fall back to the traversal of the component joints.
+     */
+    atoms::Result< std::vector< Matrix > > _computeComponentRelativePositions() const override;
 };
 
 
@@ -248,6 +248,16 @@ using EdgeMap = std::unordered_map<ID, EdgeList>;
 using MatrixMap = std::unordered_map<ID, std::array<rofi::configuration::matrices::Matrix, 2>>;
 enum Value { True, False, Unknown };
 
+enum class CollisionCheck {
+    // Tests every pair of shoes
+    AllPairs,
+    // Tests every shoe against its neighbours in a uniform grid of shoe centers
+    Grid,
+    // Tests only the shoes updated by the last `computeMatrices` if the rest
+    // is known to be collision free, otherwise the same as `Grid`
+    Incremental
+};
+
 class Configuration
 {
 public:
@@ -326,8 +336,17 @@ public:
     bool connected();
     bool connected() const;
 
-    bool collisionFree();
-    bool collisionFree() const;
+    /**
+     * \brief Checks that no two shoes overlap.
+     *
+     * A single action usually moves only a part of the configuration, so by
+     * default only the shoes whose matrices were updated by the last
+     * `computeMatrices` are tested against all the others, provided the
+     * configuration was collision free before the update. The result is cached
+     * until the matrices change again.
+     */
+    bool collisionFree(CollisionCheck check = CollisionCheck::Incremental);
+    bool collisionFree(CollisionCheck check = CollisionCheck::Incremental) const;
 
     rofi::configuration::matrices::Vector massCenter() const;
 
@@ -384,6 +403,10 @@ private:
 
     Value connectedVal = Value::True;
     Value matricesVal = Value::False;
+    // Result of the collision check for the current matrices
+    Value collisionVal = Value::Unknown;
+    // Shoes that were not updated by the last `computeMatrices` don't collide
+    bool unchangedCollisionFree = false;
 
     std::unordered_map<ID, std::array<std::optional<Edge>, 6>> spanningSucc;
     std::unordered_map<ID, unsigned int> spanningSuccCount;
@@ -409,6 +432,17 @@ private:
 
     bool checkConsistency();
 
+    bool checkCollisions(CollisionCheck check) const;
+    bool allPairsCollisionFree() const;
+    /**
+     * \brief Tests shoes against the shoes in neighbouring cells of a uniform
+     * grid over shoe centers.
+     *
+     * If \p onlyUpdated is set, only pairs with at least one shoe updated by
+     * the last `computeMatrices` are tested.
+     */
+    bool gridCollisionFree(bool onlyUpdated) const;
+
     /**
      * \brief Computes differences between all joints of module with ID \p id
      * and \p otherModule
@@ -8,6 +8,36 @@
 
 std::optional<Configuration> executeIfValid(const Configuration& config, const Action &action);
 
+/**
+ * \brief Executes all \p actions on \p config and appends the valid results to \p res.
+ *
+ * The actions are independent, so they are evaluated on a pool of `generatorThreads()`
+ * threads (the calling thread included). The successors are appended in the order of
+ * \p actions regardless of the number of threads. If another thread is using the pool,
+ * the actions are evaluated in the calling thread.
+ */
+void executeAllIfValid(const Configuration& config, const std::vector<Action>& actions,
+    std::vector<Configuration>& res);
+
+/**
+ * \brief Sets the number of threads used for the successor generation by all the
+ * `*Next` functions.
+ *
+ * The default is 1, i.e., no parallelism. 0 stands for the number of hardware threads.
+ */
+void setGeneratorThreads(unsigned threads);
+
+unsigned generatorThreads();
+
+/**
+ * \brief Recreates the threads used for the successor generation in a forked child.
+ *
+ * Only the forking thread exists in the child, so the pool inherited from the
+ * parent would wait for its workers forever. Call it in the child before any
+ * successors are generated.
+ */
+void restartGeneratorThreadsAfterFork();
+
 /**
  * \brief Generates all possible actions.
  *
@@ -1,4 +1,7 @@
 #include "legacy/configuration/Configuration.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <stdexcept>
 #include <queue>
 
@@ -407,6 +410,10 @@ bool Configuration::computeMatrices() {
     if (!spanningTreeComputed && !computeSpanningTree())
         return false;
 
+    // Shoes that keep their matrices stay collision free among themselves
+    unchangedCollisionFree = collisionVal == Value::True;
+    collisionVal = Value::Unknown;
+
     bool recomputeAll = false;
     if (matricesVal == Value::False || !isMatrixComputed[fixedId][fixedSide]) {
         matrices[fixedId][fixedSide] = fixedMatrix;
@@ -547,9 +554,37 @@ void Configuration::dfsID(ID id, std::unordered_set<ID>& seen) const {
     }
 }
 
-bool Configuration::collisionFree() {
+bool Configuration::collisionFree(CollisionCheck check) {
     if (matricesVal != Value::True && !computeMatrices())
         return false;
+    if (check == CollisionCheck::Incremental && collisionVal != Value::Unknown)
+        return collisionVal == Value::True;
+    bool res = checkCollisions(check);
+    collisionVal = res ? Value::True : Value::False;
+    return res;
+}
+
+bool Configuration::collisionFree(CollisionCheck check) const {
+    if (matricesVal != Value::True)
+        return false;
+    if (check == CollisionCheck::Incremental && collisionVal != Value::Unknown)
+        return collisionVal == Value::True;
+    return checkCollisions(check);
+}
+
+bool Configuration::checkCollisions(CollisionCheck check) const {
+    switch (check) {
+        case CollisionCheck::AllPairs:
+            return allPairsCollisionFree();
+        case CollisionCheck::Grid:
+            return gridCollisionFree(false);
+        case CollisionCheck::Incremental:
+            return gridCollisionFree(unchangedCollisionFree);
+    }
+    throw std::invalid_argument("Passed unknown check to `Configuration::checkCollisions`");
+}
+
+bool Configuration::allPairsCollisionFree() const {
     for (auto it1 = matrices.begin(); it1 != matrices.end(); ++it1) {
         for (auto it2 = it1; it2 != matrices.end(); ++it2) {
             const auto& ms1 = it1->second;
@@ -569,23 +604,96 @@ bool Configuration::collisionFree() {
     return true;
 }
 
-bool Configuration::collisionFree() const {
-    if (matricesVal != Value::True)
-        return false;
-    for (auto it1 = matrices.begin(); it1 != matrices.end(); ++it1) {
-        for (auto it2 = it1; it2 != matrices.end(); ++it2) {
-            const auto& ms1 = it1->second;
-            const auto& ms2 = it2->second;
-            if (it1 == it2) {
-                if (centerSqDistance(ms1[A], ms1[B]) < 1)
+namespace {
+
+struct ShoeCenter {
+    std::array<double, 3> pos;
+    bool updated;
+};
+
+// Shoes collide if their centers are closer than 1, so a grid with unit cells
+// has all the colliding shoes of a shoe in the 27 cells around it. Cells are
+// identified by their coordinates packed into 21 bits each with z in the lowest
+// bits, so the three cells of a column along z form a continuous range of keys.
+const int cellBits = 21;
+const std::int64_t cellOffset = std::int64_t(1) << (cellBits - 1);
+
+std::uint64_t cellKey(std::int64_t x, std::int64_t y, std::int64_t z) {
+    auto coord = [](std::int64_t c) { return static_cast<std::uint64_t>(c + cellOffset); };
+    return (coord(x) << (2 * cellBits)) | (coord(y) << cellBits) | coord(z);
+}
+
+std::array<std::int64_t, 3> gridCell(const ShoeCenter& shoe) {
+    return { static_cast<std::int64_t>(std::floor(shoe.pos[0])),
+             static_cast<std::int64_t>(std::floor(shoe.pos[1])),
+             static_cast<std::int64_t>(std::floor(shoe.pos[2])) };
+}
+
+bool shoesCollide(const ShoeCenter& a, const ShoeCenter& b) {
+    double res = 0;
+    for (int i = 0; i < 3; ++i) {
+        double diff = a.pos[i] - b.pos[i];
+        res += diff * diff;
+    }
+    // Same rounding as in `centerSqDistance`
+    return std::round(res * precision) / precision < 1;
+}
+
+} // namespace
+
+bool Configuration::gridCollisionFree(bool onlyUpdated) const {
+    std::vector<ShoeCenter> shoes;
+    shoes.reserve(2 * matrices.size());
+    std::vector<std::size_t> updated;
+    for (const auto& [id, ms] : matrices) {
+        const auto& shoeUpdated = isMatrixUpdated.at(id);
+        for (int side = 0; side < 2; ++side) {
+            bool isUpdated = !onlyUpdated || shoeUpdated[side];
+            if (isUpdated)
+                updated.push_back(shoes.size());
+            shoes.push_back({{ms[side](0, 3), ms[side](1, 3), ms[side](2, 3)}, isUpdated});
+        }
+    }
+    // Pairs of updated shoes are tested only from the shoe with lower index
+    auto collides = [&](std::size_t i, std::size_t j) {
+        if (j == i || (shoes[j].updated && j < i))
+            return false;
+        return shoesCollide(shoes[i], shoes[j]);
+    };
+
+    // Few updated shoes (e.g., rotation of a leaf module) are cheaper to test
+    // directly than to build the grid
+    static const std::size_t directTestLimit = 8;
+    if (updated.size() <= directTestLimit) {
+        for (std::size_t i : updated) {
+            for (std::size_t j = 0; j < shoes.size(); ++j) {
+                if (collides(i, j))
                     return false;
-                continue;
             }
-            if (centerSqDistance(ms1[A], ms2[A]) < 1 ||
-                centerSqDistance(ms1[B], ms2[B]) < 1 ||
-                centerSqDistance(ms1[B], ms2[A]) < 1 ||
-                centerSqDistance(ms1[A], ms2[B]) < 1)
-                return false;
+        }
+        return true;
+    }
+
+    std::vector<std::pair<std::uint64_t, std::size_t>> grid;
+    grid.reserve(shoes.size());
+    for (std::size_t i = 0; i < shoes.size(); ++i) {
+        auto [x, y, z] = gridCell(shoes[i]);
+        grid.emplace_back(cellKey(x, y, z), i);
+    }
+    std::sort(grid.begin(), grid.end());
+
+    for (std::size_t i : updated) {
+        auto [x, y, z] = gridCell(shoes[i]);
+        for (std::int64_t dx = -1; dx <= 1; ++dx) {
+            for (std::int64_t dy = -1; dy <= 1; ++dy) {
+                std::uint64_t last = cellKey(x + dx, y + dy, z + 1);
+                auto it = std::lower_bound(grid.begin(), grid.end(),
+                    std::make_pair(cellKey(x + dx, y + dy, z - 1), std::size_t(0)));
+                for (; it != grid.end() && it->first <= last; ++it) {
+                    if (collides(i, it->second))
+                        return false;
+                }
+            }
         }
     }
     return true;
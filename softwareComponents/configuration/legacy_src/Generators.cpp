@@ -1,8 +1,180 @@
 #include "legacy/configuration/Generators.h"
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
 #include <queue>
+#include <thread>
 
 using namespace rofi::configuration::matrices;
 
+namespace {
+
+/**
+ * \brief Pool of threads running independent iterations of a loop.
+ *
+ * The calling thread takes part in the loop. Only one loop runs on the pool at a
+ * time; concurrent callers run their loops on their own.
+ */
+class LoopPool {
+public:
+    ~LoopPool() {
+        _stopWorkers();
+    }
+
+    unsigned threads() const {
+        return _threads;
+    }
+
+    void resize(unsigned threads) {
+        std::lock_guard use(_useMutex);
+        _stopWorkers();
+        _threads = std::max(threads, 1u);
+        for (unsigned i = 1; i < _threads; ++i)
+            _workers.emplace_back([this] { _work(); });
+    }
+
+    /**
+     * \brief Calls \p body for all indices in [0, \p count)
+     */
+    void forEach(std::size_t count, const std::function<void(std::size_t)>& body) {
+        std::unique_lock use(_useMutex, std::try_to_lock);
+        if (!use.owns_lock() || _workers.empty() || count < 2) {
+            for (std::size_t i = 0; i < count; ++i)
+                body(i);
+            return;
+        }
+
+        {
+            std::lock_guard lock(_mutex);
+            _body = &body;
+            _count = count;
+            _next = 0;
+            _exception = nullptr;
+            _pending = static_cast<unsigned>(_workers.size());
+            ++_generation;
+        }
+        _wake.notify_all();
+        _run();
+
+        std::unique_lock lock(_mutex);
+        _done.wait(lock, [this] { return _pending == 0; });
+        _body = nullptr;
+        if (_exception)
+            std::rethrow_exception(_exception);
+    }
+
+private:
+    void _work() {
+        unsigned long seen = 0;
+        while (true) {
+            {
+                std::unique_lock lock(_mutex);
+                _wake.wait(lock, [&] { return _stop || _generation != seen; });
+                if (_stop)
+                    return;
+                seen = _generation;
+            }
+            _run();
+            std::lock_guard lock(_mutex);
+            if (--_pending == 0)
+                _done.notify_one();
+        }
+    }
+
+    void _run() {
+        for (std::size_t i = _next++; i < _count; i = _next++) {
+            try {
+                (*_body)(i);
+            } catch (...) {
+                std::lock_guard lock(_mutex);
+                if (!_exception)
+                    _exception = std::current_exception();
+            }
+        }
+    }
+
+    void _stopWorkers() {
+        {
+            std::lock_guard lock(_mutex);
+            _stop = true;
+        }
+        _wake.notify_all();
+        _workers.clear();
+        _stop = false;
+    }
+
+    std::mutex _useMutex;
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::condition_variable _done;
+    std::vector<std::jthread> _workers;
+    unsigned _threads = 1;
+    bool _stop = false;
+
+    const std::function<void(std::size_t)>* _body = nullptr;
+    std::size_t _count = 0;
+    std::atomic<std::size_t> _next = 0;
+    unsigned _pending = 0;
+    unsigned long _generation = 0;
+    std::exception_ptr _exception;
+};
+
+LoopPool*& generatorPoolPtr() {
+    static LoopPool pool;
+    // Replaced in forked children, see restartGeneratorThreadsAfterFork
+    static LoopPool* current = &pool;
+    return current;
+}
+
+LoopPool& generatorPool() {
+    return *generatorPoolPtr();
+}
+
+} // namespace
+
+void setGeneratorThreads(unsigned threads) {
+    if (threads == 0)
+        threads = std::thread::hardware_concurrency();
+    generatorPool().resize(threads);
+}
+
+unsigned generatorThreads() {
+    return generatorPool().threads();
+}
+
+void restartGeneratorThreadsAfterFork() {
+    unsigned threads = generatorPool().threads();
+    // The workers of the old pool do not exist in the child and its mutexes may
+    // have been locked by them at the fork, so it is abandoned as it is
+    generatorPoolPtr() = new LoopPool();
+    generatorPool().resize(threads);
+}
+
+void executeAllIfValid(const Configuration& config, const std::vector<Action>& actions,
+    std::vector<Configuration>& res)
+{
+    if (generatorThreads() == 1) {
+        for (const auto& action : actions) {
+            auto cfgOpt = executeIfValid(config, action);
+            if (cfgOpt.has_value())
+                res.push_back(std::move(cfgOpt.value()));
+        }
+        return;
+    }
+
+    // Each slot is written by a single thread, the order is given by the actions
+    std::vector<std::optional<Configuration>> results(actions.size());
+    generatorPool().forEach(actions.size(), [&](std::size_t i) {
+        results[i] = executeIfValid(config, actions[i]);
+    });
+    for (auto& cfgOpt : results) {
+        if (cfgOpt.has_value())
+            res.push_back(std::move(cfgOpt.value()));
+    }
+}
+
 std::optional<Configuration> executeIfValid(const Configuration& config, const Action &action) {
     int steps = 10;
     Configuration next = config;
@@ -324,52 +496,32 @@ void next(const Configuration& config, std::vector<Configuration>& res, unsigned
         generateActions(config, actions, step, bound);
     }
 
-    for (auto& action : actions) {
-        auto cfgOpt = executeIfValid(config, action);
-        if (cfgOpt.has_value())
-            res.push_back(cfgOpt.value());
-    }
+    executeAllIfValid(config, actions, res);
 }
 
 void simpleNext(const Configuration& config, std::vector<Configuration>& res, unsigned step) {
     std::vector<Action> actions;
     generateSimpleActions(config, actions, step);
-    for (auto& action : actions) {
-        auto cfgOpt = executeIfValid(config, action);
-        if (cfgOpt.has_value())
-            res.push_back(cfgOpt.value());
-    }
+    executeAllIfValid(config, actions, res);
 }
 
 void simpleOnlyRotNext(const Configuration& config, std::vector<Configuration>& res, unsigned step) {
     std::vector<Action> actions;
     generateSimpleOnlyRotActions(config, actions, step);
-    for (auto& action : actions) {
-        auto cfgOpt = executeIfValid(config, action);
-        if (cfgOpt.has_value())
-            res.push_back(cfgOpt.value());
-    }
+    executeAllIfValid(config, actions, res);
 }
 
 
 void bisimpleNext(const Configuration& config, std::vector<Configuration>& res, unsigned step) {
     std::vector<Action> actions;
     generateBisimpleActions(config, actions, step);
-    for (const auto& action : actions) {
-        auto cfgOpt = executeIfValid(config, action);
-        if (cfgOpt.has_value())
-            res.push_back(cfgOpt.value());
-    }
+    executeAllIfValid(config, actions, res);
 }
 
 void bisimpleOnlyRotNext(const Configuration& config, std::vector<Configuration>& res, unsigned step) {
     std::vector<Action> actions;
     generateBisimpleOnlyRotActions(config, actions, step);
-    for (const auto& action : actions) {
-        auto cfgOpt = executeIfValid(config, action);
-        if (cfgOpt.has_value())
-            res.push_back(cfgOpt.value());
-    }
+    executeAllIfValid(config, actions, res);
 }
 
 
@@ -378,11 +530,7 @@ void paralyzedNext(const Configuration& config, std::vector<Configuration>& res,
 {
     std::vector<Action> actions;
     generateParalyzedActions(config, actions, step, allowed_indices);
-    for (auto& action : actions) {
-        auto cfgOpt = executeIfValid(config, action);
-        if (cfgOpt.has_value())
-            res.push_back(cfgOpt.value());
-    }
+    executeAllIfValid(config, actions, res);
 }
 
 void biParalyzedOnlyRotNext(const Configuration& config, std::vector<Configuration>& res, unsigned step,
@@ -390,11 +538,7 @@ void biParalyzedOnlyRotNext(const Configuration& config, std::vector<Configurati
 {
     std::vector<Action> actions;
     generateBiParalyzedOnlyRotActions(config, actions, step, allowed_indices);
-    for (auto& action : actions) {
-        auto cfgOpt = executeIfValid(config, action);
-        if (cfgOpt.has_value())
-            res.push_back(cfgOpt.value());
-    }
+    executeAllIfValid(config, actions, res);
 }
 
 void smartBisimpleOnlyRotNext(const Configuration& config, std::vector<Configuration>& res, unsigned step)
@@ -403,11 +547,7 @@ void smartBisimpleOnlyRotNext(const Configuration& config, std::vector<Configura
     auto ids = config.getIDs();
     std::unordered_set<ID> allowed_indices(ids.begin(), ids.end());
     generateSmartParalyzedOnlyRotActions(config, actions, step, allowed_indices);
-    for (auto& action : actions) {
-        auto cfgOpt = executeIfValid(config, action);
-        if (cfgOpt.has_value())
-            res.push_back(cfgOpt.value());
-    }
+    executeAllIfValid(config, actions, res);
 }
 
 void smartBisimpleParOnlyRotNext(const Configuration& config, std::vector<Configuration>& res, unsigned step,
@@ -415,9 +555,5 @@ void smartBisimpleParOnlyRotNext(const Configuration& config, std::vector<Config
 {
     std::vector<Action> actions;
     generateSmartParalyzedOnlyRotActions(config, actions, step, allowed_indices);
-    for (auto& action : actions) {
-        auto cfgOpt = executeIfValid(config, action);
-        if (cfgOpt.has_value())
-            res.push_back(cfgOpt.value());
-    }
+    executeAllIfValid(config, actions, res);
 }
\ No newline at end of file
@@ -0,0 +1,677 @@
+#include <configuration/binary.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <iterator>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+
+#include <configuration/builder.hpp>
+#include <configuration/cube.hpp>
+#include <configuration/pad.hpp>
+#include <configuration/universalModule.hpp>
+#include <configuration/unknownModule.hpp>
+
+namespace rofi::configuration::binary {
+
+static_assert( std::endian::native == std::endian::little,
+               "The binary format is implemented only for little-endian platforms" );
+
+namespace {
+
+/**
+ * \brief Byte offsets of the sections of a world
+ */
+struct Layout {
+    explicit Layout( const Header& h ) {
+        modules = sizeof( Header );
+        roficomJoints = modules + std::size_t( h.moduleCount ) * sizeof( ModuleRecord );
+        spaceJoints = roficomJoints + std::size_t( h.roficomJointCount ) * sizeof( RoficomJointRecord );
+        joints = spaceJoints + std::size_t( h.spaceJointCount ) * sizeof( SpaceJointRecord );
+        shapeWords = joints + std::size_t( h.jointCount ) * sizeof( JointRecord );
+        positions = shapeWords + std::size_t( h.shapeWordCount ) * sizeof( std::uint32_t );
+        std::size_t end = positions + std::size_t( h.positionCount ) * sizeof( float );
+        size = ( end + 7 ) / 8 * 8;
+    }
+
+    std::size_t modules, roficomJoints, spaceJoints, joints, shapeWords, positions, size;
+};
+
+std::size_t deltaSize( const DeltaHeader& h ) {
+    return sizeof( DeltaHeader ) + std::size_t( h.jointChangeCount ) * sizeof( JointChangeRecord )
+        + ( std::size_t( h.removedConnectionCount ) + h.addedConnectionCount ) * sizeof( ConnectionRecord );
+}
+
+template< typename T >
+T load( std::span< const std::byte > data, std::size_t offset ) {
+    T value;
+    std::memcpy( &value, data.data() + offset, sizeof( T ) );
+    return value;
+}
+
+template< typename T >
+void store( std::vector< std::byte >& data, std::size_t offset, const std::vector< T >& values ) {
+    if ( !values.empty() )
+        std::memcpy( data.data() + offset, values.data(), values.size() * sizeof( T ) );
+}
+
+std::array< double, 16 > matrixToArray( const Matrix& m ) {
+    std::array< double, 16 > result;
+    for ( int i = 0; i < 4; i++ )
+        for ( int j = 0; j < 4; j++ )
+            result[ i * 4 + j ] = m( i, j );
+    return result;
+}
+
+Matrix arrayToMatrix( const std::array< double, 16 >& a ) {
+    Matrix m;
+    for ( int i = 0; i < 4; i++ )
+        for ( int j = 0; j < 4; j++ )
+            m( i, j ) = a[ i * 4 + j ];
+    return m;
+}
+
+JointRecord jointToRecord( const Joint& joint ) {
+    JointRecord r = {};
+    if ( auto rigid = dynamic_cast< const RigidJoint* >( &joint ) ) {
+        r.kind = JointRecord::Rigid;
+        r.pre = matrixToArray( rigid->sourceToDest() );
+    } else if ( auto rotation = dynamic_cast< const RotationJoint* >( &joint ) ) {
+        r.kind = JointRecord::Rotation;
+        r.limits = { rotation->jointLimits()[ 0 ].first, rotation->jointLimits()[ 0 ].second };
+        r.pre = matrixToArray( rotation->pre() );
+        r.post = matrixToArray( rotation->post() );
+        Vector axis = rotation->axis();
+        r.axis = { axis[ 0 ], axis[ 1 ], axis[ 2 ], axis[ 3 ] };
+    } else {
+        throw std::logic_error( "Binary format supports only rigid and rotation joints" );
+    }
+    return r;
+}
+
+class Writer {
+public:
+    explicit Writer( const RofiWorld& world ) {
+        std::unordered_map< ModuleId, std::uint32_t > indices;
+        for ( const auto& info : world.modules() ) {
+            indices[ info.module->getId() ] = std::uint32_t( _modules.size() );
+            _modules.push_back( _moduleRecord( *info.module ) );
+        }
+
+        for ( const RoficomJoint& rj : world.roficomConnections() ) {
+            RoficomJointRecord r = {};
+            r.sourceModule = indices.at( world.getModule( rj.sourceModule )->getId() );
+            r.destModule = indices.at( world.getModule( rj.destModule )->getId() );
+            r.sourceConnector = std::uint16_t( rj.sourceConnector );
+            r.destConnector = std::uint16_t( rj.destConnector );
+            r.orientation = std::uint8_t( rj.orientation );
+            _roficomJoints.push_back( r );
+        }
+
+        for ( const SpaceJoint& sj : world.referencePoints() ) {
+            assert( sj.joint.get() && "joint is nullptr" );
+            SpaceJointRecord r = {};
+            r.destModule = indices.at( world.getModule( sj.destModule )->getId() );
+            r.destComponent = std::uint32_t( sj.destComponent );
+            r.joint = _intern( *sj.joint );
+            r.position = sj.joint->positions().empty() ? 0 : sj.joint->positions()[ 0 ];
+            r.refPoint = { sj.refPoint[ 0 ], sj.refPoint[ 1 ], sj.refPoint[ 2 ], sj.refPoint[ 3 ] };
+            _spaceJoints.push_back( r );
+        }
+    }
+
+    std::vector< std::byte > bytes() const {
+        Header h = {};
+        h.magic = magic;
+        h.version = version;
+        h.moduleCount = std::uint32_t( _modules.size() );
+        h.roficomJointCount = std::uint32_t( _roficomJoints.size() );
+        h.spaceJointCount = std::uint32_t( _spaceJoints.size() );
+        h.jointCount = std::uint32_t( _joints.size() );
+        h.shapeWordCount = std::uint32_t( _shapeWords.size() );
+        h.positionCount = std::uint32_t( _positions.size() );
+        Layout layout( h );
+        h.size = layout.size;
+
+        std::vector< std::byte > data( layout.size );
+        std::memcpy( data.data(), &h, sizeof( h ) );
+        store( data, layout.modules, _modules );
+        store( data, layout.roficomJoints, _roficomJoints );
+        store( data, layout.spaceJoints, _spaceJoints );
+        store( data, layout.joints, _joints );
+        store( data, layout.shapeWords, _shapeWords );
+        store( data, layout.positions, _positions );
+        return data;
+    }
+
+private:
+    ModuleRecord _moduleRecord( const Module& m ) {
+        ModuleRecord r = {};
+        r.id = m.getId();
+        r.type = std::uint8_t( m.type );
+        switch ( m.type ) {
+            case ModuleType::Universal:
+                for ( int i = 0; i < 3; i++ )
+                    r.positions[ i ] = m.joints()[ i ].joint->positions()[ 0 ];
+                break;
+            case ModuleType::Pad: {
+                const auto& pad = dynamic_cast< const Pad& >( m );
+                r.params = { std::uint32_t( pad.width ), std::uint32_t( pad.height ) };
+                break;
+            }
+            case ModuleType::Cube:
+                break;
+            case ModuleType::Unknown:
+                r.params = { _internShape( m ), std::uint32_t( _positions.size() ) };
+                for ( const auto& jt : m.joints() ) {
+                    auto positions = jt.joint->positions();
+                    _positions.insert( _positions.end(), positions.begin(), positions.end() );
+                }
+                break;
+        }
+        return r;
+    }
+
+    std::uint32_t _intern( const Joint& joint ) {
+        JointRecord r = jointToRecord( joint );
+        auto key = std::string( reinterpret_cast< const char* >( &r ), sizeof( r ) );
+        auto [ it, inserted ] = _jointIds.try_emplace( std::move( key ), std::uint32_t( _joints.size() ) );
+        if ( inserted )
+            _joints.push_back( r );
+        return it->second;
+    }
+
+    std::uint32_t _internShape( const Module& m ) {
+        std::vector< std::uint32_t > words = {
+            std::uint32_t( m.components().size() ),
+            std::uint32_t( m.connectors().size() ),
+            std::uint32_t( m.joints().size() ) };
+        for ( const auto& c : m.components() )
+            words.push_back( std::uint32_t( c.type ) );
+        for ( const auto& jt : m.joints() ) {
+            words.push_back( std::uint32_t( jt.sourceComponent ) );
+            words.push_back( std::uint32_t( jt.destinationComponent ) );
+            words.push_back( _intern( *jt.joint ) );
+        }
+
+        auto [ it, inserted ] = _shapeIds.try_emplace( words, std::uint32_t( _shapeWords.size() ) );
+        if ( inserted )
+            _shapeWords.insert( _shapeWords.end(), words.begin(), words.end() );
+        return it->second;
+    }
+
+    std::vector< ModuleRecord > _modules;
+    std::vector< RoficomJointRecord > _roficomJoints;
+    std::vector< SpaceJointRecord > _spaceJoints;
+    std::vector< JointRecord > _joints;
+    std::vector< std::uint32_t > _shapeWords;
+    std::vector< float > _positions;
+
+    std::map< std::string, std::uint32_t > _jointIds;
+    std::map< std::vector< std::uint32_t >, std::uint32_t > _shapeIds;
+};
+
+class Reader {
+public:
+    explicit Reader( std::span< const std::byte > data )
+    : _data( data ), _header( load< Header >( data, 0 ) ), _layout( _header )
+    {}
+
+    RofiWorld world() const {
+        RofiWorldBuilder builder;
+        builder.reserve( _header.moduleCount, _header.roficomJointCount, _header.spaceJointCount );
+        for ( std::uint32_t i = 0; i < _header.moduleCount; i++ ) {
+            auto r = _record< ModuleRecord >( _layout.modules, i );
+            builder.addModule( _module( r ) );
+        }
+
+        for ( std::uint32_t i = 0; i < _header.roficomJointCount; i++ ) {
+            auto r = _record< RoficomJointRecord >( _layout.roficomJoints, i );
+            if ( r.sourceModule >= _header.moduleCount || r.destModule >= _header.moduleCount )
+                throw std::runtime_error( "Roficom joint refers to a nonexistent module" );
+            if ( r.sourceConnector >= builder.module( r.sourceModule ).connectors().size()
+                || r.destConnector >= builder.module( r.destModule ).connectors().size() )
+            {
+                throw std::runtime_error( "Roficom joint refers to a nonexistent connector" );
+            }
+            if ( r.orientation > std::uint8_t( roficom::Orientation::West ) )
+                throw std::runtime_error( "Invalid roficom orientation" );
+            builder.addRoficomJoint( r.sourceModule, r.sourceConnector, r.destModule, r.destConnector,
+                                     roficom::Orientation( r.orientation ) );
+        }
+
+        for ( std::uint32_t i = 0; i < _header.spaceJointCount; i++ ) {
+            auto r = _record< SpaceJointRecord >( _layout.spaceJoints, i );
+            if ( r.destModule >= _header.moduleCount )
+                throw std::runtime_error( "Space joint refers to a nonexistent module" );
+            if ( r.destComponent >= builder.module( r.destModule ).components().size() )
+                throw std::runtime_error( "Space joint refers to a nonexistent component" );
+            JointRecord jr = _joint( r.joint );
+            Vector refPoint = { r.refPoint[ 0 ], r.refPoint[ 1 ], r.refPoint[ 2 ], r.refPoint[ 3 ] };
+            if ( jr.kind == JointRecord::Rigid ) {
+                builder.addSpaceJoint< RigidJoint >( r.destModule, int( r.destComponent ), refPoint,
+                                                     arrayToMatrix( jr.pre ) );
+            } else {
+                auto joint = std::make_unique< RotationJoint >( arrayToMatrix( jr.pre ),
+                        Vector{ jr.axis[ 0 ], jr.axis[ 1 ], jr.axis[ 2 ], jr.axis[ 3 ] },
+                        arrayToMatrix( jr.post ),
+                        Angle::rad( jr.limits[ 0 ] ), Angle::rad( jr.limits[ 1 ] ) );
+                joint->setPositions( std::array{ r.position } );
+                builder.addSpaceJoint( r.destModule, int( r.destComponent ), refPoint,
+                                       atoms::ValuePtr< Joint >( std::move( joint ) ) );
+            }
+        }
+
+        return builder.build();
+    }
+
+private:
+    template< typename T >
+    T _record( std::size_t section, std::size_t idx ) const {
+        return load< T >( _data, section + idx * sizeof( T ) );
+    }
+
+    JointRecord _joint( std::uint32_t idx ) const {
+        if ( idx >= _header.jointCount )
+            throw std::runtime_error( "Reference to a nonexistent joint" );
+        auto r = _record< JointRecord >( _layout.joints, idx );
+        if ( r.kind != JointRecord::Rigid && r.kind != JointRecord::Rotation )
+            throw std::runtime_error( "Unknown joint kind" );
+        return r;
+    }
+
+    std::uint32_t _shapeWord( std::size_t idx ) const {
+        if ( idx >= _header.shapeWordCount )
+            throw std::runtime_error( "Module shape is out of bounds" );
+        return _record< std::uint32_t >( _layout.shapeWords, idx );
+    }
+
+    atoms::ValuePtr< Module > _module( const ModuleRecord& r ) const {
+        switch ( ModuleType( r.type ) ) {
+            case ModuleType::Universal:
+                return _valuePtr< UniversalModule >( r.id, Angle::rad( r.positions[ 0 ] ),
+                                                     Angle::rad( r.positions[ 1 ] ),
+                                                     Angle::rad( r.positions[ 2 ] ) );
+            case ModuleType::Pad:
+                if ( r.params[ 0 ] == 0 || r.params[ 1 ] == 0 )
+                    throw std::runtime_error( "Pad has to have positive dimensions" );
+                return _valuePtr< Pad >( r.id, int( r.params[ 0 ] ), int( r.params[ 1 ] ) );
+            case ModuleType::Cube:
+                return _valuePtr< Cube >( r.id );
+            case ModuleType::Unknown:
+                return _valuePtr< UnknownModule >( _unknownModule( r ) );
+        }
+        throw std::runtime_error( "Unknown type of a module" );
+    }
+
+    template< typename ModuleT, typename... Args >
+    static atoms::ValuePtr< Module > _valuePtr( Args&&... args ) {
+        return atoms::ValuePtr< Module >( std::make_unique< ModuleT >( std::forward< Args >( args )... ) );
+    }
+
+    UnknownModule _unknownModule( const ModuleRecord& r ) const {
+        std::size_t word = r.params[ 0 ];
+        std::uint32_t componentCount = _shapeWord( word++ );
+        std::uint32_t connectorCount = _shapeWord( word++ );
+        std::uint32_t jointCount = _shapeWord( word++ );
+        if ( componentCount == 0 || connectorCount > componentCount )
+            throw std::runtime_error( "Invalid shape of an unknown module" );
+
+        std::vector< Component > components;
+        for ( std::uint32_t i = 0; i < componentCount; i++ ) {
+            std::uint32_t type = _shapeWord( word++ );
+            if ( type > std::uint32_t( ComponentType::CubeBody ) )
+                throw std::runtime_error( "Unknown component type" );
+            components.push_back( Component( ComponentType( type ), {}, {}, nullptr ) );
+        }
+
+        std::vector< ComponentJoint > joints;
+        for ( std::uint32_t i = 0; i < jointCount; i++ ) {
+            std::uint32_t source = _shapeWord( word++ );
+            std::uint32_t dest = _shapeWord( word++ );
+            if ( source >= componentCount || dest >= componentCount )
+                throw std::runtime_error( "Joint refers to a nonexistent component" );
+            JointRecord jr = _joint( _shapeWord( word++ ) );
+            if ( jr.kind == JointRecord::Rigid ) {
+                joints.push_back( makeComponentJoint< RigidJoint >( int( source ), int( dest ),
+                                                                    arrayToMatrix( jr.pre ) ) );
+            } else {
+                joints.push_back( makeComponentJoint< RotationJoint >( int( source ), int( dest ),
+                        arrayToMatrix( jr.pre ),
+                        Vector{ jr.axis[ 0 ], jr.axis[ 1 ], jr.axis[ 2 ], jr.axis[ 3 ] },
+                        arrayToMatrix( jr.post ),
+                        Angle::rad( jr.limits[ 0 ] ), Angle::rad( jr.limits[ 1 ] ) ) );
+            }
+        }
+
+        UnknownModule m( std::move( components ), int( connectorCount ), std::move( joints ), r.id );
+        std::size_t position = r.params[ 1 ];
+        for ( std::size_t i = 0; i < m.joints().size(); i++ ) {
+            std::size_t count = m.joints()[ i ].joint->positions().size();
+            if ( count == 0 )
+                continue;
+            if ( position + count > _header.positionCount )
+                throw std::runtime_error( "Joint positions are out of bounds" );
+            std::vector< float > positions( count );
+            std::memcpy( positions.data(), _data.data() + _layout.positions + position * sizeof( float ),
+                         count * sizeof( float ) );
+            m.setJointPositions( int( i ), positions );
+            position += count;
+        }
+        return m;
+    }
+
+    std::span< const std::byte > _data;
+    Header _header;
+    Layout _layout;
+};
+
+bool sameJoint( const Joint& a, const Joint& b ) {
+    JointRecord ra = jointToRecord( a );
+    JointRecord rb = jointToRecord( b );
+    return std::memcmp( &ra, &rb, sizeof( JointRecord ) ) == 0;
+}
+
+/**
+ * \brief Decide if the modules differ at most in their joint positions
+ */
+bool sameShape( const Module& a, const Module& b ) {
+    if ( a.getId() != b.getId() || a.type != b.type
+        || a.components().size() != b.components().size()
+        || a.connectors().size() != b.connectors().size()
+        || a.joints().size() != b.joints().size() )
+        return false;
+    if ( a.type == ModuleType::Pad ) {
+        const auto& padA = dynamic_cast< const Pad& >( a );
+        const auto& padB = dynamic_cast< const Pad& >( b );
+        return padA.width == padB.width && padA.height == padB.height;
+    }
+    if ( a.type != ModuleType::Unknown )
+        return true;
+    for ( std::size_t i = 0; i < a.components().size(); i++ ) {
+        if ( a.components()[ i ].type != b.components()[ i ].type )
+            return false;
+    }
+    for ( std::size_t i = 0; i < a.joints().size(); i++ ) {
+        const auto& ja = a.joints()[ i ];
+        const auto& jb = b.joints()[ i ];
+        if ( ja.sourceComponent != jb.sourceComponent || ja.destinationComponent != jb.destinationComponent
+            || !sameJoint( *ja.joint, *jb.joint ) )
+            return false;
+    }
+    return true;
+}
+
+bool sameSpaceJoint( const RofiWorld& worldA, const SpaceJoint& a, const RofiWorld& worldB, const SpaceJoint& b ) {
+    auto positionsA = a.joint->positions();
+    auto positionsB = b.joint->positions();
+    return worldA.getModule( a.destModule )->getId() == worldB.getModule( b.destModule )->getId()
+        && a.destComponent == b.destComponent
+        && std::equal( a.refPoint.begin(), a.refPoint.end(), b.refPoint.begin() )
+        && sameJoint( *a.joint, *b.joint )
+        && std::equal( positionsA.begin(), positionsA.end(), positionsB.begin(), positionsB.end() );
+}
+
+using ConnectionKey = std::tuple< ModuleId, int, ModuleId, int, int >;
+
+std::multiset< ConnectionKey > connectionKeys( const RofiWorld& world ) {
+    std::multiset< ConnectionKey > result;
+    for ( const RoficomJoint& rj : world.roficomConnections() ) {
+        result.emplace( world.getModule( rj.sourceModule )->getId(), rj.sourceConnector,
+                        world.getModule( rj.destModule )->getId(), rj.destConnector,
+                        int( rj.orientation ) );
+    }
+    return result;
+}
+
+ConnectionRecord connectionRecord( const ConnectionKey& key ) {
+    ConnectionRecord r = {};
+    r.sourceModule = std::get< 0 >( key );
+    r.sourceConnector = std::uint16_t( std::get< 1 >( key ) );
+    r.destModule = std::get< 2 >( key );
+    r.destConnector = std::uint16_t( std::get< 3 >( key ) );
+    r.orientation = std::uint8_t( std::get< 4 >( key ) );
+    return r;
+}
+
+} // namespace
+
+std::vector< std::byte > toBinary( const RofiWorld& world ) {
+    return Writer( world ).bytes();
+}
+
+void writeBinary( std::ostream& out, const RofiWorld& world ) {
+    auto data = toBinary( world );
+    out.write( reinterpret_cast< const char* >( data.data() ), std::streamsize( data.size() ) );
+}
+
+std::size_t binarySize( std::span< const std::byte > data ) {
+    if ( isDelta( data ) ) {
+        if ( data.size() < sizeof( DeltaHeader ) )
+            throw std::runtime_error( "Delta frame is too short" );
+        auto h = load< DeltaHeader >( data, 0 );
+        if ( h.version != version )
+            throw std::runtime_error( "Unsupported version of delta frame: " + std::to_string( h.version ) );
+        if ( h.size != deltaSize( h ) )
+            throw std::runtime_error( "Size of delta frame does not match its content" );
+        return h.size;
+    }
+    if ( data.size() < sizeof( Header ) )
+        throw std::runtime_error( "Binary world is too short" );
+    auto h = load< Header >( data, 0 );
+    if ( h.magic != magic )
+        throw std::runtime_error( "Data is not a binary rofi world" );
+    if ( h.version != version )
+        throw std::runtime_error( "Unsupported version of binary rofi world: " + std::to_string( h.version ) );
+    if ( h.size != Layout( h ).size )
+        throw std::runtime_error( "Size of binary rofi world does not match its content" );
+    return h.size;
+}
+
+RofiWorld fromBinary( std::span< const std::byte > data ) {
+    if ( isDelta( data ) )
+        throw std::runtime_error( "Delta frame cannot be loaded without the previous world" );
+    if ( binarySize( data ) > data.size() )
+        throw std::runtime_error( "Binary world is truncated" );
+    return Reader( data ).world();
+}
+
+RofiWorld readBinary( std::istream& in ) {
+    auto data = readFrame( in );
+    if ( !data )
+        throw std::runtime_error( "Binary world is too short" );
+    return fromBinary( *data );
+}
+
+std::optional< std::vector< std::byte > > readFrame( std::istream& in ) {
+    if ( in.peek() == std::istream::traits_type::eof() )
+        return std::nullopt;
+
+    // Read the shorter delta header first, then the rest of the full header if needed
+    std::vector< std::byte > data( sizeof( DeltaHeader ) );
+    auto readTo = [ & ]( std::size_t from ) {
+        auto count = std::streamsize( data.size() - from );
+        if ( !in.read( reinterpret_cast< char* >( data.data() + from ), count ) )
+            throw std::runtime_error( "Binary world is truncated" );
+    };
+    readTo( 0 );
+    if ( !isDelta( data ) ) {
+        data.resize( sizeof( Header ) );
+        readTo( sizeof( DeltaHeader ) );
+    }
+    // The size is checked against the counts only, which a corrupt header can
+    // set arbitrarily high; grow the buffer with the data actually read so
+    // that it never gets much larger than the stream
+    constexpr std::size_t chunkSize = std::size_t( 1 ) << 20;
+    std::size_t size = binarySize( data );
+    while ( data.size() < size ) {
+        std::size_t from = data.size();
+        data.resize( std::min( size, from + chunkSize ) );
+        readTo( from );
+    }
+    return data;
+}
+
+bool isDelta( std::span< const std::byte > data ) {
+    return data.size() >= deltaMagic.size() && load< std::array< char, 4 > >( data, 0 ) == deltaMagic;
+}
+
+bool sameStructure( const RofiWorld& a, const RofiWorld& b ) {
+    if ( a.modules().size() != b.modules().size()
+        || a.referencePoints().size() != b.referencePoints().size() )
+        return false;
+
+    auto moduleA = a.modules().begin();
+    for ( const auto& info : b.modules() ) {
+        if ( !sameShape( *( moduleA++ )->module, *info.module ) )
+            return false;
+    }
+    auto spaceJointA = a.referencePoints().begin();
+    for ( const SpaceJoint& sj : b.referencePoints() ) {
+        if ( !sameSpaceJoint( a, *( spaceJointA++ ), b, sj ) )
+            return false;
+    }
+    return true;
+}
+
+bool sameConnections( const RofiWorld& a, const RofiWorld& b ) {
+    return a.roficomConnections().size() == b.roficomConnections().size()
+        && connectionKeys( a ) == connectionKeys( b );
+}
+
+std::optional< std::vector< std::byte > > toBinaryDelta( const RofiWorld& previous,
+                                                         const RofiWorld& next )
+{
+    if ( !sameStructure( previous, next ) )
+        return std::nullopt;
+
+    std::vector< JointChangeRecord > jointChanges;
+    auto prevModule = previous.modules().begin();
+    for ( const auto& info : next.modules() ) {
+        const Module& a = *( prevModule++ )->module;
+        const Module& b = *info.module;
+        for ( std::size_t i = 0; i < b.joints().size(); i++ ) {
+            auto positionsA = a.joints()[ i ].joint->positions();
+            auto positionsB = b.joints()[ i ].joint->positions();
+            if ( std::equal( positionsA.begin(), positionsA.end(), positionsB.begin(), positionsB.end() ) )
+                continue;
+            if ( positionsB.size() != 1 )
+                return std::nullopt;
+            JointChangeRecord r = {};
+            r.module = b.getId();
+            r.joint = std::uint32_t( i );
+            r.position = positionsB[ 0 ];
+            jointChanges.push_back( r );
+        }
+    }
+
+    auto prevConnections = connectionKeys( previous );
+    auto nextConnections = connectionKeys( next );
+    std::vector< ConnectionKey > removed, added;
+    std::set_difference( prevConnections.begin(), prevConnections.end(),
+                         nextConnections.begin(), nextConnections.end(), std::back_inserter( removed ) );
+    std::set_difference( nextConnections.begin(), nextConnections.end(),
+                         prevConnections.begin(), prevConnections.end(), std::back_inserter( added ) );
+
+    DeltaHeader h = {};
+    h.magic = deltaMagic;
+    h.version = version;
+    h.jointChangeCount = std::uint32_t( jointChanges.size() );
+    h.removedConnectionCount = std::uint32_t( removed.size() );
+    h.addedConnectionCount = std::uint32_t( added.size() );
+    h.size = deltaSize( h );
+
+    std::vector< ConnectionRecord > connections;
+    for ( const auto& key : removed )
+        connections.push_back( connectionRecord( key ) );
+    for ( const auto& key : added )
+        connections.push_back( connectionRecord( key ) );
+
+    std::vector< std::byte > data( h.size );
+    std::memcpy( data.data(), &h, sizeof( h ) );
+    store( data, sizeof( h ), jointChanges );
+    store( data, sizeof( h ) + jointChanges.size() * sizeof( JointChangeRecord ), connections );
+    return data;
+}
+
+void applyBinaryDelta( RofiWorld& world, std::span< const std::byte > data ) {
+    if ( !isDelta( data ) )
+        throw std::runtime_error( "Data is not a delta frame" );
+    if ( binarySize( data ) > data.size() )
+        throw std::runtime_error( "Delta frame is truncated" );
+    auto h = load< DeltaHeader >( data, 0 );
+
+    auto module = [ & ]( ModuleId id ) -> Module& {
+        Module* m = world.getModule( id );
+        if ( !m )
+            throw std::runtime_error( "Delta frame refers to a nonexistent module " + std::to_string( id ) );
+        return *m;
+    };
+
+    std::size_t offset = sizeof( DeltaHeader );
+    for ( std::uint32_t i = 0; i < h.jointChangeCount; i++, offset += sizeof( JointChangeRecord ) ) {
+        auto r = load< JointChangeRecord >( data, offset );
+        Module& m = module( r.module );
+        if ( r.joint >= m.joints().size() || m.joints()[ r.joint ].joint->positions().size() != 1 )
+            throw std::runtime_error( "Delta frame refers to an invalid joint" );
+        m.setJointPositions( int( r.joint ), std::array{ r.position } );
+    }
+
+    for ( std::uint32_t i = 0; i < h.removedConnectionCount; i++, offset += sizeof( ConnectionRecord ) ) {
+        auto r = load< ConnectionRecord >( data, offset );
+        const auto& connections = world.roficomConnections();
+        auto it = std::find_if( connections.begin(), connections.end(), [ & ]( const RoficomJoint& rj ) {
+            return world.getModule( rj.sourceModule )->getId() == r.sourceModule
+                && world.getModule( rj.destModule )->getId() == r.destModule
+                && rj.sourceConnector == r.sourceConnector && rj.destConnector == r.destConnector
+                && int( rj.orientation ) == r.orientation;
+        } );
+        if ( it == connections.end() )
+            throw std::runtime_error( "Delta frame removes a nonexistent connection" );
+        world.disconnect( it.get_handle() );
+    }
+
+    for ( std::uint32_t i = 0; i < h.addedConnectionCount; i++, offset += sizeof( ConnectionRecord ) ) {
+        auto r = load< ConnectionRecord >( data, offset );
+        auto sourceConnectors = module( r.sourceModule ).connectors();
+        auto destConnectors = module( r.destModule ).connectors();
+        if ( r.sourceConnector >= sourceConnectors.size() || r.destConnector >= destConnectors.size() )
+            throw std::runtime_error( "Delta frame refers to a nonexistent connector" );
+        if ( r.orientation > std::uint8_t( roficom::Orientation::West ) )
+            throw std::runtime_error( "Invalid roficom orientation" );
+        connect( sourceConnectors[ r.sourceConnector ], destConnectors[ r.destConnector ],
+                 roficom::Orientation( r.orientation ) );
+    }
+}
+
+std::optional< RofiWorld > SeqReader::next() {
+    auto data = readFrame( _in );
+    if ( !data )
+        return std::nullopt;
+    if ( isDelta( *data ) ) {
+        if ( !_previous )
+            throw std::runtime_error( "Sequence starts with a delta frame" );
+        applyBinaryDelta( *_previous, *data );
+    } else {
+        _previous = fromBinary( *data );
+    }
+    return _previous;
+}
+
+void SeqWriter::write( const RofiWorld& world ) {
+    std::optional< std::vector< std::byte > > data;
+    if ( _deltaFrames && _previous )
+        data = toBinaryDelta( *_previous, world );
+    if ( !data )
+        data = toBinary( world );
+    _out.write( reinterpret_cast< const char* >( data->data() ), std::streamsize( data->size() ) );
+    if ( _deltaFrames )
+        _previous = world;
+}
+
+} // namespace rofi::configuration::binary
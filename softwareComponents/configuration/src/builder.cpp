@@ -0,0 +1,104 @@
+#include <configuration/builder.hpp>
+
+#include <cassert>
+#include <stdexcept>
+
+namespace rofi::configuration {
+
+void RofiWorldBuilder::reserve( std::size_t moduleCount, std::size_t roficomJointCount,
+                                std::size_t spaceJointCount )
+{
+    _modules.reserve( moduleCount );
+    _roficomJoints.reserve( roficomJointCount );
+    _spaceJoints.reserve( spaceJointCount );
+}
+
+RofiWorldBuilder::ModuleIdx RofiWorldBuilder::addModule( atoms::ValuePtr< Module > m ) {
+    assert( m );
+    _modules.push_back( std::move( m ) );
+    return _modules.size() - 1;
+}
+
+void RofiWorldBuilder::addRoficomJoint( ModuleIdx sourceModule, int sourceConnector,
+                                        ModuleIdx destModule, int destConnector,
+                                        roficom::Orientation o )
+{
+    if ( sourceModule >= _modules.size() || destModule >= _modules.size() )
+        throw std::logic_error( "Roficom joint refers to a nonexistent module" );
+    auto isConnector = []( const Module& m, int idx ) {
+        return idx >= 0 && to_unsigned( idx ) < m.connectors().size();
+    };
+    if ( !isConnector( *_modules[ sourceModule ], sourceConnector )
+        || !isConnector( *_modules[ destModule ], destConnector ) )
+    {
+        throw std::logic_error( "Roficom joint refers to a nonexistent connector" );
+    }
+    _roficomJoints.push_back( { sourceModule, destModule, sourceConnector, destConnector, o } );
+}
+
+void RofiWorldBuilder::addSpaceJoint( ModuleIdx module, int component, Vector refPoint,
+                                      atoms::ValuePtr< Joint > joint )
+{
+    if ( module >= _modules.size() )
+        throw std::logic_error( "Space joint refers to a nonexistent module" );
+    if ( component < 0 || to_unsigned( component ) >= _modules[ module ]->components().size() )
+        throw std::logic_error( "Space joint refers to a nonexistent component" );
+    assert( joint );
+    _spaceJoints.push_back( { module, component, std::move( refPoint ), std::move( joint ) } );
+}
+
+RofiWorld RofiWorldBuilder::build() {
+    using ModuleInfoHandle = RofiWorld::ModuleInfoHandle;
+
+    RofiWorld world;
+    world._modules.reserve( _modules.size() );
+    world._moduleJoints.reserve( _roficomJoints.size() );
+    world._spaceJoints.reserve( _spaceJoints.size() );
+
+    std::vector< ModuleInfoHandle > handles;
+    handles.reserve( _modules.size() );
+    for ( auto& m : _modules ) {
+        ModuleId id = m->getId();
+        auto handle = world._modules.insert( { std::move( m ), {}, {}, {}, std::nullopt } );
+        if ( !world._idMapping.try_emplace( id, handle ).second ) {
+            clear();
+            throw std::logic_error( "Module with given id is already present" );
+        }
+        Module& inserted = *world._modules[ handle ].module;
+        inserted.parent = &world;
+        inserted._prepareComponents();
+        handles.push_back( handle );
+    }
+
+    for ( const auto& j : _roficomJoints ) {
+        auto jointHandle = world._moduleJoints.insert( {
+            j.orientation, handles[ j.sourceModule ], handles[ j.destModule ], j.sourceConnector, j.destConnector
+        } );
+        world._modules[ handles[ j.sourceModule ] ].outJointsIdx.push_back( jointHandle );
+        world._modules[ handles[ j.destModule ] ].inJointsIdx.push_back( jointHandle );
+    }
+
+    for ( auto& j : _spaceJoints ) {
+        auto jointHandle = world._spaceJoints.insert( SpaceJoint(
+            std::move( j.joint ), std::move( j.refPoint ), handles[ j.module ], j.component ) );
+        world._modules[ handles[ j.module ] ].spaceJoints.push_back( jointHandle );
+    }
+
+    clear();
+    return world;
+}
+
+atoms::Result< RofiWorld > RofiWorldBuilder::buildPrepared() {
+    RofiWorld world = build();
+    if ( auto result = world.prepare(); !result )
+        return std::move( result ).assume_error_result();
+    return atoms::result_value( std::move( world ) );
+}
+
+void RofiWorldBuilder::clear() {
+    _modules.clear();
+    _roficomJoints.clear();
+    _spaceJoints.clear();
+}
+
+} // namespace rofi::configuration
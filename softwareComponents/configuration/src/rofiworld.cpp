@@ -1,4 +1,5 @@
 #include <configuration/rofiworld.hpp>
+#include <configuration/gridTransform.hpp>
 
 #include <atoms/unreachable.hpp>
 
@@ -76,22 +77,29 @@ std::optional< std::pair< const Component&, roficom::Orientation > > Component::
     if ( !world.isPrepared() )
         throw std::runtime_error( "rofiworld is not prepared" );
 
+    static constexpr auto allOrientations = std::array{ roficom::Orientation::North,
+                                                        roficom::Orientation::East,
+                                                        roficom::Orientation::South,
+                                                        roficom::Orientation::West };
+
+    // Positions are quantized once, so that grid-aligned positions are compared as integers
     auto thisAbsPosition = getPosition();
+    std::vector< QuantizedMatrix > candidates;
+    candidates.reserve( allOrientations.size() );
+    for ( roficom::Orientation o : allOrientations ) {
+        candidates.emplace_back( thisAbsPosition * orientationToTransform( o ) );
+    }
+
     for ( auto& moduleInfo : world.modules() ) {
         assert( moduleInfo.module );
 
         for ( const Component& nearConnector : moduleInfo.module->connectors() ) {
             assert( nearConnector.type == ComponentType::Roficom );
 
-            static constexpr auto allOrientations = std::array{ roficom::Orientation::North,
-                                                                roficom::Orientation::East,
-                                                                roficom::Orientation::South,
-                                                                roficom::Orientation::West };
-
-            for ( roficom::Orientation o : allOrientations ) {
-                if ( equals( thisAbsPosition * orientationToTransform( o ),
-                             nearConnector.getPosition() ) ) {
-                    return { { nearConnector, o } };
+            auto nearPosition = QuantizedMatrix( nearConnector.getPosition() );
+            for ( size_t i = 0; i < allOrientations.size(); i++ ) {
+                if ( equals( candidates[ i ], nearPosition ) ) {
+                    return { { nearConnector, allOrientations[ i ] } };
                 }
             }
         }
@@ -104,8 +112,10 @@ bool Module::setId( ModuleId newId ) {
     if ( parent ) {
         if ( parent->_idMapping.contains( newId ) )
             return false;
-        parent->_idMapping[ newId ] = parent->_idMapping[ _id ];
+        // Inserting into the mapping invalidates references to its elements
+        auto handle = parent->_idMapping.at( _id );
         parent->_idMapping.erase( _id );
+        parent->_idMapping.insert( { newId, handle } );
     }
     _id = newId;
     return true;
@@ -170,52 +180,53 @@ atoms::Result< std::monostate > RofiWorld::prepare() {
         } else {
             mInfo.absPosition = modulePosition;
         }
-        roots.insert( _idMapping[ mInfo.module->_id ] );
+        roots.insert( j.destModule );
     }
 
-    auto dfsTraverse = [&]( ModuleInfo& m, Matrix position, auto& self ) -> atoms::Result< std::monostate >
-    {
-        if ( m.absPosition ) {
-            if ( !equals( position, m.absPosition.value() ) )
-                return atoms::result_error(
-                        fmt::format( "Inconsistent position of module {}", m.module->_id ) );
-            return atoms::result_value( std::monostate() );
-        }
+    // Traverse breadth-first ignoring edge orientation; an explicit queue
+    // keeps large worlds from exhausting the stack and BFS keeps the chains
+    // of multiplied transformations short
+    std::vector< ModuleInfoHandle > queue( roots.begin(), roots.end() );
+    for ( std::size_t next = 0; next < queue.size(); next++ ) {
+        auto mHandle = queue[ next ];
+        ModuleInfo& m = _modules[ mHandle ];
+        Matrix position = m.absPosition.value();
 
-        m.absPosition = position;
-        // Traverse ignoring edge orientation
-        std::vector< RoficomJointHandle > joints;
-        std::copy( m.outJointsIdx.begin(), m.outJointsIdx.end(), std::back_inserter( joints ) );
-        std::copy( m.inJointsIdx.begin(), m.inJointsIdx.end(), std::back_inserter( joints ) );
-        for ( auto outJointIdx : joints ) {
-            const RoficomJoint& j = _moduleJoints[ outJointIdx ];
+        auto visit = [&]( RoficomJointHandle jointIdx ) -> atoms::Result< std::monostate > {
+            const RoficomJoint& j = _moduleJoints[ jointIdx ];
 
-            bool mIsSource = j.sourceModule == _idMapping[ m.module->_id ];
+            bool mIsSource = j.sourceModule == mHandle;
             Matrix jointTransf = mIsSource ? j.sourceToDest() : j.destToSource();
             Matrix jointRefPosition = position
                                     * m.module->getComponentRelativePosition( mIsSource
                                                                             ? j.sourceConnector
                                                                             : j.destConnector )
                                     * jointTransf;
-            ModuleInfo& other = _modules[ mIsSource ? j.destModule : j.sourceModule ];
+            auto otherHandle = mIsSource ? j.destModule : j.sourceModule;
+            ModuleInfo& other = _modules[ otherHandle ];
             Matrix otherConnectorPosition = other.module->getComponentRelativePosition( mIsSource
                                                                                       ? j.destConnector
                                                                                       : j.sourceConnector );
             // Reverse the comonentPosition to get position of the module origin
             Matrix otherPosition = jointRefPosition * arma::inv( otherConnectorPosition );
-            if ( auto result = self( other, otherPosition, self ); !result ) {
-                return result;
+            if ( other.absPosition ) {
+                if ( !equals( otherPosition, other.absPosition.value() ) )
+                    return atoms::result_error(
+                            fmt::format( "Inconsistent position of module {}", other.module->_id ) );
+                return atoms::result_value( std::monostate() );
             }
+            other.absPosition = otherPosition;
+            queue.push_back( otherHandle );
+            return atoms::result_value( std::monostate() );
+        };
+
+        for ( auto jointIdx : m.outJointsIdx ) {
+            if ( auto result = visit( jointIdx ); !result )
+                return result;
         }
-        return atoms::result_value( std::monostate() );
-    };
-
-    for ( auto h : roots ) {
-        ModuleInfo& m = _modules[ h ];
-        auto pos = m.absPosition.value();
-        m.absPosition.reset();
-        if ( auto result = dfsTraverse( m, pos, dfsTraverse ); !result ) {
-            return result;
+        for ( auto jointIdx : m.inJointsIdx ) {
+            if ( auto result = visit( jointIdx ); !result )
+                return result;
         }
     }
 
@@ -1,11 +1,30 @@
 #include <configuration/universalModule.hpp>
 
+#include <cmath>
+#include <numbers>
+#include <optional>
+
 #include <atoms/unreachable.hpp>
 
 namespace rofi::configuration {
 
 using namespace rofi::configuration::matrices;
 
+namespace {
+
+/**
+ * Returns the angle as a number of right angles if it is a multiple of the right angle
+ */
+std::optional< int > rightAngles( Angle a ) {
+    double count = double( a.rad() ) / ( std::numbers::pi / 2 );
+    double rounded = std::round( count );
+    if ( std::abs( count - rounded ) > 1e-5 )
+        return std::nullopt;
+    return static_cast< int >( rounded );
+}
+
+} // namespace
+
 std::vector< Component > UniversalModule::_initComponents() {
     return std::vector< Component > {
         Component{ ComponentType::Roficom, {}, {}, nullptr },
@@ -46,6 +65,36 @@ std::vector< ComponentJoint > UniversalModule::_initJoints() {
     return joints;
 }
 
+atoms::Result< std::vector< Matrix > > UniversalModule::_computeComponentRelativePositions() const {
+    // Alpha and beta are within [-90, 90], gamma within [-180, 180] degrees
+    constexpr int alphaCount = 3;
+    constexpr int betaCount = 3;
+    constexpr int gammaCount = 5;
+    static const auto table = [] {
+        std::vector< std::vector< Matrix > > positions;
+        positions.reserve( alphaCount * betaCount * gammaCount );
+        for ( float a : { -90.0f, 0.0f, 90.0f } ) {
+            for ( float b : { -90.0f, 0.0f, 90.0f } ) {
+                for ( float g : { -180.0f, -90.0f, 0.0f, 90.0f, 180.0f } ) {
+                    UniversalModule m( 0, Angle::deg( a ), Angle::deg( b ), Angle::deg( g ) );
+                    positions.push_back( m.Module::_computeComponentRelativePositions()
+                                                  .get_or_throw_as< std::logic_error >() );
+                }
+            }
+        }
+        return positions;
+    }();
+
+    auto alpha = rightAngles( getAlpha() );
+    auto beta = rightAngles( getBeta() );
+    auto gamma = rightAngles( getGamma() );
+    if ( alpha && beta && gamma && std::abs( *alpha ) <= 1 && std::abs( *beta ) <= 1 && std::abs( *gamma ) <= 2 ) {
+        auto idx = ( ( *alpha + 1 ) * betaCount + *beta + 1 ) * gammaCount + *gamma + 2;
+        return atoms::result_value( table[ to_unsigned( idx ) ] );
+    }
+    return Module::_computeComponentRelativePositions();
+}
+
 
 bool checkOldConfigurationEInput( int id1, int id2, int side1, int side2, int dock1, int dock2
                                     , int orientation, const std::set< ModuleId >& knownModules ) {
@@ -0,0 +1,240 @@
+#include <catch2/catch.hpp>
+
+#include <configuration/binary.hpp>
+#include <configuration/serialization.hpp>
+#include <limits>
+#include <sstream>
+
+
+namespace {
+
+using namespace rofi::configuration;
+using namespace rofi::configuration::roficom;
+using namespace rofi::configuration::matrices;
+
+RofiWorld roundtrip( const RofiWorld& world ) {
+    return binary::fromBinary( binary::toBinary( world ) );
+}
+
+binary::Header header( const std::vector< std::byte >& data ) {
+    binary::Header h;
+    std::memcpy( &h, data.data(), sizeof( h ) );
+    return h;
+}
+
+TEST_CASE( "Binary - Empty" ) {
+    RofiWorld world;
+    auto data = binary::toBinary( world );
+    CHECK( data.size() == sizeof( binary::Header ) );
+    CHECK( binary::binarySize( data ) == data.size() );
+
+    RofiWorld cpy = binary::fromBinary( data );
+    CHECK( cpy.modules().size() == 0 );
+    CHECK( cpy.roficomConnections().size() == 0 );
+    CHECK( cpy.referencePoints().size() == 0 );
+}
+
+TEST_CASE( "Binary - Modules" ) {
+    RofiWorld world;
+
+    SECTION( "Universal modules" ) {
+        auto& m1 = world.insert( UniversalModule( 0, 0_deg, 90_deg,   0_deg ) );
+        auto& m2 = world.insert( UniversalModule( 1, 0_deg,  0_deg, 180_deg ) );
+        auto& m3 = world.insert( UniversalModule( 7, 13.5_deg, -42_deg, 33.3_deg ) );
+        connect( m1.connectors()[ 0 ], m2.connectors()[ 1 ], Orientation::South );
+        connect( m2.getConnector( "B-Z" ), m3.getConnector( "A+X" ), Orientation::West );
+        connect< RigidJoint >( m1.bodies()[ 0 ], { 0, 0, 0 }, identity );
+    }
+
+    SECTION( "Pads and cubes" ) {
+        auto& pad = world.insert( Pad( 42, 10, 8 ) );
+        auto& cube = world.insert( Cube( 3 ) );
+        auto& um = world.insert( UniversalModule( 66, 0_deg, 0_deg, 180_deg ) );
+        connect( pad.components()[ 0 ], um.getConnector( "A-Z" ), Orientation::North );
+        connect( um.getConnector( "B-Z" ), cube.connectors()[ 2 ], Orientation::East );
+        connect< RigidJoint >( pad.components()[ 0 ], { 0, 0, 0 }, identity );
+    }
+
+    SECTION( "Rotation space joint" ) {
+        auto& um = world.insert( UniversalModule( 5, 10_deg, 20_deg, 30_deg ) );
+        auto h = connect< RotationJoint >( um.bodies()[ 0 ], { 1, 2, 3 }, identity,
+                                           Vector{ 0, 0, 1, 0 }, identity, -90_deg, 90_deg );
+        world.setSpaceJointPositions( h, std::array{ Angle::deg( 45 ).rad() } );
+    }
+
+    REQUIRE( world.prepare() );
+    RofiWorld cpy = roundtrip( world );
+    REQUIRE( cpy.prepare() );
+
+    CHECK( serialization::toJSON( world ) == serialization::toJSON( cpy ) );
+    for ( auto& m : world.modules() ) {
+        ModuleId id = m.module->getId();
+        CHECK( equals( world.getModulePosition( id ), cpy.getModulePosition( id ) ) );
+    }
+}
+
+TEST_CASE( "Binary - Unknown modules share their shape" ) {
+    RofiWorld world;
+    for ( int id = 0; id < 3; id++ ) {
+        auto m = UnknownModule( { Component{ ComponentType::Roficom, {}, {}, nullptr }
+                                , Component{ ComponentType::UmBody, {}, {}, nullptr }
+                                , Component{ ComponentType::Roficom, {}, {}, nullptr } }
+                                , 2
+                                , { makeComponentJoint< RigidJoint >( 1, 0, identity )
+                                  , makeComponentJoint< RotationJoint >( 1, 2, identity, Vector{ 1, 0, 0, 0 },
+                                                                         identity, -90_deg, 90_deg ) }
+                                , id );
+        m.setJointPositions( 1, std::array{ Angle::deg( 10.0f * id ).rad() } );
+        world.insert( m );
+    }
+
+    auto data = binary::toBinary( world );
+    auto h = header( data );
+    CHECK( h.moduleCount == 3 );
+    CHECK( h.jointCount == 2 );
+    CHECK( h.shapeWordCount == 3 + 3 + 2 * 3 );
+    CHECK( h.positionCount == 3 );
+
+    RofiWorld cpy = binary::fromBinary( data );
+    REQUIRE( cpy.modules().size() == 3 );
+    for ( int id = 0; id < 3; id++ ) {
+        const Module* m = cpy.getModule( id );
+        REQUIRE( m );
+        CHECK( m->type == ModuleType::Unknown );
+        CHECK( m->connectors().size() == 2 );
+        CHECK( m->components()[ 1 ].type == ComponentType::UmBody );
+        CHECK( m->joints()[ 1 ].joint->positions()[ 0 ] == Angle::deg( 10.0f * id ).rad() );
+    }
+}
+
+TEST_CASE( "Binary - Stream" ) {
+    RofiWorld a;
+    a.insert( UniversalModule( 0, 0_deg, 90_deg, 0_deg ) );
+    RofiWorld b;
+    b.insert( Pad( 1, 3, 4 ) );
+
+    std::stringstream stream;
+    binary::writeBinary( stream, a );
+    binary::writeBinary( stream, b );
+
+    CHECK( serialization::toJSON( binary::readBinary( stream ) ) == serialization::toJSON( a ) );
+    CHECK( serialization::toJSON( binary::readBinary( stream ) ) == serialization::toJSON( b ) );
+    CHECK_THROWS_AS( binary::readBinary( stream ), std::runtime_error );
+}
+
+TEST_CASE( "Binary - Delta frames" ) {
+    RofiWorld world;
+    auto& m1 = world.insert( UniversalModule( 0, 0_deg, 90_deg, 0_deg ) );
+    auto& m2 = world.insert( UniversalModule( 1, 0_deg, 0_deg, 0_deg ) );
+    connect< RigidJoint >( m1.bodies()[ 0 ], { 0, 0, 0 }, identity );
+    auto conn = connect( m1.connectors()[ 0 ], m2.connectors()[ 1 ], Orientation::South );
+
+    std::vector< RofiWorld > seq = { world };
+    dynamic_cast< UniversalModule& >( *world.getModule( 1 ) ).setGamma( 90_deg );
+    seq.push_back( world );
+    world.disconnect( conn );
+    connect( world.getModule( 0 )->connectors()[ 0 ], world.getModule( 1 )->connectors()[ 1 ],
+             Orientation::North );
+    seq.push_back( world );
+    world.insert( Cube( 2 ) );
+    seq.push_back( world );
+
+    SECTION( "Single joint change" ) {
+        auto delta = binary::toBinaryDelta( seq[ 0 ], seq[ 1 ] );
+        REQUIRE( delta );
+        CHECK( binary::isDelta( *delta ) );
+        CHECK( delta->size() == sizeof( binary::DeltaHeader ) + sizeof( binary::JointChangeRecord ) );
+
+        RofiWorld cpy = seq[ 0 ];
+        binary::applyBinaryDelta( cpy, *delta );
+        CHECK( serialization::toJSON( cpy ) == serialization::toJSON( seq[ 1 ] ) );
+        CHECK_THROWS_AS( binary::fromBinary( *delta ), std::runtime_error );
+    }
+
+    SECTION( "Different modules" ) {
+        CHECK_FALSE( binary::toBinaryDelta( seq[ 2 ], seq[ 3 ] ) );
+    }
+
+    SECTION( "Structure and connections" ) {
+        CHECK( binary::sameStructure( seq[ 0 ], seq[ 1 ] ) );
+        CHECK( binary::sameConnections( seq[ 0 ], seq[ 1 ] ) );
+        CHECK( binary::sameStructure( seq[ 1 ], seq[ 2 ] ) );
+        CHECK_FALSE( binary::sameConnections( seq[ 1 ], seq[ 2 ] ) );
+        CHECK_FALSE( binary::sameStructure( seq[ 2 ], seq[ 3 ] ) );
+        CHECK_FALSE( binary::sameStructure( seq[ 3 ], seq[ 2 ] ) );
+        CHECK( binary::sameConnections( seq[ 2 ], seq[ 3 ] ) );
+    }
+
+    SECTION( "Stream" ) {
+        std::stringstream deltas, full;
+        binary::SeqWriter deltaWriter( deltas );
+        binary::SeqWriter fullWriter( full, false );
+        for ( const auto& w : seq ) {
+            deltaWriter.write( w );
+            fullWriter.write( w );
+        }
+        CHECK( deltas.str().size() < full.str().size() );
+
+        binary::SeqReader reader( deltas );
+        for ( const auto& w : seq ) {
+            auto read = reader.next();
+            REQUIRE( read );
+            CHECK( serialization::toJSON( *read ) == serialization::toJSON( w ) );
+        }
+        CHECK_FALSE( reader.next() );
+    }
+
+    SECTION( "Delta without previous world" ) {
+        std::stringstream stream;
+        auto delta = binary::toBinaryDelta( seq[ 0 ], seq[ 1 ] );
+        stream.write( reinterpret_cast< const char* >( delta->data() ), std::streamsize( delta->size() ) );
+        binary::SeqReader reader( stream );
+        CHECK_THROWS_AS( reader.next(), std::runtime_error );
+    }
+}
+
+TEST_CASE( "Binary - Malformed data" ) {
+    RofiWorld world;
+    auto& m1 = world.insert( UniversalModule( 0, 0_deg, 90_deg, 0_deg ) );
+    auto& m2 = world.insert( UniversalModule( 1, 0_deg, 0_deg, 0_deg ) );
+    connect( m1.connectors()[ 0 ], m2.connectors()[ 1 ], Orientation::South );
+    auto data = binary::toBinary( world );
+
+    SECTION( "Truncated" ) {
+        data.resize( data.size() - 8 );
+        CHECK_THROWS_AS( binary::fromBinary( data ), std::runtime_error );
+    }
+
+    SECTION( "Bad magic" ) {
+        data[ 0 ] = std::byte( 'X' );
+        CHECK_THROWS_AS( binary::fromBinary( data ), std::runtime_error );
+    }
+
+    SECTION( "Bad version" ) {
+        data[ 4 ] = std::byte( 42 );
+        CHECK_THROWS_AS( binary::fromBinary( data ), std::runtime_error );
+    }
+
+    SECTION( "Huge size in a short stream" ) {
+        // The size matches the counts, only reading the payload can show that
+        // it is missing; the claimed size must not be allocated up front
+        auto h = header( data );
+        h.size += std::uint64_t( std::numeric_limits< std::uint32_t >::max() - h.moduleCount )
+                * sizeof( binary::ModuleRecord );
+        h.moduleCount = std::numeric_limits< std::uint32_t >::max();
+        std::memcpy( data.data(), &h, sizeof( h ) );
+        REQUIRE( binary::binarySize( data ) == h.size );
+
+        std::stringstream stream;
+        stream.write( reinterpret_cast< const char* >( data.data() ), std::streamsize( data.size() ) );
+        CHECK_THROWS_WITH( binary::readFrame( stream ), "Binary world is truncated" );
+    }
+
+    SECTION( "Bad module reference" ) {
+        std::size_t offset = sizeof( binary::Header ) + 2 * sizeof( binary::ModuleRecord );
+        data[ offset ] = std::byte( 5 );
+        CHECK_THROWS_AS( binary::fromBinary( data ), std::runtime_error );
+    }
+}
+
+} // namespace
@@ -0,0 +1,85 @@
+#include <catch2/catch.hpp>
+
+#include <configuration/builder.hpp>
+#include <configuration/serialization.hpp>
+
+
+namespace {
+
+using namespace rofi::configuration;
+using namespace rofi::configuration::roficom;
+using namespace rofi::configuration::matrices;
+
+TEST_CASE( "Builder - Same world as insert and connect" ) {
+    RofiWorld world;
+    auto& m1 = world.insert( UniversalModule( 0, 0_deg, 90_deg, 0_deg ) );
+    auto& m2 = world.insert( UniversalModule( 1, 0_deg, 0_deg, 180_deg ) );
+    auto& pad = world.insert( Pad( 42, 3, 4 ) );
+    connect( m1.connectors()[ 0 ], m2.connectors()[ 1 ], Orientation::South );
+    connect( pad.components()[ 0 ], m1.connectors()[ 2 ], Orientation::North );
+    connect< RigidJoint >( pad.components()[ 0 ], { 0, 0, 0 }, identity );
+    REQUIRE( world.prepare() );
+
+    RofiWorldBuilder builder;
+    builder.reserve( 3, 2 );
+    auto b1 = builder.addModule( UniversalModule( 0, 0_deg, 90_deg, 0_deg ) );
+    auto b2 = builder.addModule( UniversalModule( 1, 0_deg, 0_deg, 180_deg ) );
+    auto bPad = builder.addModule( Pad( 42, 3, 4 ) );
+    builder.addRoficomJoint( b1, 0, b2, 1, Orientation::South );
+    builder.addRoficomJoint( bPad, 0, b1, 2, Orientation::North );
+    builder.addSpaceJoint< RigidJoint >( bPad, 0, { 0, 0, 0 }, identity );
+
+    auto built = builder.buildPrepared();
+    REQUIRE( built );
+    CHECK( serialization::toJSON( *built ) == serialization::toJSON( world ) );
+    for ( auto& m : world.modules() ) {
+        ModuleId id = m.module->getId();
+        CHECK( equals( built->getModulePosition( id ), world.getModulePosition( id ) ) );
+    }
+
+    CHECK( builder.build().modules().size() == 0 );
+}
+
+TEST_CASE( "Builder - Long chain" ) {
+    constexpr int count = 10'000;
+    RofiWorldBuilder builder;
+    builder.reserve( count, count - 1 );
+    for ( int i = 0; i < count; i++ ) {
+        builder.addModule( UniversalModule( i, 0_deg, 0_deg, 0_deg ) );
+        if ( i > 0 )
+            builder.addRoficomJoint( i - 1, 5, i, 2, Orientation::North );
+    }
+    builder.addSpaceJoint< RigidJoint >( 0, 0, { 0, 0, 0 }, identity );
+
+    auto world = builder.buildPrepared();
+    REQUIRE( world );
+    CHECK( world->modules().size() == count );
+    CHECK( world->roficomConnections().size() == count - 1 );
+    CHECK( world->getModulePosition( count - 1 )( 2, 3 ) > world->getModulePosition( 0 )( 2, 3 ) );
+}
+
+TEST_CASE( "Builder - Invalid input" ) {
+    RofiWorldBuilder builder;
+    auto m = builder.addModule( UniversalModule( 0, 0_deg, 0_deg, 0_deg ) );
+
+    CHECK_THROWS_AS( builder.addRoficomJoint( m, 0, 1, 0, Orientation::North ), std::logic_error );
+    CHECK_THROWS_AS( builder.addRoficomJoint( m, 6, m, 0, Orientation::North ), std::logic_error );
+    CHECK_THROWS_AS( builder.addSpaceJoint< RigidJoint >( m, 10, { 0, 0, 0 }, identity ),
+                     std::logic_error );
+
+    builder.addModule( Cube( 0 ) );
+    CHECK_THROWS_AS( builder.build(), std::logic_error );
+}
+
+TEST_CASE( "Builder - Inconsistent world" ) {
+    RofiWorldBuilder builder;
+    auto m1 = builder.addModule( UniversalModule( 0, 0_deg, 0_deg, 0_deg ) );
+    auto m2 = builder.addModule( UniversalModule( 1, 0_deg, 0_deg, 0_deg ) );
+    builder.addSpaceJoint< RigidJoint >( m1, 0, { 0, 0, 0 }, identity );
+    builder.addSpaceJoint< RigidJoint >( m2, 0, { 0, 0, 0 }, identity );
+    builder.addRoficomJoint( m1, 0, m2, 0, Orientation::North );
+
+    CHECK_FALSE( builder.buildPrepared() );
+}
+
+} // namespace
@@ -0,0 +1,100 @@
+#include <catch2/catch.hpp>
+
+#include <atoms/units.hpp>
+#include <configuration/gridTransform.hpp>
+#include <set>
+#include <unordered_set>
+#include <vector>
+
+
+namespace {
+
+using namespace rofi::configuration::matrices;
+
+std::vector< Matrix > axisAlignedRotations() {
+    std::vector< Matrix > rotations;
+    for ( int x = 0; x < 4; x++ ) {
+        for ( int y = 0; y < 4; y++ ) {
+            for ( int z = 0; z < 4; z++ ) {
+                rotations.push_back( rotate( x * double( Angle::pi ) / 2, X )
+                                   * rotate( y * double( Angle::pi ) / 2, Y )
+                                   * rotate( z * double( Angle::pi ) / 2, Z ) );
+            }
+        }
+    }
+    return rotations;
+}
+
+TEST_CASE( "GridTransform - Axis-aligned rotations" ) {
+    std::set< int > indices;
+    for ( const Matrix& r : axisAlignedRotations() ) {
+        Matrix m = translate( { 3, -2, 7 } ) * r;
+        auto grid = GridTransform::fromMatrix( m );
+        REQUIRE( grid );
+        CHECK( equals( grid->toMatrix(), m ) );
+        CHECK( grid->translation() == std::array< std::int32_t, 3 >{ 3, -2, 7 } );
+        indices.insert( grid->rotation() );
+    }
+    CHECK( indices.size() == 24 );
+    CHECK( *indices.begin() == 0 );
+    CHECK( *indices.rbegin() == 23 );
+    CHECK( GridTransform::fromMatrix( identity )->rotation() == 0 );
+}
+
+TEST_CASE( "GridTransform - Not aligned to the grid" ) {
+    CHECK_FALSE( GridTransform::fromMatrix( rotate( Angle::pi / 4, Z ) ) );
+    CHECK_FALSE( GridTransform::fromMatrix( translate( { 0.5, 0, 0 } ) ) );
+    CHECK_FALSE( GridTransform::fromMatrix( translate( { 0, 0, 1.01 } ) ) );
+
+    Matrix reflection = identity;
+    reflection( 0, 0 ) = -1;
+    CHECK_FALSE( GridTransform::fromMatrix( reflection ) );
+
+    Matrix degenerate = identity;
+    degenerate( 1, 1 ) = 0;
+    degenerate( 1, 0 ) = 1;
+    CHECK_FALSE( GridTransform::fromMatrix( degenerate ) );
+}
+
+TEST_CASE( "GridTransform - Matches equals" ) {
+    auto rotations = axisAlignedRotations();
+    for ( size_t i = 0; i < rotations.size(); i++ ) {
+        for ( size_t j = 0; j < rotations.size(); j += 7 ) {
+            Matrix a = translate( { 1, 2, 3 } ) * rotations[ i ];
+            Matrix b = translate( { 1, 2, 3 } ) * rotations[ j ];
+            Matrix noise = arma::mat( 4, 4, arma::fill::zeros );
+            noise( 0, 3 ) = 2e-4;
+            noise( 1, 1 ) = -1e-4;
+
+            auto qa = QuantizedMatrix( a );
+            auto qb = QuantizedMatrix( b + noise );
+            REQUIRE( qa.grid );
+            REQUIRE( qb.grid );
+            CHECK( equals( qa, qb ) == equals( a, b + noise ) );
+            CHECK( ( *qa.grid == *qb.grid ) == equals( a, b ) );
+        }
+    }
+
+    SECTION( "Fallback to float compare" ) {
+        Matrix a = rotate( Angle::pi / 4, Z );
+        Matrix noise = arma::mat( 4, 4, arma::fill::zeros );
+        noise( 2, 3 ) = 5e-4;
+        CHECK( equals( QuantizedMatrix( a ), QuantizedMatrix( a + noise ) ) );
+        CHECK_FALSE( equals( QuantizedMatrix( a ), QuantizedMatrix( identity ) ) );
+        CHECK_FALSE( equals( QuantizedMatrix( identity ), QuantizedMatrix( a ) ) );
+    }
+}
+
+TEST_CASE( "GridTransform - Hashing" ) {
+    std::unordered_set< GridTransform > set;
+    for ( const Matrix& r : axisAlignedRotations() ) {
+        for ( int x = -2; x <= 2; x++ ) {
+            set.insert( *GridTransform::fromMatrix( translate( { double( x ), 0, 1 } ) * r ) );
+        }
+    }
+    CHECK( set.size() == 24 * 5 );
+    CHECK( set.contains( *GridTransform::fromMatrix( translate( { -2, 0, 1 } ) ) ) );
+    CHECK_FALSE( set.contains( *GridTransform::fromMatrix( translate( { 3, 0, 1 } ) ) ) );
+}
+
+} // namespace
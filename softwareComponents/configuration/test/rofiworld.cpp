@@ -1,5 +1,6 @@
 #include <catch2/catch.hpp>
 
+#include <configuration/cube.hpp>
 #include <configuration/pad.hpp>
 #include <configuration/rofiworld.hpp>
 #include <configuration/test_aid.hpp>
@@ -220,6 +221,57 @@ TEST_CASE( "Universal Module Test" ) {
     }
 }
 
+/**
+ * \brief Check that component positions of a module match the ones computed by
+ * traversing the component joints of a module with the same structure
+ */
+void checkComponentPositions( Module& m ) {
+    auto generic = UnknownModule( { m.components().begin(), m.components().end() },
+                                  int( m.connectors().size() ),
+                                  { m.joints().begin(), m.joints().end() },
+                                  m.getId() );
+    REQUIRE( m.prepare() );
+    REQUIRE( generic.prepare() );
+    for ( int i = 0; to_unsigned( i ) < m.components().size(); i++ ) {
+        INFO( "Component number: " << i );
+        CHECK( equals( m.getComponentRelativePosition( i ), generic.getComponentRelativePosition( i ) ) );
+    }
+}
+
+TEST_CASE( "Component positions of known module types" ) {
+    SECTION( "Universal module - right angles" ) {
+        for ( int a : { -90, 0, 90 } ) {
+            for ( int b : { -90, 0, 90 } ) {
+                for ( int g : { -180, -90, 0, 90, 180 } ) {
+                    INFO( "Angles: " << a << " " << b << " " << g );
+                    auto um = UniversalModule( 0, Angle::deg( float( a ) ), Angle::deg( float( b ) ),
+                                               Angle::deg( float( g ) ) );
+                    checkComponentPositions( um );
+                }
+            }
+        }
+    }
+
+    SECTION( "Universal module - other angles" ) {
+        auto um = UniversalModule( 0, 13.5_deg, -42_deg, 33.3_deg );
+        checkComponentPositions( um );
+        um.setAlpha( 90_deg );
+        checkComponentPositions( um );
+        um.setGamma( 180_deg );
+        checkComponentPositions( um );
+    }
+
+    SECTION( "Cube" ) {
+        auto cube = Cube( 3 );
+        checkComponentPositions( cube );
+    }
+
+    SECTION( "Pad" ) {
+        auto pad = Pad( 42, 3, 4 );
+        checkComponentPositions( pad );
+    }
+}
+
 TEST_CASE( "Two modules next to each other" ) {
     ModuleId idCounter = 0;
     RofiWorld world;
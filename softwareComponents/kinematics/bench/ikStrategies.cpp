@@ -0,0 +1,107 @@
+// Success rate and timing of the inverse kinematics strategies of kinematic_rofibot.
+//
+// Usage: bench-ik-strategies <configuration> <targets> [targets...]
+//
+// The configuration is a fixed arm (e.g. data/configurations/old/kinematics/on_top.rofi),
+// the targets are files in the format of rofi-ik --targets, lines `r x y z rx ry rz`
+// (e.g. data/configurations/old/kinematics/set2.txt). Each target is reached from the
+// initial configuration by each of the strategies. The batched DLS is run with 1, 2, 4 and
+// all hardware threads.
+
+#include "kinematics.cpp"
+
+#include <chrono>
+#include <iomanip>
+
+namespace {
+
+struct Target {
+    Vector goal;
+    std::vector< double > rotation;
+};
+
+std::vector< Target > readTargets( const std::string& path ) {
+    std::ifstream input( path );
+    if ( !input.is_open() ) {
+        std::cerr << "Couldn't open file " << path << '\n';
+        std::exit( 1 );
+    }
+    std::vector< Target > targets;
+    std::string line;
+    while ( std::getline( input, line ) ) {
+        std::stringstream ss( line );
+        std::string method;
+        ss >> method;
+        if ( method != "r" )
+            continue;
+        Target target{ { 0, 0, 0, 1 }, { 0, 0, 0 } };
+        ss >> target.goal[ 0 ] >> target.goal[ 1 ] >> target.goal[ 2 ]
+           >> target.rotation[ 0 ] >> target.rotation[ 1 ] >> target.rotation[ 2 ];
+        targets.push_back( target );
+    }
+    return targets;
+}
+
+} // namespace
+
+int main( int argc, char** argv ) {
+    if ( argc < 3 ) {
+        std::cerr << "Usage: " << argv[ 0 ] << " <configuration> <targets> [targets...]\n";
+        return 1;
+    }
+
+    std::vector< Target > targets;
+    for ( int i = 2; i < argc; ++i ) {
+        auto fileTargets = readTargets( argv[ i ] );
+        targets.insert( targets.end(), fileTargets.begin(), fileTargets.end() );
+    }
+
+    kinematic_rofibot bot( argv[ 1 ], true );
+    Configuration initial = bot.get_config();
+
+    std::vector< std::pair< std::string, strategy > > strategies = {
+        { "ccd", strategy::ccd },
+        { "fabrik", strategy::fabrik },
+        { "pseudoinverse", strategy::pseudoinverse },
+        { "dls", strategy::dls }
+    };
+
+    std::cout << std::left << std::setw( 16 ) << "strategy"
+              << std::right << std::setw( 10 ) << "reached" << std::setw( 10 ) << "targets"
+              << std::setw( 14 ) << "ms/target" << "\n";
+    for ( const auto& [ name, s ] : strategies ) {
+        int reached = 0;
+        std::chrono::duration< double, std::milli > total{};
+        for ( const auto& target : targets ) {
+            bot.reset( initial );
+            auto start = std::chrono::steady_clock::now();
+            reached += bot.reach( target.goal, target.rotation, s );
+            total += std::chrono::steady_clock::now() - start;
+        }
+        std::cout << std::left << std::setw( 16 ) << name
+                  << std::right << std::setw( 10 ) << reached << std::setw( 10 ) << targets.size()
+                  << std::setw( 14 ) << std::fixed << std::setprecision( 2 )
+                  << total.count() / std::max< std::size_t >( targets.size(), 1 ) << "\n";
+    }
+
+    // All the targets at once, sharing the precomputed frames of the arm
+    bot.reset( initial );
+    std::vector< Matrix > frames;
+    for ( const auto& target : targets )
+        frames.push_back( kinematic_rofibot::target_frame( target.goal, target.rotation ) );
+    std::vector< unsigned > threadCounts = { 1, 2, 4 };
+    unsigned hardwareThreads = std::max( std::thread::hardware_concurrency(), 1u );
+    if ( hardwareThreads > threadCounts.back() )
+        threadCounts.push_back( hardwareThreads );
+    for ( unsigned threads : threadCounts ) {
+        auto start = std::chrono::steady_clock::now();
+        auto results = bot.reach_all( frames, 0, threads );
+        std::chrono::duration< double, std::milli > total = std::chrono::steady_clock::now() - start;
+        int reached = std::count_if( results.begin(), results.end(),
+            []( const reach_result& r ) { return r.reached; } );
+        std::cout << std::left << std::setw( 16 ) << "dls (batch, " + std::to_string( threads ) + ")"
+                  << std::right << std::setw( 10 ) << reached << std::setw( 10 ) << targets.size()
+                  << std::setw( 14 ) << std::fixed << std::setprecision( 2 )
+                  << total.count() / std::max< std::size_t >( targets.size(), 1 ) << "\n";
+    }
+}
@@ -86,6 +86,15 @@ inline double magnitude( const Vector& vector ){
                       std::pow( vector[ 2 ], 2 ) );
 }
 
+/* Rotation and translation part of a homogeneous matrix */
+inline arma::mat33 get_rotation( const Matrix& m ){
+    return m.submat( 0, 0, 2, 2 );
+}
+
+inline arma::vec3 get_translation( const Matrix& m ){
+    return m.submat( 0, 3, 2, 3 );
+}
+
 inline double arbitrary_magnitude( const arma::vec& vector ){
     double sum = 0;
     for( double d : vector ){
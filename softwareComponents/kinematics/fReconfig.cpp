@@ -130,31 +130,51 @@ treeConfig::treeConfig( Configuration c ){
 void treeConfig::makeTree(){
     std::deque< std::pair< ID, int > > queue;
     std::unordered_set< ID > seen;
+    std::unordered_set< ID > inTree;
+    std::vector< Edge > treeEdges;
     int depth = 0;
-    Configuration treed = config;
-    treed.clearEdges();
 
     queue.emplace_back( root, depth );
     seen.insert( root );
 
     while( !queue.empty() ){
         auto [ id, depth ] = queue.front();
-        depths[ id ] = depth;
+        setDepth( id, depth );
         queue.pop_front();
         auto edges = config.getEdges( id, seen );
         for( auto edge : edges ){
             ID otherId = edge.id2();
-            if( treed.getEdges( otherId ).empty() ){
-                treed.addEdge( edge );
+            if( inTree.count( otherId ) == 0 ){
+                treeEdges.push_back( edge );
+                inTree.insert( id );
+                inTree.insert( otherId );
             }
             queue.emplace_back( otherId, depth + 1 );
             seen.insert( otherId );
         }
 
     }
-    treed.setFixed( root, A, identity );
-    treed.computeMatrices();
-    config = treed;
+
+    // Disconnect the edges outside of the tree instead of rebuilding the configuration
+    std::vector< Edge > allEdges;
+    for( ID id : config.getIDs() ){
+        for( const auto& edge : config.getEdges( id ) ){
+            if( edge.id1() < edge.id2() ){
+                allEdges.push_back( edge );
+            }
+        }
+    }
+    if( allEdges.size() != treeEdges.size() ){
+        for( const auto& edge : allEdges ){
+            if( find( treeEdges.begin(), treeEdges.end(), edge ) == treeEdges.end()
+                && find( treeEdges.begin(), treeEdges.end(), reverse( edge ) ) == treeEdges.end() )
+            {
+                reconnect( false, edge );
+            }
+        }
+    }
+    config.setFixed( root, A, identity );
+    config.computeMatrices();
 }
 
 treeConfig::treeConfig( Configuration c, ID r ) : config( c ), root( r ),
@@ -163,18 +183,106 @@ treeConfig::treeConfig( Configuration c, ID r ) : config( c ), root( r ),
     makeTree();
 }
 
-treeConfig treeConfig::saveState(){
-    treeConfig old( config, root );
-    old.depths = depths;
-    old.reconfigurationSteps = reconfigurationSteps;
-    return old;
+treeState treeConfig::saveState(){
+    ++stamp;
+    return { trail.size(), reconfigurationSteps.size() };
+}
+
+void treeConfig::resetState( const treeState& old ){
+    reconfigurationSteps.resize( old.steps );
+    // Joints logged before the reset have to be logged again
+    ++stamp;
+    if( trail.size() == old.trail ){
+        return;
+    }
+    while( trail.size() > old.trail ){
+        const undoStep& step = trail.back();
+        switch( step.type ){
+            case undoStep::kind::joint:
+                config.getModule( step.id ).setJoint( step.j, step.angle );
+                break;
+            case undoStep::kind::connection:
+                config.execute( Action( Action::Reconnect( false, step.edge ) ) );
+                break;
+            case undoStep::kind::disconnect:
+                config.execute( Action( Action::Reconnect( true, step.edge ) ) );
+                break;
+            case undoStep::kind::depth:
+                if( step.depth == -1 ){
+                    depths.erase( step.id );
+                } else {
+                    depths[ step.id ] = step.depth;
+                }
+                break;
+            case undoStep::kind::root:
+                root = step.id;
+                break;
+        }
+        trail.pop_back();
+    }
+    config.setFixed( root, A, identity );
+    config.computeMatrices();
+}
+
+void treeConfig::logJoint( ID id, Joint j ){
+    if( stamp == 0 ){
+        return;
+    }
+    auto [ it, inserted ] = jointStamps.try_emplace( { id, j }, stamp );
+    if( !inserted ){
+        if( it->second == stamp ){
+            return;
+        }
+        it->second = stamp;
+    }
+    undoStep step;
+    step.type = undoStep::kind::joint;
+    step.id = id;
+    step.j = j;
+    step.angle = config.getModule( id ).getJoint( j );
+    trail.push_back( step );
 }
 
-void treeConfig::resetState( const treeConfig& old ){
-    reconfigurationSteps.resize( old.reconfigurationSteps.size() );
-    config = old.config;
-    root = old.root;
-    depths = old.depths;
+bool treeConfig::reconnect( bool add, const Edge& edge ){
+    if( !config.execute( Action( Action::Reconnect( add, edge ) ) ) ){
+        return false;
+    }
+    if( stamp != 0 ){
+        undoStep step;
+        step.type = add ? undoStep::kind::connection : undoStep::kind::disconnect;
+        step.edge = edge;
+        trail.push_back( step );
+    }
+    return true;
+}
+
+void treeConfig::setDepth( ID id, int depth ){
+    auto it = depths.find( id );
+    int old = it == depths.end() ? -1 : it->second;
+    if( old == depth ){
+        return;
+    }
+    if( stamp != 0 ){
+        undoStep step;
+        step.type = undoStep::kind::depth;
+        step.id = id;
+        step.depth = old;
+        trail.push_back( step );
+    }
+    depths[ id ] = depth;
+}
+
+void treeConfig::setRoot( ID r ){
+    if( r == root ){
+        return;
+    }
+    if( stamp != 0 ){
+        undoStep step;
+        step.type = undoStep::kind::root;
+        step.id = root;
+        trail.push_back( step );
+    }
+    root = r;
 }
 
 joints treeConfig::getFreeArm(){
@@ -216,7 +324,7 @@ joints treeConfig::initArm( ID id, ShoeId side, std::unordered_set< ID >& seen )
 
 std::vector< joints > treeConfig::getFreeArms(){
     std::vector< joints > arms;
-    root = closestMass( config );
+    setRoot( closestMass( config ) );
     makeTree();
     config.computeMatrices();
 
@@ -293,7 +401,7 @@ bool treeConfig::tryConnections(){
             if( arm1 == arm2 )
                 continue;
 
-            treeConfig old = saveState();
+            treeState old = saveState();
             if( connect( arm1, arm2, straight == straightening::always ) ){
                 if( tryConnections() ){
                     return true;
@@ -332,7 +440,7 @@ bool treeConfig::fixConnections( std::vector< joints >& arms ){
         rootArm.emplace_back( rootEdge.side1() == A ? joint{ root, A } : joint{ root, B } );
         rootArm.emplace_back( rootEdge.side1() == A ? joint{ root, B } : joint{ root, A } );
 
-        treeConfig old = saveState();
+        treeState old = saveState();
         if( connect( rootArm, arms.front(), false ) ){
             return tryConnections();
         }
@@ -353,7 +461,7 @@ bool treeConfig::fixConnections( std::vector< joints >& arms ){
         }
 
 
-        treeConfig old = saveState();
+        treeState old = saveState();
         if( connect( rootArm, arms[ other ], false ) ){
             return true;
         }
@@ -361,7 +469,7 @@ bool treeConfig::fixConnections( std::vector< joints >& arms ){
         return false;
     };
 
-    treeConfig old = saveState();
+    treeState old = saveState();
     if( connectTwo( 0 ) ){
         return tryConnections();
     }
@@ -401,17 +509,16 @@ bool treeConfig::connect( joints arm1, joints arm2, bool straighten ){
         // }
     }
 
-    Configuration oldConfig = link( arm1, arm2 );
+    treeState beforeLink = saveState();
+    Matrix target = link( arm1, arm2 );
 
     if( !config.connected() ){
-        config = oldConfig;
+        resetState( beforeLink );
         waitingConnections.clear();
         waitingDisconnects.clear();
         return false;
     }
 
-    Matrix target = oldConfig.getMatrices().at( arm1.back().id ).at( arm1.back().side );
-
     bool result = fabrik( arm1, target );
 
     if( straight == straightening::onCollision ){
@@ -435,10 +542,10 @@ bool treeConfig::connect( joints arm1, joints arm2, bool straighten ){
     if( result ){
         if( newDisconnect != invalidEdge ){
             for( const auto& waiting : waitingDisconnects ){
-                config.execute( Action( Action::Reconnect( true, waiting.edge ) ) );
+                reconnect( true, waiting.edge );
             }
             waitingDisconnects.clear();
-            config.execute( Action( Action::Reconnect( false, newDisconnect ) ) );
+            reconnect( false, newDisconnect );
             waitingDisconnects.push_back( setDisconnect( newDisconnect ) );
         }
         for( auto [ id, side ] : arm1 ){
@@ -457,7 +564,7 @@ bool treeConfig::connect( joints arm1, joints arm2, bool straighten ){
         if( straighten )
             straightenArm( arm1 );
     } else {
-        config = oldConfig;
+        resetState( beforeLink );
         waitingConnections.clear();
         waitingDisconnects.clear();
     }
@@ -505,8 +612,7 @@ void treeConfig::extend( joints& arm1, joints& arm2 ){
     }
 }
 
-Configuration treeConfig::link( joints& arm1, joints& arm2 ){
-    Configuration oldConfig = config;
+Matrix treeConfig::link( joints& arm1, joints& arm2 ){
     Edge newEdge = {
         arm1.back().id,
         arm1.back().side,
@@ -523,7 +629,7 @@ Configuration treeConfig::link( joints& arm1, joints& arm2 ){
     while( i != -1 ){
         arm1.push_back( arm2.back() );
         if( arm1.back().id != arm1[ arm1.size() - 2 ].id ){
-            depths[ arm1.back().id ] = depths[ arm1[ arm1.size() - 2 ].id ] + 1;
+            setDepth( arm1.back().id, depths[ arm1[ arm1.size() - 2 ].id ] + 1 );
         }
         if( i != 0 && arm2[ i ].id != arm2[ i - 1 ].id ){
             Edge current = edgeBetween( arm2[ i ], arm2[ i - 1 ] );
@@ -537,15 +643,18 @@ Configuration treeConfig::link( joints& arm1, joints& arm2 ){
         --i;
     }
 
-    config.execute( Action( Action::Reconnect( false, toDisconnect ) ) );
+    // Only the edges change, so the matrices are still the original ones
+    Matrix oldEnd = config.getMatrices().at( arm1.back().id ).at( arm1.back().side );
+
+    reconnect( false, toDisconnect );
     waitingDisconnects.emplace_back( setDisconnect( toDisconnect ) );
 
-    config.execute( Action( Action::Reconnect( true, newEdge ) ) );
+    reconnect( true, newEdge );
     waitingConnections.emplace_back( setConnection( newEdge ) );
 
     config.setFixed( root, A, identity );
     config.computeMatrices();
-    return oldConfig;
+    return oldEnd;
 }
 
 bool treeConfig::fabrik( const joints& arm, const Matrix& target ){
@@ -790,6 +899,11 @@ void treeConfig::rotateJoints( const joints& arm, size_t currentJoint, Configura
         az += 360;
     }
 
+    if( &currentConfig == &config ){
+        logJoint( arm[ currentJoint ].id, arm[ currentJoint ].side == A ? Alpha : Beta );
+        logJoint( arm[ currentJoint ].id, Gamma );
+    }
+
     if( arm[ currentJoint ].side == A ){
         double cur = currentConfig.getModule( arm[ currentJoint ].id ).getJoint( Alpha );
         pol = std::clamp( pol , -90.0 - cur, 90.0 - cur );
@@ -820,6 +934,8 @@ Edge treeConfig::edgeBetween( const joint& j1, const joint& j2 ){
 void treeConfig::straightenArm( const joints& arm ){
     for( auto [ id, side ] : arm ){
         Joint j = side == A ? Alpha : Beta;
+        logJoint( id, j );
+        logJoint( id, Gamma );
         config.getModule( id ).setJoint( j, 0 );
         config.getModule( id ).setJoint( Gamma, 0 );
         reconfigurationSteps.emplace_back( setRotation( id, j, 0 ) );
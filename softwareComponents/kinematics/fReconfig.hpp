@@ -6,6 +6,7 @@
 #include <map>
 #include <set>
 #include <memory>
+#include <utility>
 
 #include <legacy/configuration/Configuration.h>
 #include <legacy/configuration/IO.h>
@@ -50,6 +51,28 @@ reconfigurationStep setRotation( ID id, Joint j, double angle );
 reconfigurationStep setConnection( Edge toConnect );
 reconfigurationStep setDisconnect( Edge toDisconnect );
 
+/* Inverse of a single change of the inner state of treeConfig, replayed to roll it back */
+struct undoStep {
+    enum class kind { joint, connection, disconnect, depth, root };
+    kind type = kind::joint;
+    ID id = 0;
+
+    /* Previous angle of the joint */
+    Joint j = Alpha;
+    double angle = 0.0;
+
+    /* Previous depth of the module, -1 if it had none */
+    int depth = -1;
+
+    Edge edge = { 0, A, ZMinus, 0, ZMinus, A, 0 };
+};
+
+/* Saved state of treeConfig - a position in its undo log */
+struct treeState {
+    size_t trail = 0;
+    size_t steps = 0;
+};
+
 enum class collisionStrategy {
     all, none, naive, online
 };
@@ -84,8 +107,21 @@ struct treeConfig {
     size_t max_iterations = 1000;
 
     /* Save and reset inner state on failure */
-    treeConfig saveState();
-    void resetState( const treeConfig& old );
+    treeState saveState();
+    void resetState( const treeState& old );
+
+    /* Undo log of the changes made since the first saved state. Each joint is
+       logged only once between two saves or resets, so long FABRIK runs do
+       not flood the log. */
+    std::vector< undoStep > trail;
+    std::map< std::pair< ID, Joint >, size_t > jointStamps;
+    size_t stamp = 0;
+
+    /* Changes of the inner state recorded in the undo log */
+    void logJoint( ID id, Joint j );
+    bool reconnect( bool add, const Edge& edge );
+    void setDepth( ID id, int depth );
+    void setRoot( ID r );
 
     /* Flags for reconfiguration */
     collisionStrategy collisions;
@@ -129,8 +165,8 @@ struct treeConfig {
     /* Connect arms by linking them and using FABRIK */
     bool connect( joints arm1, joints arm2, bool straighten = true );
 
-    /* Link the two arms, return a copy of the old configuration in case of failure */
-    Configuration link( joints& arm1, joints& arm2 );
+    /* Link the two arms, return the original position of the new end of arm1 */
+    Matrix link( joints& arm1, joints& arm2 );
 
     /* Fabrik itself, takes arm of the configuration and tries to reach target */
     bool fabrik( const joints& arm, const Matrix& target );
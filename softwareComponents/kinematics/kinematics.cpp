@@ -200,7 +200,7 @@ bool kinematic_rofibot::fabrik( const Vector& goal, const Vector& y_frame, const
     auto respects_limit = [&]() {
         Vector normal = cross_product( z_frame, y_frame );
         Vector projected = project( normal, positions.back(), positions[ positions.size() - 2 ] );
-        return equals( projected, positions[ positions.size() - 2 ]);
+        return rofi::configuration::matrices::equals( projected, positions[ positions.size() - 2 ] );
     };
 
     int iterations = 0;
@@ -473,6 +473,196 @@ bool kinematic_rofibot::pseudoinverse( const Vector& goal, const Vector& x_frame
     return true;
 }
 
+bool kinematic_rofibot::dls( const Vector& goal, const Vector& x_frame, const Vector& z_frame,
+                             const chain& arm, int max_iterations, double damping )
+{
+    config.computeMatrices();
+    auto frames = get_frames( arm );
+    if( !frames ){
+        if( opt.verbose ){
+            std::cerr << "The arm is not connected from B to A\n";
+        }
+        return false;
+    }
+
+    std::function< void( const arm_frames& ) > on_step;
+    if( opt.animate ){
+        on_step = [&]( const arm_frames& f ){
+            set_joints( arm, f.joints() );
+            std::cout << IO::toString( config );
+        };
+    }
+    reach_result result = solve_dls( *frames, goal, x_frame, z_frame, max_iterations, damping, on_step );
+
+    set_joints( arm, result.joints );
+    if( opt.verbose ){
+        std::cerr << IO::toString( get_matrix( arm.back(), 1 ) );
+    }
+    return result.reached;
+}
+
+reach_result kinematic_rofibot::solve_dls( arm_frames& frames, const Vector& goal,
+                                           const Vector& x_frame, const Vector& z_frame,
+                                           int max_iterations, double damping,
+                                           const std::function< void( const arm_frames& ) >& on_step )
+{
+    auto direction = []( Vector v ){
+        v[ 3 ] = 0;
+        return v / magnitude( v );
+    };
+    Vector x_goal = direction( x_frame );
+    Vector z_goal = direction( z_frame );
+    Vector y_goal = cross_product( z_goal, x_goal );
+
+    /* Position error, followed by the orientation error as half the sum of
+     * cross products of the current and desired end-effector axes */
+    auto get_error = [&]( const arm_frames& f ){
+        Vector pos = f.end_effector();
+        Vector x_cur = f.b.back() * Vector( { -1, 0, 0, 0 } );
+        Vector z_cur = f.b.back() * Vector( { 0, 0, -1, 0 } );
+        Vector y_cur = cross_product( z_cur, x_cur );
+        Vector rot = cross_product( x_cur, x_goal ) + cross_product( y_cur, y_goal )
+                   + cross_product( z_cur, z_goal );
+        return arma::vec( { goal[ 0 ] - pos[ 0 ], goal[ 1 ] - pos[ 1 ], goal[ 2 ] - pos[ 2 ],
+                            rot[ 0 ] / 2, rot[ 1 ] / 2, rot[ 2 ] / 2 } );
+    };
+
+    reach_result result;
+    auto finish = [&]( const arma::vec& e ){
+        result.position_error = arbitrary_magnitude( { e[ 0 ], e[ 1 ], e[ 2 ] } );
+        result.rotation_error = arbitrary_magnitude( { e[ 3 ], e[ 4 ], e[ 5 ] } );
+        result.reached = result.position_error <= error && result.rotation_error <= error;
+        result.joints = frames.joints();
+        return result.reached;
+    };
+
+    size_t modules = frames.angles.size();
+    arma::vec e = get_error( frames );
+    arma::mat I( 6, 6, arma::fill::eye );
+    std::vector< std::array< double, 3 > > old_angles;
+    while( !finish( e ) ){
+        /* The damping grows when the steps do not lower the error, give up
+         * when it blocks any progress */
+        if( result.iterations == max_iterations || damping > 1e3 ){
+            return result;
+        }
+        ++result.iterations;
+
+        arma::mat j = frames.jacobian();
+        arma::vec step = arma::trans( j ) * arma::solve( j * arma::trans( j ) + damping * damping * I, e );
+        /* Joints at their limits cannot follow the step, solve again without them */
+        bool blocked = false;
+        for( size_t i = 0; i < modules; ++i ){
+            for( size_t k = 0; k < 2; ++k ){
+                double angle = frames.angles[ i ][ k ] + step[ i * 3 + k ];
+                if( angle > M_PI_2 || angle < -M_PI_2 ){
+                    j.col( i * 3 + k ).zeros();
+                    blocked = true;
+                }
+            }
+        }
+        if( blocked ){
+            step = arma::trans( j ) * arma::solve( j * arma::trans( j ) + damping * damping * I, e );
+        }
+
+        old_angles = frames.angles;
+        size_t first = modules;
+        for( size_t i = 0; i < modules; ++i ){
+            auto& angles = frames.angles[ i ];
+            for( size_t k = 0; k < 3; ++k ){
+                double angle = angles[ k ] + step[ i * 3 + k ];
+                if( k == 2 ){
+                    angle = std::remainder( angle, 2 * M_PI );
+                } else {
+                    angle = std::clamp( angle, -M_PI_2, M_PI_2 );
+                }
+                if( angle != angles[ k ] ){
+                    angles[ k ] = angle;
+                    first = std::min( first, i );
+                }
+            }
+        }
+        if( first == modules ){
+            damping *= 2;
+            continue;
+        }
+        frames.update( first );
+
+        arma::vec new_e = get_error( frames );
+        if( arbitrary_magnitude( new_e ) < arbitrary_magnitude( e ) ){
+            e = new_e;
+            damping = std::max( damping / 2, 1e-3 );
+            if( on_step ){
+                on_step( frames );
+            }
+        } else {
+            frames.angles = old_angles;
+            frames.update( first );
+            damping *= 2;
+        }
+    }
+    return result;
+}
+
+Matrix kinematic_rofibot::target_frame( const Vector& goal, std::vector< double > rotation ){
+    return translate( goal ) * rotate( to_rad( rotation[ 0 ] ), X ) *
+                               rotate( to_rad( rotation[ 1 ] ), Y ) *
+                               rotate( to_rad( rotation[ 2 ] ), Z );
+}
+
+std::vector< reach_result > kinematic_rofibot::reach_all( const std::vector< Matrix >& targets,
+                                                          int arm, unsigned threads )
+{
+    std::vector< reach_result > results( targets.size() );
+    config.computeMatrices();
+    auto frames = get_frames( arms[ arm ] );
+    if( !frames ){
+        if( opt.verbose ){
+            std::cerr << "The arm is not connected from B to A\n";
+        }
+        return results;
+    }
+
+    Vector base = get_global( arms[ arm ].front(), 0 );
+    double max_length = arms[ arm ].size() * 2 - 1;
+
+    /* The workers share only the read-only initial frames, each target
+     * starts from its own copy */
+    std::atomic< size_t > next = 0;
+    auto work = [&](){
+        for( size_t i = next++; i < targets.size(); i = next++ ){
+            Vector goal = targets[ i ] * Vector( { 0, 0, 0, 1 } );
+            if( distance( base, goal ) > max_length ){
+                results[ i ].position_error = distance( frames->end_effector(), goal );
+                continue;
+            }
+            arm_frames current = *frames;
+            results[ i ] = solve_dls( current, goal, targets[ i ] * Vector( { 1, 0, 0, 0 } ),
+                                                     targets[ i ] * Vector( { 0, 0, 1, 0 } ) );
+        }
+    };
+
+    if( threads == 0 ){
+        threads = std::max( std::thread::hardware_concurrency(), 1u );
+    }
+    threads = static_cast< unsigned >( std::min< size_t >( threads, targets.size() ) );
+    std::vector< std::thread > workers;
+    for( unsigned i = 1; i < threads; ++i ){
+        workers.emplace_back( work );
+    }
+    work();
+    for( auto& worker : workers ){
+        worker.join();
+    }
+    return results;
+}
+
+void kinematic_rofibot::apply( const reach_result& result, int arm ){
+    if( result.joints.size() == arms[ arm ].size() ){
+        set_joints( arms[ arm ], result.joints );
+    }
+}
+
 /** Helper functions **/
 
 bool kinematic_rofibot::rotate_to( const Vector& end_pos, const Vector& end_goal, int i, Joint joint, bool check_validity, bool round )
@@ -557,6 +747,95 @@ arma::mat kinematic_rofibot::jacobian( const chain& arm ){
     return result;
 }
 
+void kinematic_rofibot::arm_frames::update( size_t from ){
+    for( size_t i = from; i < angles.size(); ++i ){
+        if( i != 0 ){
+            a[ i ] = b[ i - 1 ] * connections[ i - 1 ];
+        }
+        const auto& [ alpha, beta, gamma ] = angles[ i ];
+        b[ i ] = a[ i ] * transformJoint( alpha, beta, gamma );
+    }
+}
+
+arma::mat kinematic_rofibot::arm_frames::jacobian() const {
+    arma::mat result( 6, angles.size() * 3 );
+    Vector origin = { 0, 0, 0, 1 };
+    Vector end = end_effector();
+
+    for( size_t i = 0; i < angles.size(); ++i ){
+        Vector a_pos = a[ i ] * origin;
+        Vector b_pos = b[ i ] * origin;
+        /* Alpha rotates around X of shoe A, beta around X of shoe B in the
+         * negative direction and gamma around Z after the alpha rotation */
+        std::array< std::pair< Vector, Vector >, 3 > axes = { {
+            { a[ i ] * X, a_pos },
+            { -( b[ i ] * X ), b_pos },
+            { a[ i ] * rotate( angles[ i ][ 0 ], X ) * Z, a_pos }
+        } };
+        for( size_t k = 0; k < 3; ++k ){
+            const auto& [ axis, pivot ] = axes[ k ];
+            Vector linear = cross_product( axis, end - pivot );
+            for( int row = 0; row < 3; ++row ){
+                result( row, i * 3 + k ) = linear[ row ];
+                result( row + 3, i * 3 + k ) = axis[ row ];
+            }
+        }
+    }
+    return result;
+}
+
+std::optional< kinematic_rofibot::arm_frames > kinematic_rofibot::get_frames( const chain& arm ){
+    arm_frames frames;
+    for( size_t i = 0; i < arm.size(); ++i ){
+        const Module& module = config.getModule( arm[ i ] );
+        frames.angles.push_back( { to_rad( module.getJoint( Alpha ) ),
+                                   to_rad( module.getJoint( Beta ) ),
+                                   to_rad( module.getJoint( Gamma ) ) } );
+        if( i + 1 == arm.size() ){
+            break;
+        }
+
+        std::optional< Edge > next;
+        for( const auto& edge : config.getEdges( arm[ i ] ) ){
+            if( edge.id2() == arm[ i + 1 ] && edge.side1() == B && edge.side2() == A ){
+                next = edge;
+            }
+        }
+        if( !next ){
+            return std::nullopt;
+        }
+        frames.connections.push_back( transformConnection( next->dock1(), next->ori(), next->dock2() ) );
+    }
+
+    frames.a.resize( arm.size() );
+    frames.b.resize( arm.size() );
+    frames.a[ 0 ] = get_matrix( arm.front(), 0 );
+    frames.update( 0 );
+    return frames;
+}
+
+std::vector< std::array< double, 3 > > kinematic_rofibot::arm_frames::joints() const {
+    std::vector< std::array< double, 3 > > result;
+    for( const auto& [ alpha, beta, gamma ] : angles ){
+        result.push_back( { std::clamp( to_deg( alpha ), -90.0, 90.0 ),
+                            std::clamp( to_deg( beta ), -90.0, 90.0 ),
+                            to_deg( gamma ) } );
+    }
+    return result;
+}
+
+void kinematic_rofibot::set_joints( const chain& arm, const std::vector< std::array< double, 3 > >& joints ){
+    for( size_t i = 0; i < arm.size(); ++i ){
+        for( auto [ k, joint ] : { std::pair{ 0, Alpha }, { 1, Beta }, { 2, Gamma } } ){
+            double current = config.getModule( arm[ i ] ).getJoint( joint );
+            if( joints[ i ][ k ] != current ){
+                config.execute( Action( Action::Rotate( arm[ i ], joint, joints[ i ][ k ] - current ) ) );
+            }
+        }
+    }
+    config.computeMatrices();
+}
+
 /** Connect methods **/
 
 /* discarded */
@@ -617,7 +896,7 @@ bool kinematic_rofibot::connect_fabrik( int a, int b, int max_iterations ){
     return config.execute( Action( Action::Reconnect( true, e ) ) );
 }
 
-bool kinematic_rofibot::connect_pseudoinverse( int a, int b, int max_iterations )
+bool kinematic_rofibot::connect_pseudoinverse( int a, int b, int max_iterations, strategy s )
 {
     config.computeMatrices();
     Configuration new_config = get_config();
@@ -636,7 +915,11 @@ bool kinematic_rofibot::connect_pseudoinverse( int a, int b, int max_iterations
     new_config.execute( Action( Action::Reconnect( true, new_edge ) ) );
 
     kinematic_rofibot dummy( new_config, fixed, opt );
-    dummy.pseudoinverse( goal, { -1, 0, 0, 1 }, { 0, 0, -1, 1 }, dummy.arms[ 0 ] );
+    if( s == strategy::dls ){
+        dummy.dls( goal, { -1, 0, 0, 1 }, { 0, 0, -1, 1 }, dummy.arms[ 0 ] );
+    } else {
+        dummy.pseudoinverse( goal, { -1, 0, 0, 1 }, { 0, 0, -1, 1 }, dummy.arms[ 0 ] );
+    }
     auto modules = dummy.config.getModules();
     for( const auto& [id, m] : modules ){
         for( auto j : { Alpha, Beta, Gamma } ){
@@ -1,6 +1,11 @@
 #include "calculations.hpp"
+#include <array>
+#include <atomic>
 #include <deque>
 #include <cassert>
+#include <functional>
+#include <optional>
+#include <thread>
 #include <math.h>
 
 namespace {
@@ -11,7 +16,7 @@ using target = std::tuple< Vector, Vector, Vector, Vector >;
 
 constexpr double error = 0.01;
 
-enum class strategy { ccd, fabrik, pseudoinverse };
+enum class strategy { ccd, fabrik, pseudoinverse, dls };
 
 struct options {
     bool verbose = false;
@@ -19,6 +24,17 @@ struct options {
     bool random = false;
 };
 
+/* Result of reaching a single target */
+struct reach_result {
+    bool reached = false;
+    int iterations = 0;
+    /* Final distance of the end-effector from the goal and its orientation error */
+    double position_error = 0.0;
+    double rotation_error = 0.0;
+    /* Final alpha, beta and gamma of each module of the arm in degrees */
+    std::vector< std::array< double, 3 > > joints;
+};
+
 class kinematic_rofibot {
 
     Configuration config;
@@ -51,6 +67,9 @@ class kinematic_rofibot {
 
             return pseudoinverse( goal, x_frame, z_frame, arms[ arm ] );
         }
+        if( s == strategy::dls ){
+            return dls( goal, x_frame, z_frame, arms[ arm ] );
+        }
 
         return false;
     }
@@ -84,6 +103,9 @@ class kinematic_rofibot {
 
             return pseudoinverse( goal, x_frame, z_frame, arms[ arm ] );
         }
+        if( s == strategy::dls ){
+            return dls( goal, x_frame, z_frame, arms[ arm ] );
+        }
 
         return false;
     };
@@ -107,12 +129,63 @@ class kinematic_rofibot {
         if( s == strategy::fabrik ){
             return connect_fabrik( a, b, 20 );
         }
-        if( s == strategy::pseudoinverse ){
-            return connect_pseudoinverse( a, b, 20 );
+        if( s == strategy::pseudoinverse || s == strategy::dls ){
+            return connect_pseudoinverse( a, b, 20, s );
         }
         return false;
     };
     
+    /* Frame of the end-effector at goal with the rotation of reach */
+    static Matrix target_frame( const Vector& goal, std::vector< double > rotation = { 0, 0, 0 } );
+
+    /* Reach each of the target frames from the current configuration by the
+     * damped least squares, without changing the configuration. The
+     * transformations of the arm are computed once for all the targets,
+     * which are solved in parallel by the given number of threads (0 for
+     * all the cores). The translation of a frame is the goal, its X and Z
+     * axes are the x_frame and z_frame of the end-effector. */
+    std::vector< reach_result > reach_all( const std::vector< Matrix >& targets, int arm = 0,
+                                           unsigned threads = 0 );
+
+    /* Set the joints of the arm to a result of reach_all */
+    void apply( const reach_result& result, int arm = 0 );
+
+    /* Frames of an arm cached for the damped least squares, so that a step
+     * recomputes only the arm after the first changed joint instead of the
+     * matrices of the whole configuration */
+    struct arm_frames {
+        /* Frames of the A and B shoes of each module */
+        std::vector< Matrix > a, b;
+        /* Transformation from the B shoe of a module to the A shoe of the next one */
+        std::vector< Matrix > connections;
+        /* Alpha, beta and gamma of each module in radians */
+        std::vector< std::array< double, 3 > > angles;
+
+        /* Recompute the frames starting with the module at index `from` */
+        void update( size_t from );
+
+        /* Joint angles in degrees within the limits of the modules */
+        std::vector< std::array< double, 3 > > joints() const;
+
+        /* Analytic Jacobian of the end-effector, columns are alpha, beta
+         * and gamma of each module */
+        arma::mat jacobian() const;
+
+        inline Vector end_effector() const {
+            return b.back() * Vector( { 0, 0, 0, 1 } );
+        }
+    };
+
+    /* Expects the modules of the arm to be connected from B to A */
+    std::optional< arm_frames > get_frames( const chain& arm );
+
+    /* The damped least squares on the frames only, so that it can run on
+     * several targets at once; on_step is called after each accepted step */
+    static reach_result solve_dls( arm_frames& frames, const Vector& goal,
+                                   const Vector& x_frame, const Vector& z_frame,
+                                   int max_iterations = 1000, double damping = 0.1,
+                                   const std::function< void( const arm_frames& ) >& on_step = {} );
+
     const inline Configuration& get_config(){
         return config;
     };
@@ -154,10 +227,19 @@ class kinematic_rofibot {
     bool pseudoinverse( const Vector& goal, const Vector& x_frame, const Vector& z_frame,
                         const chain& arm, int max_iterations = 10000 );
 
-    bool connect_pseudoinverse( int a, int b, int max_iterations = 100 );
+    bool connect_pseudoinverse( int a, int b, int max_iterations = 100,
+                                strategy s = strategy::pseudoinverse );
 
     arma::mat jacobian( const chain& arm );
 
+    /* Set the joints of the arm, in degrees */
+    void set_joints( const chain& arm, const std::vector< std::array< double, 3 > >& joints );
+
+    /** Damped least squares IK algorithm, the damping adapts after each step
+     ** (Levenberg-Marquardt) **/
+    bool dls( const Vector& goal, const Vector& x_frame, const Vector& z_frame,
+              const chain& arm, int max_iterations = 1000, double damping = 0.1 );
+
     /* Generate a random configuration, and take its end-effector as target */
     target random_target( const chain& arm );
 
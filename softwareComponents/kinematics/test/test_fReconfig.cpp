@@ -0,0 +1,100 @@
+#include <catch2/catch.hpp>
+
+#include "fReconfig.hpp"
+
+/* Util */
+
+struct treeSnapshot {
+    Configuration config;
+    std::map< ID, int > depths;
+    ID root;
+    size_t steps;
+};
+
+treeSnapshot snapshot( const treeConfig& tree ){
+    return { tree.config, tree.depths, tree.root, tree.reconfigurationSteps.size() };
+}
+
+void requireRestored( const treeConfig& tree, const treeSnapshot& saved ){
+    CHECK( tree.config == saved.config );
+    CHECK( tree.depths == saved.depths );
+    CHECK( tree.root == saved.root );
+    CHECK( tree.reconfigurationSteps.size() == saved.steps );
+}
+
+void rotate( treeConfig& tree, ID id, Joint j, double angle ){
+    tree.logJoint( id, j );
+    tree.config.getModule( id ).setJoint( j, angle );
+}
+
+/* Chain of three modules connected by their Z connectors */
+Configuration chain(){
+    Configuration c;
+    c.addModule( 0, 0, 0, 1 );
+    c.addModule( 0, 0, 0, 2 );
+    c.addModule( 0, 0, 0, 3 );
+    c.addEdge( { 1, B, ZMinus, North, ZMinus, A, 2 } );
+    c.addEdge( { 2, B, ZMinus, North, ZMinus, A, 3 } );
+    c.computeMatrices();
+    return c;
+}
+
+TEST_CASE( "Undo log restores the saved state" ){
+    treeConfig tree( chain(), 2 );
+    const Edge middle = { 2, B, ZMinus, North, ZMinus, A, 3 };
+    const Edge side = { 1, A, XPlus, North, XMinus, B, 3 };
+    auto original = snapshot( tree );
+    REQUIRE( original.depths.size() == 3 );
+
+    auto outer = tree.saveState();
+    rotate( tree, 1, Alpha, 45 );
+    rotate( tree, 1, Alpha, 90 );
+    rotate( tree, 3, Gamma, -30 );
+    REQUIRE( tree.reconnect( false, middle ) );
+    REQUIRE( tree.reconnect( true, side ) );
+    tree.setRoot( 1 );
+    tree.setDepth( 1, 0 );
+    tree.setDepth( 2, 1 );
+    tree.setDepth( 3, 1 );
+    tree.reconfigurationSteps.push_back( setDisconnect( middle ) );
+    tree.reconfigurationSteps.push_back( setConnection( side ) );
+    REQUIRE( !( tree.config == original.config ) );
+
+    SECTION( "Single reset" ){
+        tree.resetState( outer );
+        requireRestored( tree, original );
+    }
+
+    SECTION( "Nested save and reset" ){
+        auto between = snapshot( tree );
+        auto inner = tree.saveState();
+        // The joint was logged before the save, it has to be logged again
+        rotate( tree, 1, Alpha, -90 );
+        rotate( tree, 2, Beta, 60 );
+        REQUIRE( tree.reconnect( false, side ) );
+        REQUIRE( tree.reconnect( true, middle ) );
+        tree.setRoot( 3 );
+        tree.setDepth( 3, 0 );
+        tree.reconfigurationSteps.push_back( setRotation( 2, Beta, 60 ) );
+
+        tree.resetState( inner );
+        requireRestored( tree, between );
+        CHECK( tree.config.getModule( 1 ).getJoint( Alpha ) == 90 );
+
+        // The state saved before can be reset more than once
+        auto again = tree.saveState();
+        rotate( tree, 1, Alpha, 0 );
+        tree.resetState( again );
+        requireRestored( tree, between );
+
+        tree.resetState( outer );
+        requireRestored( tree, original );
+    }
+
+    SECTION( "Reset without changes" ){
+        tree.resetState( outer );
+        auto empty = tree.saveState();
+        tree.resetState( empty );
+        requireRestored( tree, original );
+    }
+}
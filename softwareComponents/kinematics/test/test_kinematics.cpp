@@ -0,0 +1,154 @@
+#include <catch2/catch.hpp>
+
+#include "kinematics.cpp"
+
+/* Util */
+
+/* Chain of three modules connected by their Z connectors from B to A */
+Configuration arm(){
+    Configuration c;
+    c.addModule( 0, 0, 0, 1 );
+    c.addModule( 0, 0, 0, 2 );
+    c.addModule( 0, 0, 0, 3 );
+    c.addEdge( { 1, B, ZMinus, North, ZMinus, A, 2 } );
+    c.addEdge( { 2, B, ZMinus, North, ZMinus, A, 3 } );
+    c.computeMatrices();
+    return c;
+}
+
+const chain armIds = { 1, 2, 3 };
+
+/* Angles of the arm in radians, away from the joint limits and from
+ * positions where the axes of the joints are aligned */
+const std::vector< std::array< double, 3 > > bent = {
+    { 0.3, -0.4, 0.5 }, { -0.2, 0.6, -0.7 }, { 0.4, 0.1, 0.3 }
+};
+
+kinematic_rofibot::arm_frames bentFrames( kinematic_rofibot& bot ){
+    auto frames = bot.get_frames( armIds );
+    REQUIRE( frames );
+    frames->angles = bent;
+    frames->update( 0 );
+    return *frames;
+}
+
+/* Target of reach_all for the current end-effector of the frames; solve_dls
+ * matches the inverted X and Z axes of the last B shoe */
+Matrix endFrame( const kinematic_rofibot::arm_frames& frames ){
+    return frames.b.back() * rotate( M_PI, Y );
+}
+
+TEST_CASE( "Jacobian of the arm frames" ){
+    kinematic_rofibot bot( arm(), true );
+    auto frames = bentFrames( bot );
+    arma::mat analytic = frames.jacobian();
+    REQUIRE( analytic.n_rows == 6 );
+    REQUIRE( analytic.n_cols == 9 );
+
+    /* Central differences of the end-effector position and of its rotation,
+     * the angular velocity is the skew-symmetric part of dR * R^T */
+    const double h = 1e-6;
+    for( size_t i = 0; i < 3; ++i ){
+        for( size_t k = 0; k < 3; ++k ){
+            auto plus = frames;
+            plus.angles[ i ][ k ] += h;
+            plus.update( i );
+            auto minus = frames;
+            minus.angles[ i ][ k ] -= h;
+            minus.update( i );
+
+            Vector linear = ( plus.end_effector() - minus.end_effector() ) / ( 2 * h );
+            arma::mat33 spin = ( get_rotation( plus.b.back() ) - get_rotation( minus.b.back() ) )
+                             / ( 2 * h ) * get_rotation( frames.b.back() ).t();
+            std::array< double, 6 > numeric = { linear[ 0 ], linear[ 1 ], linear[ 2 ],
+                                                ( spin( 2, 1 ) - spin( 1, 2 ) ) / 2,
+                                                ( spin( 0, 2 ) - spin( 2, 0 ) ) / 2,
+                                                ( spin( 1, 0 ) - spin( 0, 1 ) ) / 2 };
+
+            for( size_t row = 0; row < 6; ++row ){
+                INFO( "module " << i << ", joint " << k << ", row " << row );
+                CHECK( analytic( row, i * 3 + k ) == Approx( numeric[ row ] ).margin( 1e-5 ) );
+            }
+        }
+    }
+}
+
+TEST_CASE( "Damped least squares reaches a reachable target" ){
+    kinematic_rofibot bot( arm(), true );
+    Matrix target = endFrame( bentFrames( bot ) );
+    Vector goal = target * Vector( { 0, 0, 0, 1 } );
+
+    auto frames = bot.get_frames( armIds );
+    REQUIRE( frames );
+    REQUIRE( distance( frames->end_effector(), goal ) > 0.2 );
+
+    auto result = kinematic_rofibot::solve_dls( *frames, goal, target * X, target * Z );
+    CHECK( result.reached );
+    CHECK( result.position_error <= error );
+    CHECK( result.rotation_error <= error );
+    CHECK( result.iterations > 0 );
+    CHECK( distance( frames->end_effector(), goal ) <= error );
+
+    /* The joints of the result put the end-effector of the configuration at
+     * the goal as well */
+    bot.apply( result );
+    auto config = bot.get_config();
+    config.computeMatrices();
+    Vector reached = config.getMatrices().at( 3 ).at( 1 ) * Vector( { 0, 0, 0, 1 } );
+    CHECK( distance( reached, goal ) <= error );
+}
+
+TEST_CASE( "Batched damped least squares" ){
+    kinematic_rofibot bot( arm(), true );
+    const Configuration initial = bot.get_config();
+
+    /* Reachable and unreachable positions, with and without rotation */
+    std::vector< std::pair< Vector, std::vector< double > > > goals;
+    for( double x : { -1.0, 0.0, 1.5 } ){
+        for( double z : { 1.0, 2.0, 6.0 } ){
+            goals.push_back( { { x, 0.5, z, 1 }, { 0, 0, 0 } } );
+            goals.push_back( { { x, -0.5, z, 1 }, { 90, 0, 45 } } );
+        }
+    }
+    goals.push_back( { endFrame( bentFrames( bot ) ) * Vector( { 0, 0, 0, 1 } ), { 0, 0, 0 } } );
+
+    std::vector< Matrix > targets;
+    for( const auto& [ goal, rotation ] : goals ){
+        targets.push_back( kinematic_rofibot::target_frame( goal, rotation ) );
+    }
+
+    auto threads = GENERATE( 1u, 3u, 8u );
+    auto results = bot.reach_all( targets, 0, threads );
+    REQUIRE( results.size() == targets.size() );
+    CHECK( bot.get_config() == initial );
+
+    /* Each result is what dls reaches from the initial configuration */
+    int reached = 0;
+    for( size_t i = 0; i < goals.size(); ++i ){
+        INFO( "target " << i << ", " << threads << " threads" );
+        bot.reset( initial );
+        bool single = bot.reach( goals[ i ].first, goals[ i ].second, strategy::dls );
+        CHECK( results[ i ].reached == single );
+        reached += single;
+        if( results[ i ].joints.empty() ){
+            CHECK( bot.get_config() == initial );
+            continue;
+        }
+        REQUIRE( results[ i ].joints.size() == armIds.size() );
+        for( size_t m = 0; m < armIds.size(); ++m ){
+            const Module& module = bot.get_config().getModule( armIds[ m ] );
+            CHECK( results[ i ].joints[ m ][ 0 ] == Approx( module.getJoint( Alpha ) ).margin( 1e-6 ) );
+            CHECK( results[ i ].joints[ m ][ 1 ] == Approx( module.getJoint( Beta ) ).margin( 1e-6 ) );
+            CHECK( results[ i ].joints[ m ][ 2 ] == Approx( module.getJoint( Gamma ) ).margin( 1e-6 ) );
+        }
+    }
+    CHECK( reached > 0 );
+    CHECK( reached < static_cast< int >( goals.size() ) );
+
+    /* apply sets the joints that dls would have set */
+    bot.reset( initial );
+    bot.apply( results.back() );
+    CHECK( results.back().reached );
+    Vector end = bot.get_config().getMatrices().at( 3 ).at( 1 ) * Vector( { 0, 0, 0, 1 } );
+    CHECK( distance( end, goals.back().first ) <= error );
+}
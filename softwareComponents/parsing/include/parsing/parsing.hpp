@@ -1,8 +1,12 @@
 #pragma once
 
+#include <cctype>
 #include <istream>
+#include <optional>
 #include <ostream>
 #include <span>
+#include <string>
+#include <variant>
 #include <vector>
 
 #include <atoms/result.hpp>
@@ -24,6 +28,112 @@ namespace detail
         ostr.width( 4 );
         ostr << json << std::endl;
     }
+
+    /**
+     * @brief Splits a top-level json array read from a stream into its elements
+     * without parsing the whole array.
+     */
+    class JsonArrayReader {
+    public:
+        explicit JsonArrayReader( std::istream & istr ) : _istr( istr ) {}
+
+        /**
+         * @brief Reads the text of the next element of the array.
+         * Returns an error if the input is not a json array.
+         * @returns the element text or `std::nullopt` at the end of the array
+         */
+        auto next() -> atoms::Result< std::optional< std::string > >
+        {
+            using namespace std::string_literals;
+            if ( _finished ) {
+                return atoms::result_value( std::optional< std::string >() );
+            }
+            if ( !_started ) {
+                _started = true;
+                if ( _skipWhitespace() != '[' ) {
+                    return atoms::result_error( "Expected an array of rofi worlds"s );
+                }
+                _istr.get();
+                if ( _skipWhitespace() == ']' ) {
+                    _istr.get();
+                    _finished = true;
+                    return atoms::result_value( std::optional< std::string >() );
+                }
+            }
+
+            auto first = _skipWhitespace();
+            if ( first == ',' || first == ']' || first == '}' ) {
+                return atoms::result_error( "Expected a value in json array"s );
+            }
+            auto element = _readValue();
+            if ( !element ) {
+                return atoms::result_error( "Unexpected end of json array"s );
+            }
+
+            _skipWhitespace();
+            auto separator = _istr.get();
+            if ( separator == ']' ) {
+                _finished = true;
+            } else if ( separator != ',' ) {
+                return atoms::result_error( "Expected ',' or ']' in json array"s );
+            }
+            return atoms::result_value( std::move( element ) );
+        }
+
+    private:
+        int _skipWhitespace()
+        {
+            while ( std::isspace( _istr.peek() ) ) {
+                _istr.get();
+            }
+            return _istr.peek();
+        }
+
+        // Reads a single value, keeping track of nesting outside of strings;
+        // fails at the end of the stream or at an unmatched closing bracket
+        std::optional< std::string > _readValue()
+        {
+            std::string result;
+            int depth = 0;
+            bool inString = false;
+            bool escaped = false;
+            while ( true ) {
+                int c = _istr.peek();
+                if ( c == std::istream::traits_type::eof() ) {
+                    return std::nullopt;
+                }
+                if ( !inString && depth == 0 && !result.empty()
+                     && ( c == ',' || c == ']' || std::isspace( c ) ) ) {
+                    return result;
+                }
+                result.push_back( char( _istr.get() ) );
+                if ( inString ) {
+                    if ( escaped ) {
+                        escaped = false;
+                    } else if ( c == '\\' ) {
+                        escaped = true;
+                    } else if ( c == '"' ) {
+                        inString = false;
+                    }
+                } else if ( c == '"' ) {
+                    inString = true;
+                } else if ( c == '{' || c == '[' ) {
+                    depth++;
+                } else if ( c == '}' || c == ']' ) {
+                    if ( depth == 0 ) {
+                        return std::nullopt;
+                    }
+                    if ( --depth == 0 ) {
+                        return result;
+                    }
+                }
+            }
+        }
+
+        std::istream & _istr;
+        bool _started = false;
+        bool _finished = false;
+    };
 } // namespace detail
 
 
@@ -31,6 +141,7 @@ enum class RofiWorldFormat {
     Old = -1,
     Json,
     Voxel,
+    Binary,
 };
 
 inline auto operator<<( std::ostream & ostr, RofiWorldFormat worldFormat ) -> std::ostream &
@@ -42,6 +153,8 @@ inline auto operator<<( std::ostream & ostr, RofiWorldFormat worldFormat ) -> st
             return ostr << "json";
         case RofiWorldFormat::Voxel:
             return ostr << "voxel";
+        case RofiWorldFormat::Binary:
+            return ostr << "binary";
     }
     ROFI_UNREACHABLE( "Unknown rofi world format" );
 }
@@ -72,6 +185,8 @@ inline auto parseRofiWorld( std::istream & istr,
                     .and_then( [ & ]( auto && voxelWorld ) {
                         return voxelWorld.toRofiWorld( fixateByOne );
                     } );
+        case RofiWorldFormat::Binary:
+            return parseBinary( istr );
     }
     ROFI_UNREACHABLE( "Unknown rofi world format" );
 }
@@ -107,11 +222,287 @@ inline auto writeRofiWorld( std::ostream & ostr,
             detail::printJson( ostr, *voxelWorld );
             return atoms::result_value( std::monostate() );
         }
+        case RofiWorldFormat::Binary: {
+            rofi::configuration::binary::writeBinary( ostr, rofiWorld );
+            return atoms::result_value( std::monostate() );
+        }
     }
     ROFI_UNREACHABLE( "Unknown rofi world format" );
 }
 
 
+/**
+ * @brief Reads a rofi world sequence from an input stream one world at a time,
+ * so that only the current world has to be kept in memory.
+ *
+ * Reading is split into `nextFrame`, which has to be called sequentially,
+ * and `decode`, which can be called concurrently for different frames.
+ * Binary sequences may contain delta frames, so binary worlds are decoded
+ * already by `nextFrame`.
+ */
+class RofiWorldSeqReader {
+public:
+    /**
+     * @brief A world of the sequence that can be decoded independently
+     * of the other worlds.
+     */
+    struct Frame {
+        size_t index;
+        std::variant< std::string, rofi::configuration::RofiWorld > data;
+    };
+
+    RofiWorldSeqReader( std::istream & istr, RofiWorldFormat worldFormat, bool fixateByOne = false )
+            : _worldFormat( worldFormat )
+            , _fixateByOne( fixateByOne )
+            , _jsonArray( istr )
+            , _binary( istr )
+    {}
+
+    /**
+     * @brief Reads the next world of the sequence.
+     * Returns an error if the format is incorrect.
+     * @returns the next rofi world or `std::nullopt` at the end of the sequence
+     */
+    auto next() -> atoms::Result< std::optional< rofi::configuration::RofiWorld > >
+    {
+        return nextFrame().and_then( [ this ]( auto && frame ) -> atoms::Result< OptWorld > {
+            if ( !frame ) {
+                return atoms::result_value( OptWorld() );
+            }
+            return decode( std::move( *frame ) ).transform( []( auto && world ) {
+                return OptWorld( std::move( world ) );
+            } );
+        } );
+    }
+
+    /**
+     * @brief Reads the next world of the sequence without decoding it.
+     * Returns an error if the sequence is malformed.
+     * @returns the next frame or `std::nullopt` at the end of the sequence
+     */
+    auto nextFrame() -> atoms::Result< std::optional< Frame > >
+    {
+        auto frame = _nextFrame();
+        if ( !frame ) {
+            return atoms::result_error( _readError( _index, frame.assume_error() ) );
+        }
+        _index++;
+        return frame;
+    }
+
+    /**
+     * @brief Decodes a frame read by `nextFrame`.
+     * Returns an error if the world is malformed.
+     */
+    auto decode( Frame frame ) const -> atoms::Result< rofi::configuration::RofiWorld >
+    {
+        if ( auto * world = std::get_if< rofi::configuration::RofiWorld >( &frame.data ) ) {
+            return atoms::result_value( std::move( *world ) );
+        }
+        auto world = _decodeText( std::get< std::string >( frame.data ) );
+        if ( !world ) {
+            return atoms::result_error( _readError( frame.index, world.assume_error() ) );
+        }
+        return world;
+    }
+
+private:
+    using OptWorld = std::optional< rofi::configuration::RofiWorld >;
+
+    static auto _readError( size_t index, const std::string & error ) -> std::string
+    {
+        return "Error while reading rofi world " + std::to_string( index ) + ": " + error;
+    }
+
+    auto _nextFrame() -> atoms::Result< std::optional< Frame > >
+    {
+        using namespace std::string_literals;
+        switch ( _worldFormat ) {
+            case RofiWorldFormat::Old:
+                return atoms::result_error( "Parsing old format sequence is not implemented"s );
+            case RofiWorldFormat::Json:
+            case RofiWorldFormat::Voxel:
+                return _jsonArray.next().transform( [ this ]( auto && text ) -> std::optional< Frame > {
+                    if ( !text ) {
+                        return std::nullopt;
+                    }
+                    return Frame{ _index, std::move( *text ) };
+                } );
+            case RofiWorldFormat::Binary:
+                try {
+                    auto world = _binary.next();
+                    if ( !world ) {
+                        return atoms::result_value( std::optional< Frame >() );
+                    }
+                    return atoms::result_value( std::optional( Frame{ _index, std::move( *world ) } ) );
+                } catch ( const std::exception & e ) {
+                    return atoms::result_error( "Error while reading binary rofi world: "s + e.what() );
+                }
+        }
+        ROFI_UNREACHABLE( "Unknown rofi world format" );
+    }
+
+    auto _decodeText( const std::string & text ) const -> atoms::Result< rofi::configuration::RofiWorld >
+    {
+        using namespace std::string_literals;
+        auto json = nlohmann::json();
+        try {
+            json = nlohmann::json::parse( text );
+        } catch ( const nlohmann::json::exception & e ) {
+            return atoms::result_error( "Error while parsing json: "s + e.what() );
+        }
+
+        if ( _worldFormat == RofiWorldFormat::Json ) {
+            return getRofiWorldFromJson( json );
+        }
+        assert( _worldFormat == RofiWorldFormat::Voxel );
+        return getFromJson< rofi::voxel::VoxelWorld >( json ).and_then( [ this ]( auto && voxelWorld ) {
+            return voxelWorld.toRofiWorld( _fixateByOne );
+        } );
+    }
+
+    RofiWorldFormat _worldFormat;
+    bool _fixateByOne;
+    detail::JsonArrayReader _jsonArray;
+    rofi::configuration::binary::SeqReader _binary;
+    size_t _index = 0;
+};
+
+/**
+ * @brief Writes a rofi world sequence to an output stream one world at a time.
+ * Call `finish` after the last world.
+ *
+ * If \p deltaFrames is set, binary sequences store worlds that differ from
+ * the previous one only in joint positions and connections as delta frames.
+ *
+ * Unless `encodesIndependently` is false, worlds can also be encoded
+ * concurrently by `encode` and then written in order by `writeEncoded`.
+ */
+class RofiWorldSeqWriter {
+public:
+    RofiWorldSeqWriter( std::ostream & ostr, RofiWorldFormat worldFormat, bool deltaFrames = true )
+            : _ostr( ostr )
+            , _worldFormat( worldFormat )
+            , _deltaFrames( deltaFrames )
+            , _binary( ostr, deltaFrames )
+    {}
+
+    /**
+     * @brief Writes the next world of the sequence.
+     * Returns an error if the world cannot be written in the format
+     * or if the old format is specified.
+     */
+    auto write( const rofi::configuration::RofiWorld & rofiWorld ) -> atoms::Result< std::monostate >
+    {
+        if ( _worldFormat == RofiWorldFormat::Old ) {
+            return atoms::result_error< std::string >(
+                    "Cannot write rofi world sequence in old format" );
+        }
+        if ( !encodesIndependently() ) {
+            assert( rofiWorld.isPrepared() );
+            assert( rofiWorld.isValid() );
+            _binary.write( rofiWorld );
+            _count++;
+            return atoms::result_value( std::monostate() );
+        }
+
+        auto encoded = encode( rofiWorld );
+        if ( !encoded ) {
+            return atoms::result_error( "Error converting rofi world " + std::to_string( _count )
+                                        + ": " + encoded.assume_error() );
+        }
+        writeEncoded( *encoded );
+        return atoms::result_value( std::monostate() );
+    }
+
+    /**
+     * @brief Returns whether a world can be encoded without knowing
+     * the previous worlds, which is not the case for binary delta frames.
+     */
+    bool encodesIndependently() const
+    {
+        return _worldFormat != RofiWorldFormat::Binary || !_deltaFrames;
+    }
+
+    /**
+     * @brief Encodes \p rofiWorld as an element of the sequence.
+     * Can be called concurrently, write the result by `writeEncoded`.
+     * Returns an error if the world cannot be written in the format
+     * or if the old format is specified.
+     */
+    auto encode( const rofi::configuration::RofiWorld & rofiWorld ) const
+            -> atoms::Result< std::string >
+    {
+        assert( encodesIndependently() );
+        assert( rofiWorld.isPrepared() );
+        assert( rofiWorld.isValid() );
+
+        switch ( _worldFormat ) {
+            case RofiWorldFormat::Old:
+                return atoms::result_error< std::string >(
+                        "Cannot write rofi world sequence in old format" );
+            case RofiWorldFormat::Json:
+                return atoms::result_value(
+                        _encodeJson( rofi::configuration::serialization::toJSON( rofiWorld ) ) );
+            case RofiWorldFormat::Voxel:
+                return rofi::voxel::VoxelWorld::fromRofiWorld( rofiWorld ).transform(
+                        []( auto && voxelWorld ) { return _encodeJson( voxelWorld ); } );
+            case RofiWorldFormat::Binary: {
+                auto data = rofi::configuration::binary::toBinary( rofiWorld );
+                return atoms::result_value(
+                        std::string( reinterpret_cast< const char * >( data.data() ), data.size() ) );
+            }
+        }
+        ROFI_UNREACHABLE( "Unknown rofi world format" );
+    }
+
+    /**
+     * @brief Writes the next world of the sequence encoded by `encode`.
+     */
+    void writeEncoded( const std::string & encoded )
+    {
+        assert( encodesIndependently() );
+        if ( _worldFormat == RofiWorldFormat::Binary ) {
+            _ostr.write( encoded.data(), std::streamsize( encoded.size() ) );
+        } else {
+            _ostr << ( _count == 0 ? "[\n    " : ",\n    " ) << encoded;
+        }
+        _count++;
+    }
+
+    /**
+     * @brief Finishes the sequence.
+     */
+    void finish()
+    {
+        if ( _worldFormat == RofiWorldFormat::Json || _worldFormat == RofiWorldFormat::Voxel ) {
+            _ostr << ( _count == 0 ? "[]" : "\n]" ) << std::endl;
+        }
+    }
+
+private:
+    // Together with the separators written by `writeEncoded` produces the same
+    // output as printing the whole array by `detail::printJson`
+    static auto _encodeJson( const nlohmann::json & json ) -> std::string
+    {
+        auto result = std::string();
+        for ( char c : json.dump( 4 ) ) {
+            result.push_back( c );
+            if ( c == '\n' ) {
+                result += "    ";
+            }
+        }
+        return result;
+    }
+
+    std::ostream & _ostr;
+    RofiWorldFormat _worldFormat;
+    bool _deltaFrames;
+    rofi::configuration::binary::SeqWriter _binary;
+    size_t _count = 0;
+};
+
+
 /**
  * @brief Parses rofi world sequence from given \p istr .
  * Parses the input according to \p worldFormat .
@@ -125,23 +516,18 @@ inline auto parseRofiWorldSeq( std::istream & istr,
                                bool fixateByOne = false )
         -> atoms::Result< std::vector< rofi::configuration::RofiWorld > >
 {
-    switch ( worldFormat ) {
-        case RofiWorldFormat::Old:
-            return atoms::result_error< std::string >(
-                    "Parsing old format sequence is not implemented" );
-        case RofiWorldFormat::Json:
-            return parseJson( istr ).and_then( getRofiWorldSeqFromJson );
-        case RofiWorldFormat::Voxel: {
-            return parseJson( istr )
-                    .and_then( getFromJson< std::vector< rofi::voxel::VoxelWorld > > )
-                    .and_then( [ & ]( std::span< const rofi::voxel::VoxelWorld > voxelWorldSeq ) {
-                        return convertToRofiWorldSeq( voxelWorldSeq, [ & ]( auto && voxelWorld ) {
-                            return voxelWorld.toRofiWorld( fixateByOne );
-                        } );
-                    } );
+    auto reader = RofiWorldSeqReader( istr, worldFormat, fixateByOne );
+    auto result = std::vector< rofi::configuration::RofiWorld >();
+    while ( true ) {
+        auto rofiWorld = reader.next();
+        if ( !rofiWorld ) {
+            return rofiWorld.assume_error_result();
         }
+        if ( !*rofiWorld ) {
+            return atoms::result_value( std::move( result ) );
+        }
+        result.push_back( std::move( **rofiWorld ) );
     }
-    ROFI_UNREACHABLE( "Unknown rofi world format" );
 }
 
 /**
@@ -157,32 +543,19 @@ inline auto writeRofiWorldSeq( std::ostream & ostr,
                                std::span< const rofi::configuration::RofiWorld > rofiWorldSeq,
                                RofiWorldFormat worldFormat ) -> atoms::Result< std::monostate >
 {
-#ifndef NDEBUG
-    for ( const auto & rofiWorld : rofiWorldSeq ) {
-        assert( rofiWorld.isPrepared() );
-        assert( rofiWorld.isValid() );
+    if ( worldFormat == RofiWorldFormat::Old ) {
+        return atoms::result_error< std::string >(
+                "Cannot write rofi world sequence in old format" );
     }
-#endif
 
-    switch ( worldFormat ) {
-        case RofiWorldFormat::Old:
-            return atoms::result_error< std::string >(
-                    "Cannot write rofi world sequence in old format" );
-        case RofiWorldFormat::Json: {
-            detail::printJson( ostr, convertRofiWorldSeqToJson( rofiWorldSeq ) );
-            return atoms::result_value( std::monostate() );
-        }
-        case RofiWorldFormat::Voxel: {
-            auto voxelWorldSeq = convertFromRofiWorldSeq( rofiWorldSeq,
-                                                          rofi::voxel::VoxelWorld::fromRofiWorld );
-            if ( !voxelWorldSeq ) {
-                return voxelWorldSeq.assume_error_result();
-            }
-            detail::printJson( ostr, *voxelWorldSeq );
-            return atoms::result_value( std::monostate() );
+    auto writer = RofiWorldSeqWriter( ostr, worldFormat );
+    for ( const auto & rofiWorld : rofiWorldSeq ) {
+        if ( auto result = writer.write( rofiWorld ); !result ) {
+            return result;
         }
     }
-    ROFI_UNREACHABLE( "Unknown rofi world format" );
+    writer.finish();
+    return atoms::result_value( std::monostate() );
 }
 
 } // namespace rofi::parsing
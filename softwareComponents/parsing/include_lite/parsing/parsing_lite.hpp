@@ -6,6 +6,7 @@
 #include <vector>
 
 #include <atoms/result.hpp>
+#include <configuration/binary.hpp>
 #include <configuration/rofiworld.hpp>
 #include <configuration/serialization.hpp>
 #include <configuration/universalModule.hpp>
@@ -257,6 +258,51 @@ inline auto convertRofiWorldSeqToJson(
 }
 
 
+/**
+ * @brief Calls `rofi::configuration::binary::readBinary`,
+ * but returns `atoms::Result` instead of throwing.
+ * Returns an error if reading throws an exception.
+ * @param istr input stream containing the binary rofi world
+ * @returns the parsed rofi world
+ */
+inline auto parseBinary( std::istream & istr ) -> atoms::Result< rofi::configuration::RofiWorld >
+{
+    using namespace std::string_literals;
+    try {
+        return atoms::result_value( rofi::configuration::binary::readBinary( istr ) );
+    } catch ( const std::exception & e ) {
+        return atoms::result_error( "Error while reading binary rofi world: "s + e.what() );
+    }
+}
+
+/**
+ * @brief Parses binary rofi worlds stored one after another until the end of \p istr .
+ * The worlds may be stored as delta frames.
+ * Returns an error if reading any of the worlds throws an exception.
+ * @param istr input stream containing the binary rofi world sequence
+ * @returns the parsed rofi world sequence
+ */
+inline auto parseBinarySeq( std::istream & istr )
+        -> atoms::Result< std::vector< rofi::configuration::RofiWorld > >
+{
+    auto reader = rofi::configuration::binary::SeqReader( istr );
+    auto result = std::vector< rofi::configuration::RofiWorld >();
+    while ( true ) {
+        try {
+            auto rofiWorld = reader.next();
+            if ( !rofiWorld ) {
+                break;
+            }
+            result.push_back( std::move( *rofiWorld ) );
+        } catch ( const std::exception & e ) {
+            return atoms::result_error( "Error while reading binary rofi world "
+                                        + std::to_string( result.size() ) + ": " + e.what() );
+        }
+    }
+    return atoms::result_value( std::move( result ) );
+}
+
+
 /**
  * @brief Parses rofi world from given \p istr .
  * Assumes that the input is in old (Viki) format.
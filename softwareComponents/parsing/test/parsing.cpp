@@ -0,0 +1,159 @@
+#include "parsing/parsing.hpp"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+
+namespace
+{
+using namespace rofi::configuration;
+using namespace rofi::configuration::matrices;
+using rofi::parsing::RofiWorldFormat;
+using rofi::parsing::detail::JsonArrayReader;
+
+// Reads all elements of the array, the number of calls is bounded so that
+// a reader that stops advancing fails instead of hanging
+auto readElements( const std::string & text ) -> atoms::Result< std::vector< std::string > >
+{
+    auto istr = std::istringstream( text );
+    auto reader = JsonArrayReader( istr );
+    auto elements = std::vector< std::string >();
+    for ( size_t i = 0; i <= text.size(); i++ ) {
+        auto element = reader.next();
+        if ( !element ) {
+            return element.assume_error_result();
+        }
+        if ( !*element ) {
+            return atoms::result_value( std::move( elements ) );
+        }
+        elements.push_back( std::move( **element ) );
+    }
+    FAIL( "Json array reader does not advance on: " << text );
+    return atoms::result_error< std::string >( "Json array reader does not advance" );
+}
+
+auto world( ModuleId id, Angle alpha, Angle beta, Angle gamma ) -> RofiWorld
+{
+    auto world = RofiWorld();
+    auto & um = world.insert( UniversalModule( id, alpha, beta, gamma ) );
+    connect< RigidJoint >( um.bodies()[ 0 ], { 0, 0, 0 }, identity );
+    REQUIRE( world.prepare() );
+    REQUIRE( world.isValid() );
+    return world;
+}
+
+TEST_CASE( "Json array reader" )
+{
+    SECTION( "Empty array" )
+    {
+        auto text = GENERATE( Catch::Generators::as< std::string >{}, "[]", "  [ \n\t]  ", "\n[\n]\n" );
+        auto elements = readElements( text );
+        REQUIRE( elements );
+        CHECK( elements->empty() );
+    }
+
+    SECTION( "Whitespace and newlines between elements" )
+    {
+        auto elements = readElements( "\n[\n  1 ,\n\t{ \"a\" : [ 1, 2 ] }\n  ,\"s\"\n]\n" );
+        REQUIRE( elements );
+        CHECK( *elements == std::vector< std::string >{ "1", "{ \"a\" : [ 1, 2 ] }", "\"s\"" } );
+    }
+
+    SECTION( "Brackets and braces inside strings" )
+    {
+        auto elements = readElements( R"([ {"a": "]}[{,"}, "x]", ["}"] ])" );
+        REQUIRE( elements );
+        CHECK( *elements == std::vector< std::string >{ R"({"a": "]}[{,"})", R"("x]")", R"(["}"])" } );
+    }
+
+    SECTION( "Escaped quotes and backslashes" )
+    {
+        auto elements = readElements( R"([ "a\"]", "b\\", {"c": "\\\"}"}, "\\" ])" );
+        REQUIRE( elements );
+        REQUIRE( elements->size() == 4 );
+        CHECK( nlohmann::json::parse( ( *elements )[ 0 ] ) == "a\"]" );
+        CHECK( nlohmann::json::parse( ( *elements )[ 1 ] ) == "b\\" );
+        CHECK( nlohmann::json::parse( ( *elements )[ 2 ] )[ "c" ] == "\\\"}" );
+        CHECK( nlohmann::json::parse( ( *elements )[ 3 ] ) == "\\" );
+    }
+
+    SECTION( "Malformed or truncated array" )
+    {
+        auto text = GENERATE( Catch::Generators::as< std::string >{},
+                              "",
+                              "{}",
+                              "]",
+                              "[",
+                              "[1",
+                              "[1,",
+                              "[1,]",
+                              "[1 2]",
+                              "[1,,2]",
+                              "[}]",
+                              "[1}",
+                              "[1,}",
+                              R"([{"a": 1)",
+                              R"([{"a": "]"])",
+                              R"(["abc)",
+                              R"(["a\"])" );
+        INFO( "Input: " << text );
+        CHECK_FALSE( readElements( text ) );
+    }
+}
+
+TEST_CASE( "Rofi world sequence" )
+{
+    auto worlds = std::vector< RofiWorld >{ world( 0, 0_deg, 90_deg, 0_deg ),
+                                            world( 1, 13.5_deg, -42_deg, 33.3_deg ),
+                                            world( 7, -90_deg, 0_deg, 180_deg ) };
+
+    SECTION( "Json output matches printing the whole array" )
+    {
+        auto count = GENERATE( 0, 1, 3 );
+        auto seq = std::span< const RofiWorld >( worlds ).first( count );
+
+        auto array = nlohmann::json::array();
+        for ( const auto & rofiWorld : seq ) {
+            array.push_back( serialization::toJSON( rofiWorld ) );
+        }
+        auto expected = std::ostringstream();
+        rofi::parsing::detail::printJson( expected, array );
+
+        auto actual = std::ostringstream();
+        REQUIRE( rofi::parsing::writeRofiWorldSeq( actual, seq, RofiWorldFormat::Json ) );
+        CHECK( actual.str() == expected.str() );
+
+        auto istr = std::istringstream( actual.str() );
+        auto parsed = rofi::parsing::parseRofiWorldSeq( istr, RofiWorldFormat::Json );
+        REQUIRE( parsed );
+        REQUIRE( parsed->size() == seq.size() );
+        for ( size_t i = 0; i < seq.size(); i++ ) {
+            CHECK( serialization::toJSON( ( *parsed )[ i ] ) == serialization::toJSON( seq[ i ] ) );
+        }
+    }
+
+    SECTION( "Reader reports a truncated sequence" )
+    {
+        auto ostr = std::ostringstream();
+        REQUIRE( rofi::parsing::writeRofiWorldSeq( ostr, worlds, RofiWorldFormat::Json ) );
+        auto text = ostr.str();
+        auto secondEnd = text.find( "},\n    {", text.find( "},\n    {" ) + 1 );
+        REQUIRE( secondEnd != std::string::npos );
+
+        auto istr = std::istringstream( text.substr( 0, secondEnd - 10 ) );
+        auto reader = rofi::parsing::RofiWorldSeqReader( istr, RofiWorldFormat::Json );
+        auto first = reader.next();
+        REQUIRE( first );
+        REQUIRE( *first );
+        CHECK( serialization::toJSON( **first ) == serialization::toJSON( worlds[ 0 ] ) );
+
+        auto second = reader.next();
+        REQUIRE_FALSE( second );
+        CHECK_THAT( second.assume_error(), Catch::Matchers::StartsWith( "Error while reading rofi world 1" ) );
+    }
+}
+
+} // namespace
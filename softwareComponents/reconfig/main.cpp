@@ -30,6 +30,7 @@ void parse(int argc, char* argv[])
             ("a,alg", "Algorithm for reconfiguration: bfs, astar, rrt", cxxopts::value<std::string>())
             ("e,eval", "Evaluation function for A* algorithm: dMatrix, dCenter, dJoint, dAction, trivial", cxxopts::value<std::string>())
             ("p,parallel", "How many parallel actions are allowed: <1,...>", cxxopts::value<unsigned>())
+            ("t,threads", "Threads generating successors, 0 for all hardware threads", cxxopts::value<unsigned>())
             ;
 
     try {
@@ -159,6 +160,15 @@ void parse(int argc, char* argv[])
                 exit(0);
             }
         }
+
+        if (result.count("threads") == 1) {
+            setGeneratorThreads(result["threads"].as<unsigned>());
+        } else {
+            if (result.count("threads") > 1) {
+                std::cerr << "There can be at most one '-t' or '--threads' option.\n";
+                exit(0);
+            }
+        }
     }
     catch (cxxopts::OptionException& e)
     {
@@ -2,6 +2,9 @@
 #include <legacy/configuration/Configuration.h>
 #include <legacy/configuration/Generators.h>
 #include "test_rrt.h"
+#include <random>
+#include <sys/wait.h>
+#include <unistd.h>
 
 TEST_CASE("Connections")
 {
@@ -168,6 +171,42 @@ TEST_CASE("Rotation into overlapping modules")
     REQUIRE(!config.isValid());
 }
 
+TEST_CASE("Incremental collision check agrees with all pairs")
+{
+    const ID moduleCount = 12;
+    Configuration config;
+    for (ID id = 0; id < moduleCount; ++id)
+        config.addModule(0, 0, 0, id);
+    for (ID id = 0; id + 1 < moduleCount; ++id)
+        REQUIRE(config.addEdge({id, B, ZMinus, 0, ZMinus, A, id + 1}));
+    REQUIRE(config.isValid());
+
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<ID> idDist(0, moduleCount - 1);
+    std::uniform_int_distribution<int> jointDist(Alpha, Gamma);
+    int valid = 0;
+    int colliding = 0;
+    for (int i = 0; i < 500; ++i) {
+        Configuration next = config;
+        Action rot(Action::Rotate{idDist(gen), static_cast<Joint>(jointDist(gen)), i % 2 ? 90.0 : -90.0});
+        if (!next.execute(rot) || !next.computeMatrices())
+            continue;
+
+        Configuration incremental = next;
+        bool expected = next.collisionFree(CollisionCheck::AllPairs);
+        REQUIRE(next.collisionFree(CollisionCheck::Grid) == expected);
+        REQUIRE(incremental.collisionFree() == expected);
+        if (expected) {
+            ++valid;
+            config = incremental;
+        } else {
+            ++colliding;
+        }
+    }
+    CHECK(valid > 0);
+    CHECK(colliding > 0);
+}
+
 TEST_CASE("Generate all edges")
 {
     Edge edge(0, A, XPlus, 0, XPlus, A, 1);
@@ -239,6 +278,56 @@ TEST_CASE("Next configurations")
     }
 }
 
+TEST_CASE("Parallel successor generation keeps order")
+{
+    Configuration cfg;
+    cfg.addModule(0,0,0,0);
+    cfg.addModule(0,0,0,1);
+    cfg.addEdge({0, B, ZMinus, 0, ZMinus, A, 1});
+    cfg.computeMatrices();
+
+    std::vector<Configuration> serial;
+    bisimpleNext(cfg, serial, 90);
+    REQUIRE(!serial.empty());
+
+    setGeneratorThreads(4);
+    std::vector<Configuration> parallel;
+    bisimpleNext(cfg, parallel, 90);
+    setGeneratorThreads(1);
+
+    REQUIRE(parallel == serial);
+}
+
+TEST_CASE("Parallel successor generation in a forked child")
+{
+    Configuration cfg;
+    cfg.addModule(0,0,0,0);
+    cfg.addModule(0,0,0,1);
+    cfg.addEdge({0, B, ZMinus, 0, ZMinus, A, 1});
+    cfg.computeMatrices();
+
+    std::vector<Configuration> serial;
+    bisimpleNext(cfg, serial, 90);
+
+    setGeneratorThreads(4);
+    pid_t pid = fork();
+    REQUIRE(pid >= 0);
+    if (pid == 0) {
+        // The inherited pool would wait for its workers forever
+        alarm(10);
+        restartGeneratorThreadsAfterFork();
+        std::vector<Configuration> parallel;
+        bisimpleNext(cfg, parallel, 90);
+        _exit(parallel == serial ? 0 : 1);
+    }
+    setGeneratorThreads(1);
+
+    int status = 0;
+    REQUIRE(waitpid(pid, &status, 0) == pid);
+    REQUIRE(WIFEXITED(status));
+    REQUIRE(WEXITSTATUS(status) == 0);
+}
+
 TEST_CASE("Generate edge")
 {
     std::unordered_map<ID, std::array<bool, 6>> occupied;
@@ -0,0 +1,88 @@
+// Overhead of the Rust voxel reconfiguration binding.
+//
+// Usage: bench-binding_voxel_reconfig [repetitions]
+//
+// Each world is reconfigured to itself, so the search is trivial and the time
+// is dominated by passing the worlds to Rust and back. Compares the json
+// binding with the binding passing flat records.
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "configuration/rofiworld.hpp"
+#include "configuration/universalModule.hpp"
+#include "voxel.hpp"
+#include "voxel_reconfig.hpp"
+
+namespace
+{
+using namespace rofi::configuration;
+
+/**
+ * @brief Builds a straight snake of universal modules
+ */
+auto buildSnake( int moduleCount ) -> rofi::voxel::VoxelWorld
+{
+    auto world = RofiWorld();
+    Module * previous = nullptr;
+    for ( int id = 0; id < moduleCount; id++ ) {
+        auto & um = world.insert( UniversalModule( id, 0_deg, 0_deg, 0_deg ) );
+        if ( previous ) {
+            connect( previous->connectors()[ 5 ], um.connectors()[ 2 ], roficom::Orientation::North );
+        } else {
+            connect< RigidJoint >( um.connectors()[ 0 ], Vector{ 0, 0, 0 }, matrices::identity );
+        }
+        previous = &um;
+    }
+    if ( auto valid = world.validate(); !valid ) {
+        std::cerr << "Invalid snake: " << valid.assume_error() << "\n";
+        std::exit( EXIT_FAILURE );
+    }
+    auto voxelWorld = rofi::voxel::VoxelWorld::fromRofiWorld( world );
+    if ( !voxelWorld ) {
+        std::cerr << "Cannot build snake: " << voxelWorld.assume_error() << "\n";
+        std::exit( EXIT_FAILURE );
+    }
+    return std::move( *voxelWorld );
+}
+
+/**
+ * @brief Returns average milliseconds per call of \p f
+ */
+template < typename F >
+auto measure( int repetitions, F && f ) -> double
+{
+    auto start = std::chrono::steady_clock::now();
+    for ( int i = 0; i != repetitions; i++ ) {
+        if ( !f() ) {
+            std::cerr << "Reconfiguration failed\n";
+            std::exit( EXIT_FAILURE );
+        }
+    }
+    std::chrono::duration< double, std::milli > elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / repetitions;
+}
+
+} // namespace
+
+int main( int argc, char * argv[] )
+{
+    int repetitions = argc > 1 ? std::stoi( argv[ 1 ] ) : 20;
+
+    std::cout << std::left << std::setw( 10 ) << "modules" << std::right << std::setw( 12 )
+              << "json [ms]" << std::setw( 12 ) << "raw [ms]" << "\n";
+    // Voxel positions in Rust are limited to 127
+    for ( int moduleCount : { 1, 8, 32, 63 } ) {
+        auto world = buildSnake( moduleCount );
+        double json = measure( repetitions,
+                               [ & ] { return rofi::voxel::voxel_reconfig_json( world, world ); } );
+        double raw = measure( repetitions,
+                              [ & ] { return rofi::voxel::voxel_reconfig( world, world ); } );
+        std::cout << std::left << std::setw( 10 ) << moduleCount << std::right << std::fixed
+                  << std::setprecision( 3 ) << std::setw( 12 ) << json << std::setw( 12 ) << raw
+                  << "\n";
+    }
+}
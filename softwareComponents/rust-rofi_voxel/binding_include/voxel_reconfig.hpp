@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+#include <functional>
 #include <vector>
 
 #include "atoms/result.hpp"
@@ -7,6 +9,31 @@
 
 namespace rofi::voxel
 {
+/**
+ * @brief Computes the reconfiguration path from \p init to \p goal
+ * by the Rust voxel reconfiguration.
+ * Voxel bodies are passed to Rust and back as flat records.
+ * @returns the sequence of voxel worlds starting with \p init and ending with \p goal
+ */
 auto voxel_reconfig( const rofi::voxel::VoxelWorld & init, const rofi::voxel::VoxelWorld & goal )
         -> atoms::Result< std::vector< rofi::voxel::VoxelWorld > >;
-}
+
+/**
+ * @brief Computes the reconfiguration path from \p init to \p goal
+ * and calls \p onWorld with each world of the path in order
+ * without collecting the whole path.
+ * @returns the number of worlds in the path
+ */
+auto voxel_reconfig_for_each( const rofi::voxel::VoxelWorld & init,
+                              const rofi::voxel::VoxelWorld & goal,
+                              std::function< void( rofi::voxel::VoxelWorld ) > onWorld )
+        -> atoms::Result< std::size_t >;
+
+/**
+ * @brief Same as `voxel_reconfig`, but passes the worlds to Rust and back
+ * serialized to json.
+ */
+auto voxel_reconfig_json( const rofi::voxel::VoxelWorld & init,
+                          const rofi::voxel::VoxelWorld & goal )
+        -> atoms::Result< std::vector< rofi::voxel::VoxelWorld > >;
+} // namespace rofi::voxel
@@ -1,21 +1,138 @@
 #include "voxel_reconfig.hpp"
 
 #include <cstdint>
+#include <exception>
+#include <span>
 
 #include "configuration/serialization.hpp"
 
 
 extern "C"
 {
+// Has to match `CVoxelBody` in `src/cpp_bindings.rs`
+struct VoxelBodyRecord {
+    int32_t pos[ 3 ];
+    uint8_t other_body_axis;
+    bool other_body_is_positive;
+    bool is_shoe_rotated;
+    int8_t joint_pos;
+};
+static_assert( sizeof( VoxelBodyRecord ) == 16 );
+
+using FrameCallback = void ( * )( void * user_data,
+                                  const VoxelBodyRecord * bodies,
+                                  size_t bodies_count );
+
 void rust_free_cstring( int8_t * rust_cstring );
 int8_t * compute_reconfiguration_moves( const char * init_config_json,
                                         const char * goal_config_json );
+intptr_t compute_reconfiguration_moves_raw( const VoxelBodyRecord * init_bodies,
+                                            size_t init_bodies_count,
+                                            const VoxelBodyRecord * goal_bodies,
+                                            size_t goal_bodies_count,
+                                            FrameCallback frame_callback,
+                                            void * user_data );
 }
 
 namespace rofi::voxel
 {
+namespace
+{
+    auto toRecords( const VoxelWorld & world ) -> std::vector< VoxelBodyRecord >
+    {
+        auto result = std::vector< VoxelBodyRecord >();
+        result.reserve( world.bodies.size() );
+        for ( const auto & body : world.bodies ) {
+            result.push_back( VoxelBodyRecord{
+                    .pos = { body.pos[ 0 ], body.pos[ 1 ], body.pos[ 2 ] },
+                    .other_body_axis = uint8_t( fromAxis( body.other_body_dir.axis ) ),
+                    .other_body_is_positive = body.other_body_dir.is_positive,
+                    .is_shoe_rotated = body.is_shoe_rotated,
+                    .joint_pos = jointPositionToInteger( body.joint_pos ) } );
+        }
+        return result;
+    }
+
+    auto fromRecords( std::span< const VoxelBodyRecord > bodies ) -> VoxelWorld
+    {
+        auto result = VoxelWorld();
+        result.bodies.reserve( bodies.size() );
+        for ( const auto & body : bodies ) {
+            auto jointPos = body.joint_pos == 90    ? JointPosition::Plus90
+                            : body.joint_pos == -90 ? JointPosition::Minus90
+                                                    : JointPosition::Zero;
+            result.bodies.push_back(
+                    Voxel{ .pos = { body.pos[ 0 ], body.pos[ 1 ], body.pos[ 2 ] },
+                           .other_body_dir = Direction{ .axis = toAxis( body.other_body_axis ),
+                                                        .is_positive =
+                                                                body.other_body_is_positive },
+                           .is_shoe_rotated = body.is_shoe_rotated,
+                           .joint_pos = jointPos } );
+        }
+        return result;
+    }
+
+    struct FrameCallbackData {
+        std::function< void( VoxelWorld ) > & onWorld;
+        // Exceptions cannot be thrown through Rust
+        std::exception_ptr exception = {};
+    };
+
+    void frameCallback( void * userData, const VoxelBodyRecord * bodies, size_t bodiesCount )
+    {
+        auto & data = *static_cast< FrameCallbackData * >( userData );
+        if ( data.exception ) {
+            return;
+        }
+        try {
+            data.onWorld( fromRecords( std::span( bodies, bodiesCount ) ) );
+        } catch ( ... ) {
+            data.exception = std::current_exception();
+        }
+    }
+} // namespace
+
 auto voxel_reconfig( const rofi::voxel::VoxelWorld & init, const rofi::voxel::VoxelWorld & goal )
         -> atoms::Result< std::vector< rofi::voxel::VoxelWorld > >
+{
+    auto result = std::vector< VoxelWorld >();
+    return voxel_reconfig_for_each( init,
+                                    goal,
+                                    [ &result ]( VoxelWorld world ) {
+                                        result.push_back( std::move( world ) );
+                                    } )
+            .transform( [ &result ]( auto ) { return std::move( result ); } );
+}
+
+auto voxel_reconfig_for_each( const rofi::voxel::VoxelWorld & init,
+                              const rofi::voxel::VoxelWorld & goal,
+                              std::function< void( rofi::voxel::VoxelWorld ) > onWorld )
+        -> atoms::Result< std::size_t >
+{
+    using namespace std::string_literals;
+
+    auto initBodies = toRecords( init );
+    auto goalBodies = toRecords( goal );
+
+    auto data = FrameCallbackData{ .onWorld = onWorld };
+    auto worldsCount = compute_reconfiguration_moves_raw( initBodies.data(),
+                                                          initBodies.size(),
+                                                          goalBodies.data(),
+                                                          goalBodies.size(),
+                                                          frameCallback,
+                                                          &data );
+    if ( data.exception ) {
+        std::rethrow_exception( data.exception );
+    }
+    if ( worldsCount < 0 ) {
+        return atoms::result_error( "Error inside Rust voxel reconfiguration (see stderr)"s );
+    }
+    return atoms::result_value( std::size_t( worldsCount ) );
+}
+
+auto voxel_reconfig_json( const rofi::voxel::VoxelWorld & init,
+                          const rofi::voxel::VoxelWorld & goal )
+        -> atoms::Result< std::vector< rofi::voxel::VoxelWorld > >
 {
     using namespace std::string_literals;
     namespace serialization = rofi::configuration::serialization;
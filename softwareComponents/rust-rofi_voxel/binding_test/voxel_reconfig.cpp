@@ -86,3 +86,38 @@ TEST_CASE( "One move" )
         CHECK( result->size() == 2 );
     }
 }
+
+TEST_CASE( "Json and raw bindings agree" )
+{
+    auto initWorld = RofiWorld();
+    auto & initUm = initWorld.insert( UniversalModule( 1, 0_deg, 0_deg, 0_deg ) );
+    connect< RigidJoint >( initUm.connectors()[ 0 ], Vector{ 0, 0, 0 }, matrices::identity );
+    REQUIRE( initWorld.validate() );
+    auto initVoxelWorld = rofi::voxel::VoxelWorld::fromRofiWorld( initWorld );
+    REQUIRE( initVoxelWorld );
+
+    auto goalWorld = RofiWorld();
+    auto & goalUm = goalWorld.insert( UniversalModule( 1, 0_deg, 0_deg, 0_deg ) );
+    connect< RigidJoint >( goalUm.connectors()[ 0 ], Vector{ 0, 0, 0 }, matrices::identity );
+    goalUm.setBeta( 90_deg );
+    REQUIRE( goalWorld.validate() );
+    auto goalVoxelWorld = rofi::voxel::VoxelWorld::fromRofiWorld( goalWorld );
+    REQUIRE( goalVoxelWorld );
+
+    auto jsonResult = rofi::voxel::voxel_reconfig_json( *initVoxelWorld, *goalVoxelWorld );
+    REQUIRE( jsonResult );
+    auto rawResult = rofi::voxel::voxel_reconfig( *initVoxelWorld, *goalVoxelWorld );
+    REQUIRE( rawResult );
+    CHECK( nlohmann::json( *rawResult ) == nlohmann::json( *jsonResult ) );
+
+    size_t visited = 0;
+    auto count = rofi::voxel::voxel_reconfig_for_each( *initVoxelWorld,
+                                                       *goalVoxelWorld,
+                                                       [ & ]( rofi::voxel::VoxelWorld world ) {
+                                                           CHECK( world.bodies.size() == 2 );
+                                                           visited++;
+                                                       } );
+    REQUIRE( count );
+    CHECK( *count == rawResult->size() );
+    CHECK( visited == rawResult->size() );
+}
@@ -0,0 +1,151 @@
+use crate::atoms::{Axis, Direction};
+use crate::pos::{RelativeIndexType, RelativeVoxelPos};
+use crate::reconfiguration;
+use crate::voxel::body::JointPosition;
+use crate::voxel::{VoxelBody, VoxelBodyWithPos};
+use crate::voxel_world::VoxelWorld;
+use std::os::raw::c_void;
+
+/// Voxel body passed across the C ABI without serialization
+///
+/// Has to match `VoxelBodyRecord` in `binding_src/voxel_reconfig_binding.cpp`.
+#[repr(C)]
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct CVoxelBody {
+    pub pos: [i32; 3],
+    pub other_body_axis: u8,
+    pub other_body_is_positive: bool,
+    pub is_shoe_rotated: bool,
+    pub joint_pos: i8,
+}
+static_assertions::assert_eq_size!(CVoxelBody, [u8; 16]);
+
+/// Called with bodies of each world of the reconfiguration path in order
+pub type FrameCallback =
+    unsafe extern "C" fn(user_data: *mut c_void, bodies: *const CVoxelBody, bodies_count: usize);
+
+fn body_from_c(body: CVoxelBody) -> Result<(VoxelBody, RelativeVoxelPos), String> {
+    let axis = match body.other_body_axis {
+        0 => Axis::X,
+        1 => Axis::Y,
+        2 => Axis::Z,
+        axis => return Err(format!("Axis {axis} is not valid")),
+    };
+    let joint_pos = match body.joint_pos {
+        0 => JointPosition::Zero,
+        90 => JointPosition::Plus90,
+        -90 => JointPosition::Minus90,
+        joint_pos => return Err(format!("Shoe joint pos {joint_pos} is not valid")),
+    };
+    let mut pos = [0; 3];
+    for (pos_i, &body_pos_i) in pos.iter_mut().zip(&body.pos) {
+        *pos_i = RelativeIndexType::try_from(body_pos_i)
+            .map_err(|_| format!("Voxel position {:?} is out of range", body.pos))?;
+    }
+
+    Ok((
+        VoxelBody::new_with(
+            Direction::new_with(axis, body.other_body_is_positive),
+            body.is_shoe_rotated,
+            joint_pos,
+        ),
+        RelativeVoxelPos(pos),
+    ))
+}
+
+fn body_to_c((body, pos): VoxelBodyWithPos) -> CVoxelBody {
+    CVoxelBody {
+        pos: pos.0.map(i32::from),
+        other_body_axis: body.other_body_dir().axis().as_index() as u8,
+        other_body_is_positive: body.other_body_dir().is_positive(),
+        is_shoe_rotated: body.is_shoe_rotated(),
+        joint_pos: match body.joint_pos() {
+            JointPosition::Zero => 0,
+            JointPosition::Plus90 => 90,
+            JointPosition::Minus90 => -90,
+        },
+    }
+}
+
+unsafe fn slice_from_raw<'a>(bodies: *const CVoxelBody, bodies_count: usize) -> &'a [CVoxelBody] {
+    if bodies_count == 0 {
+        return &[];
+    }
+    std::slice::from_raw_parts(bodies, bodies_count)
+}
+
+/// Returns the number of worlds in the reconfiguration path or -1 on error
+#[no_mangle]
+#[allow(clippy::missing_safety_doc)]
+unsafe extern "C" fn compute_reconfiguration_moves_raw(
+    init_bodies: *const CVoxelBody,
+    init_bodies_count: usize,
+    goal_bodies: *const CVoxelBody,
+    goal_bodies_count: usize,
+    frame_callback: FrameCallback,
+    user_data: *mut c_void,
+) -> isize {
+    let init = slice_from_raw(init_bodies, init_bodies_count);
+    let goal = slice_from_raw(goal_bodies, goal_bodies_count);
+
+    let result = voxel_reconfiguration_raw_impl(init, goal, |bodies| {
+        frame_callback(user_data, bodies.as_ptr(), bodies.len())
+    });
+    match result {
+        Ok(frames_count) => frames_count as isize,
+        Err(err) => {
+            eprintln!("Encountered error while reconfiguration: {}", err);
+            -1
+        }
+    }
+}
+
+fn voxel_reconfiguration_raw_impl(
+    init: &[CVoxelBody],
+    goal: &[CVoxelBody],
+    mut on_frame: impl FnMut(&[CVoxelBody]),
+) -> Result<usize, String> {
+    let init = init.iter().copied().map(body_from_c).collect::<Result<Vec<_>, _>>()?;
+    let goal = goal.iter().copied().map(body_from_c).collect::<Result<Vec<_>, _>>()?;
+
+    let (init, _min_pos) =
+        VoxelWorld::from_bodies_rel_pos(init.iter().copied()).map_err(|err| err.to_string())?;
+    let (goal, _min_pos) =
+        VoxelWorld::from_bodies_rel_pos(goal.iter().copied()).map_err(|err| err.to_string())?;
+
+    let reconfig_sequence = reconfiguration::compute_reconfiguration_moves(&init, goal)
+        .map_err(|err| err.to_string())?;
+
+    // Reuse the buffer, the callee copies the bodies it needs
+    let mut frame = Vec::new();
+    for world in &reconfig_sequence {
+        frame.clear();
+        frame.extend(world.all_bodies().map(body_to_c));
+        on_frame(&frame);
+    }
+    Ok(reconfig_sequence.len())
+}
+
+#[cfg(test)]
+mod test {
+    use super::*;
+    use crate::pos::VoxelPos;
+
+    #[test]
+    fn test_body_conversion() {
+        let body = CVoxelBody {
+            pos: [1, 0, 2],
+            other_body_axis: 2,
+            other_body_is_positive: false,
+            is_shoe_rotated: true,
+            joint_pos: -90,
+        };
+        let (voxel_body, RelativeVoxelPos(pos)) = body_from_c(body).unwrap();
+        let pos = VoxelPos(pos.map(|pos| u8::try_from(pos).unwrap()));
+        assert_eq!(body_to_c((voxel_body, pos)), body);
+
+        assert!(body_from_c(CVoxelBody { other_body_axis: 3, ..body }).is_err());
+        assert!(body_from_c(CVoxelBody { joint_pos: 45, ..body }).is_err());
+        assert!(body_from_c(CVoxelBody { pos: [200, 0, 0], ..body }).is_err());
+    }
+}
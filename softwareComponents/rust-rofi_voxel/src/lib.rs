@@ -12,5 +12,7 @@ pub mod module_move;
 pub mod module_repr;
 pub mod reconfiguration;
 
+#[cfg(feature = "cpp_bindings")]
+mod cpp_bindings;
 #[cfg(feature = "cpp_json_bindings")]
 mod cpp_json_bindings;
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+#include <cassert>
 #include <functional>
 #include <map>
 #include <memory>
@@ -10,14 +12,20 @@
 #include <vector>
 
 #include <vtkActor.h>
+#include <vtkAlgorithmOutput.h>
 #include <vtkCamera.h>
+#include <vtkDoubleArray.h>
+#include <vtkGlyph3DMapper.h>
 #include <vtkInteractorStyle.h>
 #include <vtkInteractorStyleTrackballCamera.h>
 #include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
 #include <vtkRenderWindow.h>
 #include <vtkRenderWindowInteractor.h>
 #include <vtkRenderer.h>
 #include <vtkSmartPointer.h>
+#include <vtkUnsignedCharArray.h>
 
 #include "atoms/guarded.hpp"
 #include "changecolor.hpp"
@@ -44,17 +52,79 @@ namespace rofi::simplesim
 {
 namespace detail
 {
+    // All instances of a single model rendered by a single actor
+    // Each instance has its own position and color
+    class InstancedModel {
+    public:
+        InstancedModel( vtkRenderer * renderer, vtkAlgorithmOutput * model, double scale = 1. / 95. );
+
+        vtkIdType add( const rofi::configuration::matrices::Matrix & position,
+                       const std::array< double, 3 > & color );
+        void setPosition( vtkIdType instance, const rofi::configuration::matrices::Matrix & position );
+        void setColor( vtkIdType instance, const std::array< double, 3 > & color );
+        std::array< double, 3 > getColor( vtkIdType instance ) const;
+        // Removes all instances, the actor stays in the renderer
+        void clear();
+
+    private:
+        vtkSmartPointer< vtkPoints > _positions;
+        vtkSmartPointer< vtkDoubleArray > _orientations;
+        vtkSmartPointer< vtkUnsignedCharArray > _colors;
+        vtkSmartPointer< vtkPolyData > _instances;
+        vtkSmartPointer< vtkGlyph3DMapper > _mapper;
+        vtkSmartPointer< vtkActor > _actor;
+    };
+
+    struct ComponentInstance {
+        rofi::configuration::ComponentType type;
+        vtkIdType instance;
+    };
+
+    // Components of all modules rendered by a single actor per component type
+    class ComponentInstances {
+    public:
+        explicit ComponentInstances( vtkRenderer * renderer ) : _renderer( renderer )
+        {
+            assert( _renderer );
+        }
+
+        ComponentInstance add( rofi::configuration::ComponentType type,
+                               const rofi::configuration::matrices::Matrix & position,
+                               const std::array< double, 3 > & color );
+        void setPosition( ComponentInstance component,
+                          const rofi::configuration::matrices::Matrix & position )
+        {
+            _models.at( component.type ).setPosition( component.instance, position );
+        }
+        void setColor( ComponentInstance component, const std::array< double, 3 > & color )
+        {
+            _models.at( component.type ).setColor( component.instance, color );
+        }
+        std::array< double, 3 > getColor( ComponentInstance component ) const
+        {
+            return _models.at( component.type ).getColor( component.instance );
+        }
+        void clear()
+        {
+            for ( auto & [ type, model ] : _models ) {
+                model.clear();
+            }
+        }
+
+    private:
+        vtkRenderer * _renderer;
+        std::map< rofi::configuration::ComponentType, InstancedModel > _models;
+    };
+
     class ModuleRenderInfo {
     public:
-        std::vector< vtkSmartPointer< vtkActor > > componentActors;
+        std::vector< ComponentInstance > componentInstances;
         std::unordered_set< int > activeConnectors;
     };
 
 } // namespace detail
 
 
-// TODO use the same mapper for all modules
-// TODO use the same property for setting the modules
 class SimplesimClient : public QMainWindow {
     Q_OBJECT
 
@@ -203,6 +273,7 @@ private:
 
     std::unique_ptr< ChangeColor > _changeColorWindow;
     vtkNew< vtkRenderer > _renderer;
+    detail::ComponentInstances _componentInstances;
     vtkNew< vtkRenderWindow > _renderWindow;
     vtkNew< vtkInteractorStyleTrackballCamera > _interactorStyle;
     vtkNew< vtkRenderWindowInteractor > _renderWindowInteractor;
@@ -1,6 +1,8 @@
 #include "simplesim_client.hpp"
 
 #include <array>
+#include <climits>
+#include <cmath>
 #include <functional>
 #include <map>
 #include <unordered_map>
@@ -10,13 +12,14 @@
 #include <vtkAxesActor.h>
 #include <vtkCamera.h>
 #include <vtkCylinderSource.h>
+#include <vtkGlyph3DMapper.h>
 #include <vtkInteractorStyleTrackballCamera.h>
 #include <vtkMatrix4x4.h>
 #include <vtkNamedColors.h>
 #include <vtkNew.h>
 #include <vtkOBJReader.h>
 #include <vtkOrientationMarkerWidget.h>
-#include <vtkPolyDataMapper.h>
+#include <vtkPointData.h>
 #include <vtkProperty.h>
 #include <vtkRenderWindow.h>
 #include <vtkRenderWindowInteractor.h>
@@ -92,56 +95,146 @@ vtkAlgorithmOutput * getComponentModel( rofi::configuration::ComponentType type
     return cache[ type ]->GetOutputPort();
 }
 
-vtkSmartPointer< vtkPolyDataMapper > getComponentMapper( const Matrix & cPosition,
-                                                         rofi::configuration::ComponentType cType )
+namespace rofi::simplesim::detail
 {
-    auto posTransform = vtkSmartPointer< vtkTransform >::New();
-    posTransform->SetMatrix( convertMatrix( cPosition ) );
+InstancedModel::InstancedModel( vtkRenderer * renderer, vtkAlgorithmOutput * model, double scale )
+        : _positions( vtkSmartPointer< vtkPoints >::New() )
+        , _orientations( vtkSmartPointer< vtkDoubleArray >::New() )
+        , _colors( vtkSmartPointer< vtkUnsignedCharArray >::New() )
+        , _instances( vtkSmartPointer< vtkPolyData >::New() )
+        , _mapper( vtkSmartPointer< vtkGlyph3DMapper >::New() )
+        , _actor( vtkSmartPointer< vtkActor >::New() )
+{
+    assert( renderer != nullptr );
+
+    _orientations->SetName( "orientation" );
+    _orientations->SetNumberOfComponents( 3 );
+    _colors->SetName( "color" );
+    _colors->SetNumberOfComponents( 3 );
+    _instances->SetPoints( _positions );
+    _instances->GetPointData()->AddArray( _orientations );
+    _instances->GetPointData()->SetScalars( _colors );
+
+    _mapper->SetInputData( _instances );
+    _mapper->SetSourceConnection( model );
+    // Orientation is given by angles as returned by vtkTransform::GetOrientation
+    _mapper->SetOrientationArray( "orientation" );
+    _mapper->SetOrientationModeToRotation();
+    _mapper->SetScaling( true );
+    _mapper->SetScaleModeToNoDataScaling();
+    _mapper->SetScaleFactor( scale );
+    _mapper->SetScalarModeToUsePointData();
+    _mapper->ScalarVisibilityOn();
+
+    _actor->SetMapper( _mapper );
+    _actor->GetProperty()->SetOpacity( 1.0 );
+    _actor->GetProperty()->SetFrontfaceCulling( true );
+    _actor->GetProperty()->SetBackfaceCulling( true );
+    renderer->AddActor( _actor );
+}
 
-    auto filter = vtkSmartPointer< vtkTransformPolyDataFilter >::New();
-    filter->SetTransform( posTransform );
-    filter->SetInputConnection( getComponentModel( cType ) );
+vtkIdType InstancedModel::add( const Matrix & position, const std::array< double, 3 > & color )
+{
+    auto instance = _positions->InsertNextPoint( 0, 0, 0 );
+    _orientations->InsertNextTuple3( 0, 0, 0 );
+    _colors->InsertNextTuple3( 0, 0, 0 );
+    setPosition( instance, position );
+    setColor( instance, color );
+    return instance;
+}
+
+void InstancedModel::setPosition( vtkIdType instance, const Matrix & position )
+{
+    assert( instance < _positions->GetNumberOfPoints() );
+    double orientation[ 3 ];
+    vtkTransform::GetOrientation( orientation, convertMatrix( position ) );
+    _positions->SetPoint( instance, position( 0, 3 ), position( 1, 3 ), position( 2, 3 ) );
+    _orientations->SetTuple( instance, orientation );
+    _positions->Modified();
+    _orientations->Modified();
+    _instances->Modified();
+}
 
-    auto mapper = vtkSmartPointer< vtkPolyDataMapper >::New();
-    mapper->SetInputConnection( filter->GetOutputPort() );
-    return mapper;
+void InstancedModel::setColor( vtkIdType instance, const std::array< double, 3 > & color )
+{
+    assert( instance < _colors->GetNumberOfTuples() );
+    for ( int i = 0; i < 3; i++ ) {
+        auto value = std::lround( color[ to_unsigned( i ) ] * 255 );
+        _colors->SetValue( 3 * instance + i, static_cast< unsigned char >( value ) );
+    }
+    _colors->Modified();
+    _instances->Modified();
 }
 
+std::array< double, 3 > InstancedModel::getColor( vtkIdType instance ) const
+{
+    assert( instance < _colors->GetNumberOfTuples() );
+    auto color = std::array< double, 3 >();
+    for ( int i = 0; i < 3; i++ ) {
+        color[ to_unsigned( i ) ] = _colors->GetValue( 3 * instance + i ) / 255.0;
+    }
+    return color;
+}
 
-[[nodiscard]] std::vector< vtkSmartPointer< vtkActor > > addModuleToScene(
-        vtkRenderer * renderer,
+void InstancedModel::clear()
+{
+    _positions->Reset();
+    _orientations->Reset();
+    _colors->Reset();
+    _positions->Modified();
+    _orientations->Modified();
+    _colors->Modified();
+    _instances->Modified();
+}
+
+ComponentInstance ComponentInstances::add( rofi::configuration::ComponentType type,
+                                           const Matrix & position,
+                                           const std::array< double, 3 > & color )
+{
+    auto model = _models.find( type );
+    if ( model == _models.end() ) {
+        model = _models.emplace( type, InstancedModel( _renderer, getComponentModel( type ) ) ).first;
+    }
+    return { .type = type, .instance = model->second.add( position, color ) };
+}
+
+} // namespace rofi::simplesim::detail
+
+using rofi::simplesim::detail::ComponentInstance;
+using rofi::simplesim::detail::ComponentInstances;
+
+Matrix getComponentPosition( const rofi::configuration::Module & module,
+                             const Matrix & mPosition,
+                             size_t componentIdx,
+                             const std::unordered_set< int > & activeConnectors )
+{
+    assert( componentIdx <= INT_MAX );
+    auto cPosition = mPosition
+                   * module.getComponentRelativePosition( static_cast< int >( componentIdx ) );
+    // make connected RoFICoMs connected visually
+    if ( activeConnectors.contains( static_cast< int >( componentIdx ) ) ) {
+        cPosition = cPosition * translate( { -0.05, 0, 0 } );
+    }
+    return cPosition;
+}
+
+[[nodiscard]] std::vector< ComponentInstance > addModuleToScene(
+        ComponentInstances & componentInstances,
         const rofi::configuration::Module & newModule,
         const Matrix & mPosition,
         const std::unordered_set< int > & activeConnectors )
 {
-    auto componentActors = std::vector< vtkSmartPointer< vtkActor > >();
-    componentActors.reserve( newModule.components().size() );
+    auto instances = std::vector< ComponentInstance >();
+    instances.reserve( newModule.components().size() );
     const auto & components = newModule.components();
     for ( size_t i = 0; i < components.size(); i++ ) {
-        auto frameActor = vtkSmartPointer< vtkActor >::New();
-        frameActor->GetProperty()->SetColor( getModuleColor( newModule.getId() ).data() );
-        frameActor->GetProperty()->SetOpacity( 1.0 );
-        frameActor->GetProperty()->SetFrontfaceCulling( true );
-        frameActor->GetProperty()->SetBackfaceCulling( true );
-        frameActor->SetScale( 1. / 95. );
-
-        assert( i <= INT_MAX );
-        auto cPosition = mPosition
-                       * newModule.getComponentRelativePosition( static_cast< int >( i ) );
-        // make connected RoFICoMs connected visually
-        if ( activeConnectors.contains( static_cast< int >( i ) ) ) {
-            cPosition = cPosition * translate( { -0.05, 0, 0 } );
-        }
-
-        auto mapper = getComponentMapper( cPosition, components[ i ].type );
-        frameActor->SetMapper( mapper );
-        frameActor->SetPosition( cPosition( 0, 3 ), cPosition( 1, 3 ), cPosition( 2, 3 ) );
-
-        renderer->AddActor( frameActor );
-        componentActors.push_back( std::move( frameActor ) );
+        instances.push_back( componentInstances.add(
+                components[ i ].type,
+                getComponentPosition( newModule, mPosition, i, activeConnectors ),
+                getModuleColor( newModule.getId() ) ) );
     }
-    assert( componentActors.size() == newModule.components().size() );
-    return componentActors;
+    assert( instances.size() == newModule.components().size() );
+    return instances;
 }
 
 bool sameComponentTypes( const rofi::configuration::Module & newModule,
@@ -161,54 +254,37 @@ bool sameComponentTypes( const rofi::configuration::Module & newModule,
     }
     return true;
 }
-void removeModuleFromScene( vtkRenderer * renderer,
-                            std::vector< vtkSmartPointer< vtkActor > > & componentActors )
+// Returns true if both configurations consist of the same modules
+// with the same component types, so only the positions have to be updated
+bool sameModules( const rofi::configuration::RofiWorld & newConfiguration,
+                  const rofi::configuration::RofiWorld & previousConfiguration )
 {
-    for ( const auto & componentActor : componentActors ) {
-        renderer->RemoveActor( componentActor );
+    if ( newConfiguration.modules().size() != previousConfiguration.modules().size() ) {
+        return false;
     }
-    componentActors.clear();
+    for ( const auto & newModuleInfo : newConfiguration.modules() ) {
+        assert( newModuleInfo.module.get() );
+        const auto * previousModule = previousConfiguration.getModule( newModuleInfo.module->getId() );
+        if ( !previousModule || !sameComponentTypes( *newModuleInfo.module, *previousModule ) ) {
+            return false;
+        }
+    }
+    return true;
 }
-void updateModulePositionInScene( const rofi::configuration::Module & newModule,
+void updateModulePositionInScene( ComponentInstances & componentInstances,
+                                  const rofi::configuration::Module & newModule,
                                   const Matrix & mPosition,
                                   const ModuleRenderInfo & moduleRenderInfo )
 {
     const auto & components = newModule.components();
-    assert( moduleRenderInfo.componentActors.size() == components.size() );
+    assert( moduleRenderInfo.componentInstances.size() == components.size() );
 
     for ( size_t i = 0; i < components.size(); i++ ) {
-        const auto & componentActor = moduleRenderInfo.componentActors[ i ];
-
-        assert( i < INT_MAX );
-        auto cPosition = mPosition
-                       * newModule.getComponentRelativePosition( static_cast< int >( i ) );
-        // make connected RoFICoMs connected visually
-        if ( moduleRenderInfo.activeConnectors.contains( static_cast< int >( i ) ) ) {
-            cPosition = cPosition * translate( { -0.05, 0, 0 } );
-        }
-
-        auto mapper = getComponentMapper( cPosition, components[ i ].type );
-
-        componentActor->SetMapper( mapper );
-        componentActor->SetPosition( cPosition( 0, 3 ), cPosition( 1, 3 ), cPosition( 2, 3 ) );
+        componentInstances.setPosition(
+                moduleRenderInfo.componentInstances[ i ],
+                getComponentPosition( newModule, mPosition, i, moduleRenderInfo.activeConnectors ) );
     }
 }
-void updateModuleInScene( vtkRenderer * renderer,
-                          const rofi::configuration::Module & newModule,
-                          const rofi::configuration::Module & previousModule,
-                          const Matrix & mPosition,
-                          ModuleRenderInfo & moduleRenderInfo )
-{
-    if ( sameComponentTypes( newModule, previousModule ) ) {
-        updateModulePositionInScene( newModule, mPosition, moduleRenderInfo );
-        return;
-    }
-    removeModuleFromScene( renderer, moduleRenderInfo.componentActors );
-    moduleRenderInfo.componentActors = addModuleToScene( renderer,
-                                                         newModule,
-                                                         mPosition,
-                                                         moduleRenderInfo.activeConnectors );
-}
 
 void setActiveConnectors(
         const atoms::HandleSet< rofi::configuration::RoficomJoint > & roficomConnections,
@@ -232,11 +308,9 @@ void setActiveConnectors(
 
 
 std::map< rofi::configuration::ModuleId, ModuleRenderInfo > addConfigurationToRenderer(
-        vtkRenderer * renderer,
+        ComponentInstances & componentInstances,
         const rofi::configuration::RofiWorld & newConfiguration )
 {
-    assert( renderer != nullptr );
-
     std::map< rofi::configuration::ModuleId, ModuleRenderInfo > moduleRenderInfos;
     setActiveConnectors( newConfiguration.roficomConnections(),
                          moduleRenderInfos,
@@ -245,59 +319,60 @@ std::map< rofi::configuration::ModuleId, ModuleRenderInfo > addConfigurationToRe
     for ( const auto & moduleInfo : newConfiguration.modules() ) {
         assert( moduleInfo.module.get() );
         assert( moduleInfo.absPosition && "The configuration has to be prepared" );
-        moduleRenderInfos[ moduleInfo.module->getId() ].componentActors =
-                addModuleToScene( renderer,
-                                  *moduleInfo.module,
-                                  *moduleInfo.absPosition,
-                                  moduleRenderInfos[ moduleInfo.module->getId() ]
-                                          .activeConnectors );
+        auto & moduleRenderInfo = moduleRenderInfos[ moduleInfo.module->getId() ];
+        moduleRenderInfo.componentInstances = addModuleToScene( componentInstances,
+                                                                *moduleInfo.module,
+                                                                *moduleInfo.absPosition,
+                                                                moduleRenderInfo.activeConnectors );
     }
 
     assert( moduleRenderInfos.size() == newConfiguration.modules().size() );
     return moduleRenderInfos;
 }
 void updateConfigurationInRenderer(
-        vtkRenderer * renderer,
+        ComponentInstances & componentInstances,
         const rofi::configuration::RofiWorld & newConfiguration,
         const rofi::configuration::RofiWorld & previousConfiguration,
         std::map< rofi::configuration::ModuleId, ModuleRenderInfo > & moduleRenderInfos )
 {
-    assert( renderer != nullptr );
+    if ( !sameModules( newConfiguration, previousConfiguration ) ) {
+        // Rebuild all instances, keep colors of the modules that did not change
+        auto previousColors = std::map< rofi::configuration::ModuleId,
+                                        std::vector< std::array< double, 3 > > >();
+        for ( const auto & [ id, moduleRenderInfo ] : moduleRenderInfos ) {
+            auto & colors = previousColors[ id ];
+            for ( auto component : moduleRenderInfo.componentInstances ) {
+                colors.push_back( componentInstances.getColor( component ) );
+            }
+        }
+
+        componentInstances.clear();
+        moduleRenderInfos = addConfigurationToRenderer( componentInstances, newConfiguration );
+
+        for ( auto & [ id, moduleRenderInfo ] : moduleRenderInfos ) {
+            const auto & colors = previousColors[ id ];
+            if ( colors.size() != moduleRenderInfo.componentInstances.size() ) {
+                continue;
+            }
+            for ( size_t i = 0; i < colors.size(); i++ ) {
+                componentInstances.setColor( moduleRenderInfo.componentInstances[ i ], colors[ i ] );
+            }
+        }
+        return;
+    }
 
     setActiveConnectors( newConfiguration.roficomConnections(),
                          moduleRenderInfos,
                          newConfiguration );
 
-    auto previousModules =
-            std::unordered_map< rofi::configuration::ModuleId,
-                                std::reference_wrapper< const rofi::configuration::Module > >();
-    for ( const auto & previousModuleInfo : previousConfiguration.modules() ) {
-        assert( previousModuleInfo.module.get() );
-        previousModules.emplace( previousModuleInfo.module->getId(), *previousModuleInfo.module );
-    }
-
     for ( const auto & newModuleInfo : newConfiguration.modules() ) {
         assert( newModuleInfo.module.get() );
         assert( newModuleInfo.absPosition && "The configuration has to be prepared" );
         auto & newModule = *newModuleInfo.module;
-        auto & moduleRenderInfo = moduleRenderInfos[ newModule.getId() ];
-
-        if ( auto previousModuleIt = previousModules.find( newModule.getId() );
-             previousModuleIt != previousModules.end() )
-        {
-            updateModuleInScene( renderer,
-                                 newModule,
-                                 previousModuleIt->second,
-                                 *newModuleInfo.absPosition,
-                                 moduleRenderInfo );
-        } else {
-            assert( moduleRenderInfo.componentActors.empty() );
-            moduleRenderInfo.componentActors =
-                    addModuleToScene( renderer,
-                                      newModule,
-                                      *newModuleInfo.absPosition,
-                                      moduleRenderInfo.activeConnectors );
-        }
+        updateModulePositionInScene( componentInstances,
+                                     newModule,
+                                     *newModuleInfo.absPosition,
+                                     moduleRenderInfos[ newModule.getId() ] );
     }
 
     assert( moduleRenderInfos.size() == newConfiguration.modules().size() );
@@ -305,6 +380,7 @@ void updateConfigurationInRenderer(
 
 SimplesimClient::SimplesimClient( OnSettingsCmdCallback onSettingsCmdCallback )
         : _ui( std::make_unique< Ui::SimplesimClient >() )
+        , _componentInstances( _renderer.Get() )
         , _onSettingsCmdCallback( std::move( onSettingsCmdCallback ) )
 {
     QMainWindow( nullptr );
@@ -355,14 +431,14 @@ void SimplesimClient::colorModule( rofi::configuration::ModuleId module,
                                    std::array< double, 3 > color,
                                    int component )
 {
+    const auto & componentInstances = _moduleRenderInfos[ module ].componentInstances;
     if ( component == -1 ) {
-        for ( auto & actor : _moduleRenderInfos[ module ].componentActors ) {
-            actor->GetProperty()->SetColor( color.data() );
+        for ( auto componentInstance : componentInstances ) {
+            _componentInstances.setColor( componentInstance, color );
         }
     } else {
-        assert( to_unsigned( component ) < _moduleRenderInfos[ module ].componentActors.size() );
-        _moduleRenderInfos[ module ].componentActors[ component ]->GetProperty()->SetColor(
-                color.data() );
+        assert( to_unsigned( component ) < componentInstances.size() );
+        _componentInstances.setColor( componentInstances[ to_unsigned( component ) ], color );
     }
 }
 
@@ -380,12 +456,14 @@ void SimplesimClient::itemSelected( QTreeWidgetItem * selected )
     if ( !selected->parent() ) {
         treeIdx = _ui->treeWidget->indexOfTopLevelItem( selected );
         moduleId = _treeIdMapping[ treeIdx ];
-        _moduleRenderInfos[ moduleId ].componentActors.front()->GetProperty()->GetColor( _lastColor.data() );
+        _lastColor = _componentInstances.getColor(
+                _moduleRenderInfos[ moduleId ].componentInstances.front() );
         colorModule( moduleId, white );
     } else if ( selected->parent() && !selected->parent()->parent() ) {
         treeIdx = _ui->treeWidget->indexOfTopLevelItem( selected->parent() );
         moduleId = _treeIdMapping[ treeIdx ];
-        _moduleRenderInfos[ moduleId ].componentActors.front()->GetProperty()->GetColor( _lastColor.data() );
+        _lastColor = _componentInstances.getColor(
+                _moduleRenderInfos[ moduleId ].componentInstances.front() );
         colorModule( moduleId, white );
         auto config = *getCurrentConfig();
         selectedPosition = config.getModulePosition( moduleId );
@@ -393,7 +471,8 @@ void SimplesimClient::itemSelected( QTreeWidgetItem * selected )
         treeIdx = _ui->treeWidget->indexOfTopLevelItem( selected->parent()->parent() );
         moduleId = _treeIdMapping[ treeIdx ];
         int component = _ui->treeWidget->topLevelItem( treeIdx )->child( 0 )->indexOfChild( selected );
-        _moduleRenderInfos[ moduleId ].componentActors[ component ]->GetProperty()->GetColor( _lastColor.data() );
+        _lastColor = _componentInstances.getColor(
+                _moduleRenderInfos[ moduleId ].componentInstances[ to_unsigned( component ) ] );
         colorModule( moduleId, white, component );
 
         selectedPosition = getCurrentConfig()->getModule( moduleId )
@@ -463,9 +542,7 @@ void SimplesimClient::speedChanged( double speed )
 
 void SimplesimClient::clearRenderer()
 {
-    for ( auto & moduleRenderInfo : _moduleRenderInfos ) {
-        removeModuleFromScene( _renderer.Get(), moduleRenderInfo.second.componentActors );
-    }
+    _componentInstances.clear();
     _moduleRenderInfos.clear();
     _lastRenderedConfiguration.reset();
 }
@@ -520,13 +597,13 @@ void SimplesimClient::renderCurrentConfiguration()
     assert( _renderer.Get() != nullptr );
     if ( auto newConfiguration = getCurrentConfig() ) {
         if ( _lastRenderedConfiguration != nullptr ) {
-            updateConfigurationInRenderer( _renderer.Get(),
+            updateConfigurationInRenderer( _componentInstances,
                                            *newConfiguration,
                                            *_lastRenderedConfiguration,
                                            _moduleRenderInfos );
         } else {
             assert( _moduleRenderInfos.empty() );
-            _moduleRenderInfos = addConfigurationToRenderer( _renderer.Get(), *newConfiguration );
+            _moduleRenderInfos = addConfigurationToRenderer( _componentInstances, *newConfiguration );
         }
 
         updateInfoTree( *newConfiguration );
@@ -3,10 +3,10 @@
 #include <algorithm>
 #include <concepts>
 #include <functional>
-#include <map>
 #include <memory>
 #include <optional>
 
+#include "atoms/flat_map.hpp"
 #include "atoms/guarded.hpp"
 #include "configuration/rofiworld.hpp"
 #include "inner_state.hpp"
@@ -21,7 +21,9 @@ namespace rofi::simplesim
 {
 namespace detail
 {
-    using ModuleInnerStates = std::map< ModuleId, ModuleInnerState >;
+    // Modules are not added during the simulation, so a sorted vector gives us
+    // the cheapest lookup and stable pointers to the inner states
+    using ModuleInnerStates = atoms::FlatMap< ModuleId, ModuleInnerState >;
     inline auto getModuleInnerState( const ModuleInnerStates & moduleStates, ModuleId moduleId )
             -> const ModuleInnerState *
     {
@@ -138,8 +140,7 @@ namespace detail
             /// Otherwise disconnects them.
             ///
             /// Requires that `lhs != rhs`.
-            void updateInnerStates(
-                    std::map< ModuleId, ModuleInnerState > & moduleInnerStates ) const
+            void updateInnerStates( detail::ModuleInnerStates & moduleInnerStates ) const
             {
                 if ( orientation ) {
                     connectInnerStates( moduleInnerStates );
@@ -157,8 +158,7 @@ namespace detail
         private:
             /// Connects the inner connector states.
             /// Requires that `lhs != rhs` and that `orientation` has value.
-            void connectInnerStates(
-                    std::map< ModuleId, ModuleInnerState > & moduleInnerStates ) const
+            void connectInnerStates( detail::ModuleInnerStates & moduleInnerStates ) const
             {
                 assert( lhs != rhs );
                 assert( orientation );
@@ -184,8 +184,7 @@ namespace detail
             }
             /// Disconnects the inner connector states.
             /// Requires that `lhs != rhs` and that `orientation` has no value.
-            void resetInnerStates(
-                    std::map< ModuleId, ModuleInnerState > & moduleInnerStates ) const
+            void resetInnerStates( detail::ModuleInnerStates & moduleInnerStates ) const
             {
                 assert( lhs != rhs );
                 assert( orientation == std::nullopt );
@@ -364,11 +363,11 @@ private:
 
     static auto initInnerStatesFromConfiguration(
             const rofi::configuration::RofiWorld & rofiworldConfiguration,
-            bool verbose ) -> std::map< ModuleId, ModuleInnerState >;
+            bool verbose ) -> detail::ModuleInnerStates;
 
 private:
     atoms::Guarded< RofiWorldConfigurationPtr > _physicalModulesConfiguration;
-    std::map< ModuleId, ModuleInnerState > _moduleInnerStates;
+    detail::ModuleInnerStates _moduleInnerStates;
 
     atoms::Guarded< std::vector< RofiWorldConfigurationPtr > > _configurationHistory;
 };
@@ -359,9 +359,10 @@ auto ModuleStates::computeNextIteration( std::chrono::duration< float > simStepT
 
 auto ModuleStates::initInnerStatesFromConfiguration( const RofiWorld & worldConfiguration,
                                                      bool verbose )
-        -> std::map< ModuleId, ModuleInnerState >
+        -> detail::ModuleInnerStates
 {
-    auto innerStates = std::map< ModuleId, ModuleInnerState >();
+    auto innerStatesValues = detail::ModuleInnerStates::container_type();
+    innerStatesValues.reserve( worldConfiguration.modules().size() );
     for ( const auto & moduleInfo : worldConfiguration.modules() ) {
         const auto & _module = *moduleInfo.module;
 
@@ -378,11 +379,13 @@ auto ModuleStates::initInnerStatesFromConfiguration( const RofiWorld & worldConf
                       << ", connectors: " << moduleInnerState.connectors().size() << std::endl;
         }
 
-        auto [ it, success ] = innerStates.emplace( _module.getId(),
-                                                    std::move( moduleInnerState ) );
-        if ( !success ) {
-            throw std::runtime_error( "Multiple same module ids in configuration" );
-        }
+        innerStatesValues.emplace_back( _module.getId(), std::move( moduleInnerState ) );
+    }
+
+    auto expectedSize = innerStatesValues.size();
+    auto innerStates = detail::ModuleInnerStates( std::move( innerStatesValues ) );
+    if ( innerStates.size() != expectedSize ) {
+        throw std::runtime_error( "Multiple same module ids in configuration" );
     }
 
     for ( auto & connection : worldConfiguration.roficomConnections() ) {
@@ -1,5 +1,6 @@
 #include <z3++.h>
 #include "smtReconfig.hpp"
+#include "portfolio.hpp"
 #include <IO.h>
 #include <vector>
 #include <string>
@@ -108,14 +109,6 @@ float radToDeg( float val ) {
     return 180.0 * val / M_PI;
 }
 
-float reconstruct( const rofi::smtr::SinCosAngle& angle,
-    const z3::model& model )
-{
-    float sin = std::stof( model.eval( angle.sin ).get_decimal_string( 5 ) );
-    float cos = std::stof( model.eval( angle.cos ).get_decimal_string( 5 ) );
-    return atan2( sin, cos );
-}
-
 float reconstruct( const rofi::smtr::SinCosAngle& angle,
     const YicesProcSolver& solver )
 {
@@ -124,32 +117,6 @@ float reconstruct( const rofi::smtr::SinCosAngle& angle,
     return atan2( sin, cos );
 }
 
-Configuration reconstruct( const rofi::smtr::SmtConfiguration& smtCfg,
-    const z3::model& model )
-{
-    using namespace rofi::smtr;
-
-    Configuration cfg;
-    for ( int i = 0; i != smtCfg.modules.size(); i++ ) {
-        float alpha = reconstruct( smtCfg.modules[ i ].alpha, model );
-        float beta = reconstruct( smtCfg.modules[ i ].beta, model );
-        float gamma = reconstruct( smtCfg.modules[ i ].gamma, model );
-        cfg.addModule( radToDeg( alpha ), radToDeg( beta ), radToDeg( gamma ), i );
-    }
-
-    for ( auto [ m, ms, n, ns ] : allShoePairs( smtCfg.modules.size() ) ) {
-        for ( auto [ mc, nc, o ] : allShoeConnections() ) {
-            const z3::expr& conn = smtCfg.connection( m, ms, mc, n, ns, nc, o );
-            bool connected = model.eval( conn ).is_true();
-            if ( !connected )
-                continue;
-            cfg.addEdge( Edge{ m, ms, mc, o, nc, ns, n } );
-        }
-    }
-
-    return cfg;
-}
-
 Configuration reconstruct( const rofi::smtr::SmtConfiguration& smtCfg,
     const YicesProcSolver& solver )
 {
@@ -227,7 +194,7 @@ int runReconfig( Configuration& init, Configuration& target, int length,
         formulaTime.start();
         rofi::smtr::Context ctx( params );
         z3::solver s( ctx.ctx, "QF_NRA" );
-        auto [ phi, cfgs ] = buildFormula( ctx, init, target, length );
+        auto [ phi, cfgs ] = buildFormula( ctx, init, target, i );
         s.add( phi );
         formulaTime.stop();
 
@@ -260,6 +227,85 @@ int runReconfig( Configuration& init, Configuration& target, int length,
     return 0;
 }
 
+int runIncrementalReconfig( Configuration& init, Configuration& target,
+    int length, rofi::smtr::Parameters params )
+{
+    using namespace IO;
+    rofi::smtr::Context ctx( params );
+    StopWatch formulaTime;
+    formulaTime.start();
+    rofi::smtr::IncrementalReconfig bmc( ctx, init, target );
+    formulaTime.stop();
+    int totalFormulaMs = formulaTime.ms();
+    int totalSolverMs = 0;
+    for ( int i = 2; i != length; i++ ) {
+        std::cerr << "Trying length " << i << "\n";
+        formulaTime.start();
+        while ( bmc.length() < i )
+            bmc.extend();
+        formulaTime.stop();
+        totalFormulaMs += formulaTime.ms();
+        std::cerr << "    Formula build-time: " << formulaTime.ms() << " ms\n";
+
+        StopWatch solverTime;
+        solverTime.start();
+        auto res = bmc.checkTarget();
+        solverTime.stop();
+        totalSolverMs += solverTime.ms();
+        std::cerr << "    Result: " << res << " in " << solverTime.ms() << " ms\n";
+
+        if ( res == z3::unsat )
+            continue;
+        if ( res == z3::unknown ) {
+            std::cerr << "    Solver gave up: " << bmc.solver().reason_unknown() << "\n";
+            break;
+        }
+
+        z3::model model = bmc.model();
+        for ( const auto& cfg : bmc.configurations() ) {
+            std::cout << toString( reconstruct( cfg, model ) ) << "\n";
+        }
+        break;
+    }
+    std::cerr << "Total formula build-time: " << totalFormulaMs << " ms, "
+              << "total solver time: " << totalSolverMs << " ms\n";
+    return 0;
+}
+
+int runPortfolioReconfig( Configuration& init, Configuration& target,
+    int length, rofi::smtr::Parameters params, unsigned jobs,
+    std::vector< std::string > tactics )
+{
+    using namespace IO;
+    using StepSize = rofi::smtr::Parameters::StepSize;
+    // Continuous formulas can refute a length, the 90 degree ones are
+    // usually faster to satisfy
+    std::vector< StepSize > stepSizes = { StepSize::Step90, StepSize::Continuous };
+    if ( params.stepSize == StepSize::Step90 )
+        stepSizes = { StepSize::Step90 };
+    if ( tactics.empty() )
+        tactics = { "default", "qfnra-nlsat" };
+
+    StopWatch totalTime;
+    totalTime.start();
+    auto result = rofi::smtr::solvePortfolio( init, target, length,
+        rofi::smtr::portfolioConfigs( params, stepSizes, tactics ), jobs, std::cerr );
+    totalTime.stop();
+
+    if ( !result ) {
+        std::cerr << "No path found in " << totalTime.ms() << " ms\n";
+        return 1;
+    }
+    std::cerr << "Found path of length " << result->length << " using "
+              << result->config.name() << " in " << totalTime.ms() << " ms"
+              << ( result->shortest ? " (shortest)\n"
+                  : " (unconfirmed, a shorter length was not refuted)\n" );
+    for ( const auto& cfg : result->path ) {
+        std::cout << toString( cfg ) << "\n";
+    }
+    return 0;
+}
+
 template < typename Args >
 std::string getCommand( Args& args ) {
     if ( !args.count("positional") )
@@ -275,6 +321,8 @@ int main( int argc, char **argv ) {
 
     std::string initial, final;
     int length = -1;
+    unsigned jobs = 0;
+    std::vector< std::string > tactics;
     options.add_options()
         ( "positional", "[smt|reconfig]",
             cxxopts::value< std::vector< std::string > >() )
@@ -285,6 +333,12 @@ int main( int argc, char **argv ) {
         ( "l, length", "either upper bound for the smt command or the formula length",
             cxxopts::value< int >( length ), "N" )
         ( "s, simplify", "simplify the formula")
+        ( "incremental", "solve the reconfig command in process, reusing the solver across lengths" )
+        ( "portfolio", "solve the reconfig command by a parallel portfolio of lengths, tactics and step sizes" )
+        ( "j, jobs", "number of portfolio threads, 0 for all hardware threads",
+            cxxopts::value< unsigned >( jobs ), "N" )
+        ( "tactics", "comma-separated z3 tactics of the portfolio, 'default' for the default solver",
+            cxxopts::value< std::vector< std::string > >( tactics ) )
         ( "shoeLimitConstrain", "" )
         ( "connectorLimitConstrain", "" )
         ( "90degReconfig", "");
@@ -324,6 +378,10 @@ int main( int argc, char **argv ) {
         return runSmt( init, target, length, params );
     }
     if ( command == "reconfig" ) {
+        if ( args.count( "portfolio" ) )
+            return runPortfolioReconfig( init, target, length, params, jobs, tactics );
+        if ( args.count( "incremental" ) )
+            return runIncrementalReconfig( init, target, length, params );
         return runReconfig( init, target, length, params );
     }
 
@@ -0,0 +1,244 @@
+#include "portfolio.hpp"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <fmt/format.h>
+
+namespace rofi::smtr {
+
+std::string SolverConfig::name() const {
+    std::string step = params.stepSize == Parameters::StepSize::Step90
+        ? "90deg" : "continuous";
+    return step + "/" + ( tactic.empty() ? "default" : tactic );
+}
+
+std::vector< SolverConfig > portfolioConfigs( const Parameters& base,
+    const std::vector< Parameters::StepSize >& stepSizes,
+    const std::vector< std::string >& tactics )
+{
+    std::vector< SolverConfig > configs;
+    for ( auto stepSize : stepSizes ) {
+        for ( const auto& tactic : tactics ) {
+            SolverConfig config{ base, tactic == "default" ? "" : tactic };
+            config.params.stepSize = stepSize;
+            configs.push_back( config );
+        }
+    }
+    return configs;
+}
+
+namespace {
+
+int msSince( std::chrono::steady_clock::time_point start ) {
+    using namespace std::chrono;
+    return duration_cast< milliseconds >( steady_clock::now() - start ).count();
+}
+
+class Portfolio {
+public:
+    Portfolio( const Configuration& init, const Configuration& target,
+        int maxLength, const std::vector< SolverConfig >& configs,
+        std::ostream& log )
+        : _init( init ), _target( target ), _log( log )
+    {
+        for ( int length = 2; length < maxLength; length++ ) {
+            _lengths.push_back( { length } );
+            for ( const auto& config : configs )
+                _tasks.push_back( { length, &config } );
+        }
+    }
+
+    void work() {
+        while ( true ) {
+            Task* task = _nextTask();
+            if ( !task )
+                return;
+            _run( *task );
+        }
+    }
+
+    std::optional< PortfolioResult > result() {
+        std::lock_guard lock( _mutex );
+        if ( _bestLength == INT_MAX )
+            return std::nullopt;
+        auto result = _state( _bestLength ).result;
+        result->shortest = _shorterRefuted();
+        return result;
+    }
+
+private:
+    struct Task {
+        int length;
+        const SolverConfig* config;
+        z3::context* running = nullptr;
+        bool cancelled = false;
+    };
+
+    struct LengthState {
+        int length;
+        bool refuted = false;
+        std::optional< PortfolioResult > result = {};
+    };
+
+    LengthState& _state( int length ) {
+        return _lengths[ length - 2 ];
+    }
+
+    Task* _nextTask() {
+        std::lock_guard lock( _mutex );
+        while ( !_stop && _next < _tasks.size() ) {
+            Task& task = _tasks[ _next++ ];
+            if ( !_isUseless( task ) )
+                return &task;
+            _finish();
+        }
+        return nullptr;
+    }
+
+    bool _isUseless( const Task& task ) {
+        return task.cancelled || task.length >= _bestLength
+            || _state( task.length ).refuted;
+    }
+
+    void _run( Task& task ) {
+        const SolverConfig& config = *task.config;
+        auto start = std::chrono::steady_clock::now();
+        std::string status;
+        int formulaMs = 0;
+        // The context outlives the solver even when it throws, so it is
+        // never interrupted after being destroyed
+        Context ctx( config.params );
+        try {
+            auto [ phi, cfgs ] = reconfig( ctx, task.length, _init, _target );
+            if ( ctx.cfg.simplify )
+                phi = phi.simplify();
+            z3::solver s = config.tactic.empty()
+                ? z3::solver( ctx.ctx, "QF_NRA" )
+                : z3::tactic( ctx.ctx, config.tactic.c_str() ).mk_solver();
+            s.add( phi );
+            formulaMs = msSince( start );
+
+            if ( !_setRunning( task, &ctx.ctx ) ) {
+                status = "skipped";
+            } else {
+                auto res = s.check();
+                bool interrupted = !_setRunning( task, nullptr );
+                if ( res == z3::sat ) {
+                    std::vector< Configuration > path;
+                    z3::model model = s.get_model();
+                    for ( const auto& cfg : cfgs )
+                        path.push_back( reconstruct( cfg, model ) );
+                    _onSat( task, std::move( path ) );
+                } else if ( res == z3::unsat ) {
+                    _onUnsat( task );
+                }
+                std::ostringstream resStream;
+                resStream << res;
+                status = interrupted && res == z3::unknown ? "interrupted" : resStream.str();
+            }
+        } catch ( const z3::exception& e ) {
+            _setRunning( task, nullptr );
+            status = std::string( "error: " ) + e.msg();
+        }
+
+        std::lock_guard lock( _mutex );
+        _log << fmt::format( "Length {} [{}]: {} in {} ms (formula build-time {} ms)\n",
+            task.length, config.name(), status, msSince( start ), formulaMs );
+        _finish();
+    }
+
+    /**
+     * Register the context of a running solver, so it can be interrupted
+     *
+     * \returns false if the task was cancelled meanwhile
+     */
+    bool _setRunning( Task& task, z3::context* ctx ) {
+        std::lock_guard lock( _mutex );
+        task.running = ctx;
+        return !task.cancelled;
+    }
+
+    void _onSat( Task& task, std::vector< Configuration > path ) {
+        std::lock_guard lock( _mutex );
+        auto& state = _state( task.length );
+        if ( state.result )
+            return;
+        state.result = PortfolioResult{ task.length, *task.config, std::move( path ) };
+        _bestLength = std::min( _bestLength, task.length );
+        _cancelIf( [&]( const Task& t ) { return t.length >= _bestLength; } );
+    }
+
+    void _onUnsat( Task& task ) {
+        // A path using only 90 degree rotations is a special case of
+        // a continuous one, so only the continuous unsat refutes the length
+        if ( task.config->params.stepSize != Parameters::StepSize::Continuous )
+            return;
+        std::lock_guard lock( _mutex );
+        _state( task.length ).refuted = true;
+        _cancelIf( [&]( const Task& t ) { return t.length == task.length; } );
+    }
+
+    template < typename Pred >
+    void _cancelIf( Pred pred ) {
+        for ( auto& task : _tasks ) {
+            if ( !pred( task ) || task.cancelled )
+                continue;
+            task.cancelled = true;
+            if ( task.running )
+                task.running->interrupt();
+        }
+    }
+
+    // Expects the mutex to be locked
+    void _finish() {
+        if ( _bestLength == INT_MAX || !_shorterRefuted() )
+            return;
+        // The shortest satisfiable length is confirmed
+        _stop = true;
+        _cancelIf( []( const Task& ) { return true; } );
+    }
+
+    // Expects the mutex to be locked
+    bool _shorterRefuted() {
+        for ( int length = 2; length < _bestLength; length++ ) {
+            if ( !_state( length ).refuted )
+                return false;
+        }
+        return true;
+    }
+
+    const Configuration& _init;
+    const Configuration& _target;
+    std::ostream& _log;
+
+    std::mutex _mutex;
+    std::vector< Task > _tasks;
+    std::vector< LengthState > _lengths;
+    std::size_t _next = 0;
+    int _bestLength = INT_MAX;
+    bool _stop = false;
+};
+
+} // namespace
+
+std::optional< PortfolioResult > solvePortfolio( const Configuration& init,
+    const Configuration& target, int maxLength,
+    const std::vector< SolverConfig >& configs, unsigned threads,
+    std::ostream& log )
+{
+    if ( threads == 0 )
+        threads = std::max( std::thread::hardware_concurrency(), 1u );
+
+    Portfolio portfolio( init, target, maxLength, configs, log );
+    std::vector< std::thread > workers;
+    for ( unsigned i = 0; i != threads; i++ )
+        workers.emplace_back( [&] { portfolio.work(); } );
+    for ( auto& worker : workers )
+        worker.join();
+    return portfolio.result();
+}
+
+} // namespace rofi::smtr
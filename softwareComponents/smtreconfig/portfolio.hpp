@@ -0,0 +1,59 @@
+#pragma once
+
+#include "smtReconfig.hpp"
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace rofi::smtr {
+
+/**
+ * A way to solve a single path length: formula parameters together with the
+ * z3 tactic used to build the solver. Empty tactic stands for the default
+ * QF_NRA solver.
+ */
+struct SolverConfig {
+    Parameters params;
+    std::string tactic;
+
+    std::string name() const;
+};
+
+struct PortfolioResult {
+    int length;
+    SolverConfig config;
+    std::vector< Configuration > path;
+    // All the shorter lengths were refuted, so no shorter path exists
+    bool shortest = false;
+};
+
+/**
+ * Combine each of the step sizes with each of the tactics on top of \p base
+ */
+std::vector< SolverConfig > portfolioConfigs( const Parameters& base,
+    const std::vector< Parameters::StepSize >& stepSizes,
+    const std::vector< std::string >& tactics );
+
+/**
+ * Search for the shortest reconfiguration path using a portfolio of solvers.
+ *
+ * Lengths from 2 up to \p maxLength (excluded) are solved by all the
+ * \p configs in parallel using \p threads worker threads, shorter lengths
+ * first. Each task has its own z3::context. Once a length is satisfiable,
+ * all the tasks of longer lengths are interrupted; the search ends when all
+ * the shorter lengths are refuted or when all the tasks finish. A length is
+ * refuted only when a config without the 90 degree restriction proves it
+ * unsat. A length whose configs end unknown, with an error or with a 90 degree
+ * unsat only stays unconfirmed and the result found is not marked as shortest.
+ *
+ * Progress of each task is reported to \p log.
+ *
+ * \returns the path of the shortest satisfiable length found or nullopt
+ */
+std::optional< PortfolioResult > solvePortfolio( const Configuration& init,
+    const Configuration& target, int maxLength,
+    const std::vector< SolverConfig >& configs, unsigned threads,
+    std::ostream& log );
+
+} // namespace rofi::smtr
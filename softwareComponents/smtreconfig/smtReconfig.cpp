@@ -195,6 +195,12 @@ z3::expr phiConsistent( Context& ctx, const SmtConfiguration& cfg ) {
     return phiShoeConsistent( ctx, cfg ) && phiConnectorConsistent( ctx, cfg );
 }
 
+// Every pair of shoes gets a single quadratic distance atom. Pre-testing the
+// pairs on the integer lattice of 90 degree configurations, or by linear
+// bounding boxes, replaces the atom by linear disjunctions which z3's nlsat
+// handles much worse - 3-attach of length 3 does not finish in 100 s instead
+// of 19 s. Module ids are fixed by the initial and target configurations, so
+// there is no module symmetry to break either.
 z3::expr phiNoIntersect( Context& ctx, const SmtConfiguration& cfg ) {
     using namespace smt;
     z3::expr phi = ctx.ctx.bool_val( true );
@@ -837,16 +843,90 @@ std::pair< z3::expr, std::vector< SmtConfiguration > > reconfig( Context& ctx,
     z3::expr phi = phiEqual( ctx, cfgs.front(), init ) &&
         phiEqual( ctx, cfgs.back(), target );
     for ( int i = 0; i != len; i++ )
-        phi = phi && phiValid( ctx, cfgs[ i ] ) && phiRootModule( ctx, cfgs[ i ], 0 );
+        phi = phi && phiFrame( ctx, cfgs[ i ] );
     for ( int i = 0; i != len - 1; i++ )
         phi = phi && phiStep( ctx, cfgs[ i ], cfgs[ i + 1 ] );
     phi = phi && ctx.constraints();
-    for ( const auto& cfg : cfgs ) {
-        phi = phi && cfg.constraints( ctx );
-    }
     return { phi, cfgs };
 }
 
+double radToDeg( double r ) {
+    return 180 * r / M_PI;
+}
+
+double reconstruct( const SinCosAngle& angle, const z3::model& model ) {
+    double sin = std::stod( model.eval( angle.sin ).get_decimal_string( 5 ) );
+    double cos = std::stod( model.eval( angle.cos ).get_decimal_string( 5 ) );
+    return atan2( sin, cos );
+}
+
+Configuration reconstruct( const SmtConfiguration& smtCfg, const z3::model& model ) {
+    Configuration cfg;
+    for ( int i = 0; i != smtCfg.modules.size(); i++ ) {
+        double alpha = reconstruct( smtCfg.modules[ i ].alpha, model );
+        double beta = reconstruct( smtCfg.modules[ i ].beta, model );
+        double gamma = reconstruct( smtCfg.modules[ i ].gamma, model );
+        cfg.addModule( radToDeg( alpha ), radToDeg( beta ), radToDeg( gamma ), i );
+    }
+
+    for ( auto [ m, ms, n, ns ] : allShoePairs( smtCfg.modules.size() ) ) {
+        for ( auto [ mc, nc, o ] : allShoeConnections() ) {
+            const z3::expr& conn = smtCfg.connection( m, ms, mc, n, ns, nc, o );
+            if ( !model.eval( conn ).is_true() )
+                continue;
+            cfg.addEdge( Edge{ m, ms, mc, o, nc, ns, n } );
+        }
+    }
+
+    return cfg;
+}
+
+z3::expr phiFrame( Context& ctx, const SmtConfiguration& cfg ) {
+    return phiValid( ctx, cfg ) && phiRootModule( ctx, cfg, 0 )
+        && cfg.constraints( ctx );
+}
+
+IncrementalReconfig::IncrementalReconfig( Context& ctx,
+    const Configuration& init, const Configuration& target )
+    : _ctx( ctx ), _init( init ), _target( target ), _solver( ctx.ctx, "QF_NRA" )
+{
+    _add( ctx.constraints() );
+    _cfgs.push_back( buildConfiguration( ctx, _init, 0 ) );
+    _add( phiEqual( ctx, _cfgs.front(), _init ) && phiFrame( ctx, _cfgs.front() ) );
+}
+
+void IncrementalReconfig::extend() {
+    _popTarget();
+    _cfgs.push_back( buildConfiguration( _ctx, _init, _cfgs.size() ) );
+    const auto& prev = _cfgs[ _cfgs.size() - 2 ];
+    const auto& next = _cfgs.back();
+    _add( phiFrame( _ctx, next ) && phiStep( _ctx, prev, next ) );
+}
+
+z3::check_result IncrementalReconfig::checkTarget() {
+    _popTarget();
+    _solver.push();
+    _targetScope = true;
+    _add( phiEqual( _ctx, _cfgs.back(), _target ) );
+    auto res = _solver.check();
+    if ( res != z3::sat )
+        _popTarget();
+    return res;
+}
+
+void IncrementalReconfig::_add( z3::expr phi ) {
+    if ( _ctx.cfg.simplify )
+        phi = phi.simplify();
+    _solver.add( phi );
+}
+
+void IncrementalReconfig::_popTarget() {
+    if ( !_targetScope )
+        return;
+    _solver.pop();
+    _targetScope = false;
+}
+
 z3::expr SmtConfiguration::constraints( Context& ctx ) const {
     z3::expr res = ctx.ctx.bool_val( true );
     if ( ctx.cfg.shoeLimitConstain ) {
@@ -99,7 +99,54 @@ SmtConfiguration buildConfiguration( Context& ctx,
 std::pair< z3::expr, std::vector< SmtConfiguration > > reconfig( Context& ctx,
     int len, const Configuration& init, const Configuration target );
 
+/**
+ * Read configuration from a model; modules are numbered by their index
+ */
+Configuration reconstruct( const SmtConfiguration& smtCfg, const z3::model& model );
+
+/**
+ * Incremental bounded model checking of the reconfiguration.
+ *
+ * The solver keeps the constraints of the configurations along the path and
+ * of the steps between them, so extending the path by one step adds only the
+ * new configuration and the step into it. The target is asserted in a solver
+ * scope, which is popped when there is no path of the current length.
+ */
+class IncrementalReconfig {
+public:
+    IncrementalReconfig( Context& ctx, const Configuration& init,
+        const Configuration& target );
+
+    /**
+     * Append a configuration to the path
+     */
+    void extend();
+
+    /**
+     * Check if the last configuration of the path can be the target one.
+     *
+     * On sat, the model is available until the next `extend`.
+     */
+    z3::check_result checkTarget();
+
+    z3::model model() const { return _solver.get_model(); }
+    int length() const { return _cfgs.size(); }
+    const std::vector< SmtConfiguration >& configurations() const { return _cfgs; }
+    z3::solver& solver() { return _solver; }
+
+private:
+    void _add( z3::expr phi );
+    void _popTarget();
+
+    Context& _ctx;
+    Configuration _init, _target;
+    z3::solver _solver;
+    std::vector< SmtConfiguration > _cfgs;
+    bool _targetScope = false;
+};
+
 z3::expr phiValid( Context& ctx, const SmtConfiguration& cfg );
+z3::expr phiFrame( Context& ctx, const SmtConfiguration& cfg );
 z3::expr phiConsistent( Context& ctx, const SmtConfiguration& cfg );
 z3::expr phiNoIntersect( Context& ctx, const SmtConfiguration& cfg );
 z3::expr phiIsConnected( Context& ctx, const SmtConfiguration& cfg );
@@ -1,5 +1,6 @@
 #include <catch2/catch.hpp>
 #include <smtReconfig.hpp>
+#include <portfolio.hpp>
 #include <fmt/format.h>
 
 using namespace rofi::smtr;
@@ -596,4 +597,107 @@ TEST_CASE( "phiIs Connected" ) {
 
         REQUIRE( s.check() == z3::sat );
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE( "Incremental reconfiguration" ) {
+    Context ctx;
+
+    Configuration init;
+    init.addModule( 0, 0, 0, 42 );
+    init.addModule( 0, 0, 0, 43 );
+    init.addEdge( { 42, A, XPlus, North, XPlus, A, 43 } );
+
+    SECTION( "Target reachable" ) {
+        IncrementalReconfig bmc( ctx, init, init );
+        REQUIRE( bmc.length() == 1 );
+        bmc.extend();
+        REQUIRE( bmc.length() == 2 );
+        REQUIRE( bmc.checkTarget() == z3::sat );
+        bmc.extend();
+        REQUIRE( bmc.length() == 3 );
+        REQUIRE( bmc.checkTarget() == z3::sat );
+        REQUIRE( bmc.configurations().size() == 3 );
+    }
+
+    SECTION( "Target unreachable" ) {
+        // Changing the connector requires a disconnection of the only edge
+        Configuration target;
+        target.addModule( 0, 0, 0, 42 );
+        target.addModule( 0, 0, 0, 43 );
+        target.addEdge( { 42, A, XPlus, North, XMinus, A, 43 } );
+
+        IncrementalReconfig bmc( ctx, init, target );
+        bmc.extend();
+        auto assertions = bmc.solver().assertions().size();
+        REQUIRE( bmc.checkTarget() == z3::unsat );
+        REQUIRE( bmc.solver().assertions().size() == assertions );
+    }
+
+    SECTION( "Target reachable after a failed check" ) {
+        Configuration target;
+        target.addModule( 90, 0, 0, 42 );
+        target.addModule( 0, 0, 0, 43 );
+        target.addEdge( { 42, A, XPlus, North, XPlus, A, 43 } );
+
+        IncrementalReconfig bmc( ctx, init, target );
+        auto assertions = bmc.solver().assertions().size();
+        REQUIRE( bmc.checkTarget() == z3::unsat );
+        REQUIRE( bmc.solver().assertions().size() == assertions );
+        // The failed target of the previous length does not stay asserted
+        bmc.extend();
+        REQUIRE( bmc.length() == 2 );
+        REQUIRE( bmc.checkTarget() == z3::sat );
+    }
+}
+
+TEST_CASE( "Portfolio reconfiguration" ) {
+    Configuration init;
+    init.addModule( 0, 0, 0, 42 );
+    init.addModule( 0, 0, 0, 43 );
+    init.addEdge( { 42, A, XPlus, North, XPlus, A, 43 } );
+
+    auto configs = portfolioConfigs( {},
+        { Parameters::StepSize::Step90, Parameters::StepSize::Continuous },
+        { "default", "qfnra-nlsat" } );
+    REQUIRE( configs.size() == 4 );
+
+    std::ostringstream log;
+    SECTION( "Target reachable" ) {
+        auto result = solvePortfolio( init, init, 5, configs, 4, log );
+        REQUIRE( result );
+        CHECK( result->length == 2 );
+        CHECK( result->path.size() == 2 );
+        CHECK( result->shortest );
+    }
+
+    SECTION( "90 degree unsat does not refute a length" ) {
+        // Moving the edge to the other shoes requires a disconnected step
+        Configuration from;
+        from.addModule( 0, 0, 0, 42 );
+        from.addModule( 0, 0, 0, 43 );
+        from.addEdge( { 42, A, XPlus, South, XMinus, A, 43 } );
+        Configuration target;
+        target.addModule( 0, 0, 0, 42 );
+        target.addModule( 0, 0, 0, 43 );
+        target.addEdge( { 42, B, XMinus, South, XPlus, B, 43 } );
+
+        auto step90 = portfolioConfigs( {}, { Parameters::StepSize::Step90 },
+            { "qfnra-nlsat" } );
+        auto result = solvePortfolio( from, target, 4, step90, 1, log );
+        CAPTURE( log.str() );
+        REQUIRE( result );
+        CHECK( result->length == 3 );
+        CHECK( !result->shortest );
+    }
+
+    SECTION( "Target unreachable" ) {
+        Configuration target;
+        target.addModule( 0, 0, 0, 42 );
+        target.addModule( 0, 0, 0, 43 );
+        target.addEdge( { 42, A, XPlus, North, XMinus, A, 43 } );
+
+        auto result = solvePortfolio( init, target, 3, configs, 2, log );
+        CAPTURE( log.str() );
+        REQUIRE( !result );
+    }
+}
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <legacy/configuration/Configuration.h>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * \brief Arena of search states for limitedAstar
+ *
+ * Each state keeps its configuration together with the search bookkeeping
+ * (distances and predecessor), so the search needs no side maps keyed by
+ * pointers.
+ *
+ * States are reference counted. References are held by the queue entries, by
+ * the successors whose predecessor the state is and by the caller (e.g., the
+ * best state found so far). Once the last reference is released, the slot
+ * returns to a free list and its configuration is reused by the next insert,
+ * so the memory grows with the number of live states instead of all states
+ * ever seen. Only a fingerprint and the distance from the initial
+ * configuration of reclaimed states are kept, so that the search still
+ * recognizes them when they are generated again.
+ */
+class SearchArena {
+public:
+    struct State {
+        Configuration config;
+        // Shortest known distance from the initial configuration
+        double initDist = 0;
+        // Estimated distance from the initial configuration to the goal
+        double goalDist = 0;
+        // nullptr for the initial configuration
+        State* pred = nullptr;
+
+    private:
+        friend SearchArena;
+        std::size_t hash = 0;
+        unsigned refs = 0;
+    };
+
+    SearchArena() = default;
+    SearchArena(const SearchArena&) = delete;
+    SearchArena& operator=(const SearchArena&) = delete;
+
+    /**
+     * \brief Find live state with given configuration
+     *
+     * \returns nullptr if there is no such state
+     */
+    State* find(const Configuration& config, std::size_t hash) const {
+        auto [first, last] = _index.equal_range(hash);
+        for (auto it = first; it != last; ++it) {
+            if (it->second->config == config)
+                return it->second;
+        }
+        return nullptr;
+    }
+
+    /**
+     * \brief Insert new state without any references
+     *
+     * Call `acquire` or `releaseIfUnused` afterwards, otherwise the state
+     * leaks until the arena is destroyed.
+     */
+    State* insert(const Configuration& config, std::size_t hash) {
+        State* state;
+        if (_free.empty()) {
+            state = &_slots.emplace_back();
+        } else {
+            state = _free.back();
+            _free.pop_back();
+        }
+        state->config = config;
+        state->initDist = 0;
+        state->goalDist = 0;
+        state->pred = nullptr;
+        state->hash = hash;
+        state->refs = 0;
+        _index.emplace(hash, state);
+        return state;
+    }
+
+    void acquire(State* state) {
+        assert(state);
+        state->refs++;
+    }
+
+    /**
+     * \brief Drop a reference; unreferenced states are reclaimed together with
+     * the predecessors referenced only by them
+     */
+    void release(State* state) {
+        assert(state && state->refs > 0);
+        state->refs--;
+        releaseIfUnused(state);
+    }
+
+    void releaseIfUnused(State* state) {
+        while (state && state->refs == 0) {
+            State* pred = state->pred;
+            _reclaim(state);
+            if (!pred)
+                break;
+            assert(pred->refs > 0);
+            pred->refs--;
+            state = pred;
+        }
+    }
+
+    void setPred(State* state, State* pred) {
+        assert(state != pred);
+        acquire(pred);
+        State* oldPred = state->pred;
+        state->pred = pred;
+        if (oldPred)
+            release(oldPred);
+    }
+
+    /**
+     * \brief Shortest distance from the initial configuration of a reclaimed
+     * state with given configuration
+     *
+     * \returns nullopt if no such state was reclaimed
+     */
+    std::optional<double> reclaimedInitDist(const Configuration& config) const {
+        auto it = _reclaimed.find(fingerprint(config));
+        if (it == _reclaimed.end())
+            return std::nullopt;
+        return it->second;
+    }
+
+    /**
+     * \brief 64-bit digest of the modules and edges of a configuration
+     *
+     * Unlike ConfigurationHash, which ignores the edges and collides often, it
+     * identifies the configuration for all practical purposes, so the arena
+     * can remember reclaimed states without their configurations.
+     */
+    static std::uint64_t fingerprint(const Configuration& config) {
+        // Sum of mixed entries does not depend on the order of the maps
+        std::uint64_t res = 0;
+        for (const auto& [id, module] : config.getModules()) {
+            std::uint64_t joints = _mix(id);
+            for (Joint joint : {Alpha, Beta, Gamma}) {
+                // Joints equal up to the comparison threshold round the same
+                joints = _mix(joints ^ static_cast<std::uint64_t>(std::llround(module.getJoint(joint) * 1000)));
+            }
+            res += joints;
+        }
+        for (const auto& [id, edges] : config.getEdges()) {
+            for (const auto& edge : edges) {
+                if (!edge)
+                    continue;
+                std::uint64_t packed = edge->id1();
+                packed = packed * 2 + edge->side1();
+                packed = packed * 3 + edge->dock1();
+                packed = packed * 4 + edge->ori();
+                packed = packed * 3 + edge->dock2();
+                packed = packed * 2 + edge->side2();
+                res += _mix(_mix(packed) ^ static_cast<std::uint64_t>(edge->id2()) ^ 0x5bd1e995);
+            }
+        }
+        return res;
+    }
+
+    /**
+     * \brief Number of live states
+     */
+    std::size_t size() const {
+        return _slots.size() - _free.size();
+    }
+
+    /**
+     * \brief Number of allocated slots, i.e., the peak number of live states
+     */
+    std::size_t capacity() const {
+        return _slots.size();
+    }
+
+    /**
+     * \brief Configurations from the initial one to given state
+     */
+    std::vector<Configuration> path(const State* goal) const {
+        std::vector<Configuration> res;
+        for (const State* current = goal; current; current = current->pred)
+            res.push_back(current->config);
+        std::reverse(res.begin(), res.end());
+        return res;
+    }
+
+private:
+    // Finalizer of splitmix64
+    static std::uint64_t _mix(std::uint64_t x) {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebULL;
+        x ^= x >> 31;
+        return x;
+    }
+
+    void _reclaim(State* state) {
+        auto [first, last] = _index.equal_range(state->hash);
+        for (auto it = first; it != last; ++it) {
+            if (it->second == state) {
+                _index.erase(it);
+                break;
+            }
+        }
+        auto [record, inserted] = _reclaimed.emplace(fingerprint(state->config), state->initDist);
+        if (!inserted)
+            record->second = std::min(record->second, state->initDist);
+        // Keep the configuration, its containers get reused by the next insert
+        state->pred = nullptr;
+        _free.push_back(state);
+    }
+
+    // Deque keeps the addresses of the states stable
+    std::deque<State> _slots;
+    std::vector<State*> _free;
+    std::unordered_multimap<std::size_t, State*> _index;
+    // Fingerprint of each reclaimed configuration to its initDist
+    std::unordered_map<std::uint64_t, double> _reclaimed;
+};
@@ -93,10 +93,10 @@ void logProgressCSV(std::ostream& debug_output, unsigned progress, std::optional
     debug_output << ";" << pathLen << std::endl;
 }
 
-std::pair<std::vector<Configuration>, bool> reconfigToSnake(const Configuration& init, ProgressCallback logTime) {
+std::pair<std::vector<Configuration>, bool> reconfigToSnake(const Configuration& init, ProgressCallback logTime, unsigned beamWidth) {
     auto start = std::chrono::system_clock::now();
 
-    auto path = aerateConfig(init);
+    auto path = aerateConfig(init, beamWidth);
     auto afterAerate = std::chrono::system_clock::now();
     logTime(0, start, afterAerate, {}, {}, {}, {}, path.size());
     if (path.empty()) {
@@ -105,7 +105,7 @@ std::pair<std::vector<Configuration>, bool> reconfigToSnake(const Configuration&
 
     path.push_back(treefy<MakeStar>(path.back()));
 
-    auto [toSnake, finishedTTS] = treeToChain(path.back());
+    auto [toSnake, finishedTTS] = treeToChain(path.back(), beamWidth);
     auto afterTTS = std::chrono::system_clock::now();
     vectorAppend(path, toSnake);
     logTime(1, start, afterAerate, afterTTS, {}, {}, {}, path.size());
@@ -113,7 +113,7 @@ std::pair<std::vector<Configuration>, bool> reconfigToSnake(const Configuration&
         return {path, false};
     }
 
-    auto [fixedSnake, finishedFP] = fixParity(path.back());
+    auto [fixedSnake, finishedFP] = fixParity(path.back(), beamWidth);
     auto afterParity = std::chrono::system_clock::now();
     vectorAppend(path, fixedSnake);
     logTime(2, start, afterAerate, afterTTS, afterParity, {}, {}, path.size());
@@ -121,7 +121,7 @@ std::pair<std::vector<Configuration>, bool> reconfigToSnake(const Configuration&
         return {path, false};
     }
 
-    auto [dockSnake, finishedFD] = fixDocks(path.back());
+    auto [dockSnake, finishedFD] = fixDocks(path.back(), beamWidth);
     auto afterDocks = std::chrono::system_clock::now();
     vectorAppend(path, dockSnake);
     logTime(3, start, afterAerate, afterTTS, afterParity, afterDocks, {}, path.size());
@@ -129,7 +129,7 @@ std::pair<std::vector<Configuration>, bool> reconfigToSnake(const Configuration&
         return {path, false};
     }
 
-    auto [flatCircle, finishedFC] = flattenCircle(path.back());
+    auto [flatCircle, finishedFC] = flattenCircle(path.back(), beamWidth);
     auto afterCircle = std::chrono::system_clock::now();
     vectorAppend(path, flatCircle);
     logTime(4, start, afterAerate, afterTTS, afterParity, afterDocks, afterCircle, path.size());
@@ -227,32 +227,32 @@ std::vector<Configuration> reconfigThroughSnake(const Configuration& from, const
  * Aerate  *
  * * * * * */
 
-std::vector<Configuration> aerateConfig(const Configuration& init) {
+std::vector<Configuration> aerateConfig(const Configuration& init, unsigned beamWidth) {
     SimpleNextGen simpleGen{};
     SpaceGridScore gridScore(unsigned(init.getIDs().size()));
     assert(fitsIn<unsigned>(init.getModules().size()));
     auto moduleCount = unsigned(init.getModules().size());
     unsigned limit = 2 * moduleCount * moduleCount;
 
-    return limitedAstar(init, simpleGen, gridScore, limit).first;
+    return limitedAstar(init, simpleGen, gridScore, limit, beamWidth).first;
 }
 
-std::vector<Configuration> aerateFromRoot(const Configuration& init) {
+std::vector<Configuration> aerateFromRoot(const Configuration& init, unsigned beamWidth) {
     SmartBisimpleOnlyRotGen smartGen{};
     AwayFromRootScore rootScore{};
     assert(fitsIn<unsigned>(init.getModules().size()));
     auto limit = 3 * unsigned(init.getModules().size());
 
-    return limitedAstar(init, smartGen, rootScore, limit).first;
+    return limitedAstar(init, smartGen, rootScore, limit, beamWidth).first;
 }
 
-std::vector<Configuration> straightenSnake(const Configuration& init) {
+std::vector<Configuration> straightenSnake(const Configuration& init, unsigned beamWidth) {
     SmartBisimpleOnlyRotGen smartGen{};
     FurthestPointsScore furthestScore{};
     assert(fitsIn<unsigned>(init.getModules().size()));
     auto limit = unsigned(init.getModules().size());
 
-    return limitedAstar(init, smartGen, furthestScore, limit).first;
+    return limitedAstar(init, smartGen, furthestScore, limit, beamWidth).first;
 }
 
 /* * * * * *
@@ -309,7 +309,7 @@ Vector findSubtreeMassCenter(const Configuration& init, ID subroot) {
     return mass;
 }
 
-std::vector<Configuration> makeEdgeSpace(const Configuration& init, ID subroot1, ID subroot2) {
+std::vector<Configuration> makeEdgeSpace(const Configuration& init, ID subroot1, ID subroot2, unsigned beamWidth) {
     Vector mass1 = findSubtreeMassCenter(init, subroot1);
     Vector mass2 = findSubtreeMassCenter(init, subroot2);
     Vector realMass = (mass1 + mass2) / 2;
@@ -323,7 +323,7 @@ std::vector<Configuration> makeEdgeSpace(const Configuration& init, ID subroot1,
     assert(fitsIn<unsigned>(init.getModules().size()));
     auto limit = 2 * unsigned(init.getModules().size());
 
-    return limitedAstar(init, smartGen, edgeScore, limit).first;
+    return limitedAstar(init, smartGen, edgeScore, limit, beamWidth).first;
 }
 
 std::unordered_set<ID> makeAllowed(const Configuration& init, ID subroot1, ID subroot2) {
@@ -335,10 +335,11 @@ std::unordered_set<ID> makeAllowed(const Configuration& init, ID subroot1, ID su
     return allowed;
 }
 
-std::pair<std::vector<Configuration>, bool> connectArm(const Configuration& init, const Edge& connection, ID subroot1, ID subroot2) {
+std::pair<std::vector<Configuration>, bool> connectArm(const Configuration& init, const Edge& connection, ID subroot1, ID subroot2,
+    unsigned beamWidth) {
     // Edge connection is from end of arm to end of arm
 
-    auto spacePath = makeEdgeSpace(init, subroot1, subroot2);
+    auto spacePath = makeEdgeSpace(init, subroot1, subroot2, beamWidth);
     std::unordered_set<ID> allowed = makeAllowed(init, subroot1, subroot2);
 
     BiParalyzedGen parGen(allowed);
@@ -346,7 +347,7 @@ std::pair<std::vector<Configuration>, bool> connectArm(const Configuration& init
     assert(fitsIn<unsigned>(init.getModules().size()));
     auto limit = unsigned(init.getModules().size());
 
-    auto [astarPath, foundGoal] = limitedAstar(spacePath.back(), parGen, connScore, limit);
+    auto [astarPath, foundGoal] = limitedAstar(spacePath.back(), parGen, connScore, limit, beamWidth);
 
     vectorAppend(spacePath, astarPath);
     if (!foundGoal)
@@ -582,7 +583,7 @@ Configuration disjoinArm(const Configuration& init, const Edge& addedEdge) {
     return optDisjoined.value();
 }
 
-std::pair<std::vector<Configuration>, bool> treeToChain(const Configuration& init) {
+std::pair<std::vector<Configuration>, bool> treeToChain(const Configuration& init, unsigned beamWidth) {
     std::unordered_map<ID, std::pair<bool, ShoeId>> allLeafs; // true for white, shoeId of real leaf
 
     std::unordered_map<ID, unsigned> subtreeSizes;
@@ -601,7 +602,7 @@ std::pair<std::vector<Configuration>, bool> treeToChain(const Configuration& ini
         if (isChain(pConfig))
             return {path, true};
 
-        snakeRes = aerateFromRoot(pConfig);
+        snakeRes = aerateFromRoot(pConfig, beamWidth);
         auto& config = snakeRes.back();
 
         const auto& matrices = config.getMatrices();
@@ -653,7 +654,7 @@ std::pair<std::vector<Configuration>, bool> treeToChain(const Configuration& ini
                 continue;
             }
 
-            std::tie(res, finished) = connectArm(config, desiredConn.value(), subRoot1, subRoot2);
+            std::tie(res, finished) = connectArm(config, desiredConn.value(), subRoot1, subRoot2, beamWidth);
             if (finished) {
                 res.emplace_back(disjoinArm(res.back(), desiredConn.value()));
                 break;
@@ -774,7 +775,7 @@ ConnectorId getEmptyConn(const Configuration& init, ID id, ShoeId shoe) {
     return XMinus;
 }
 
-std::pair<std::vector<Configuration>, bool> fixParity(const Configuration& init) {
+std::pair<std::vector<Configuration>, bool> fixParity(const Configuration& init, unsigned beamWidth) {
     std::vector<Configuration> path = {init};
     std::vector<Configuration> straightRes;
     std::vector<Configuration> res;
@@ -785,7 +786,7 @@ std::pair<std::vector<Configuration>, bool> fixParity(const Configuration& init)
         auto& preConfig = path.back();
         if (isParitySnake(preConfig))
             return {path, true};
-        straightRes = straightenSnake(preConfig);
+        straightRes = straightenSnake(preConfig, beamWidth);
         auto& config = straightRes.back();
         auto leafs = colourAndFindLeafs(config, colours);
         if (leafs.size() != 2) {
@@ -796,7 +797,7 @@ std::pair<std::vector<Configuration>, bool> fixParity(const Configuration& init)
         Edge desiredEdge(id1, side1, ZMinus, North, ZMinus, side2, id2);
 
         if (canConnect(side1, colours[id1], side2, colours[id2])) {
-            std::tie(res, finished) = connectArm(config, desiredEdge, config.getFixedId(), config.getFixedId());
+            std::tie(res, finished) = connectArm(config, desiredEdge, config.getFixedId(), config.getFixedId(), beamWidth);
             if (!finished) {
                 return {res, false};
             }
@@ -820,7 +821,7 @@ std::pair<std::vector<Configuration>, bool> fixParity(const Configuration& init)
             ShoeId wside = parityBack.side1() == A ? B : A;
             ConnectorId wconn = getEmptyConn(config, parityBack.id1(), wside);
             auto realDesire = Edge(id1, side1, ZMinus, North, wconn, wside, parityBack.id1());
-            std::tie(res, finished) = connectArm(config, realDesire, config.getFixedId(), config.getFixedId());
+            std::tie(res, finished) = connectArm(config, realDesire, config.getFixedId(), config.getFixedId(), beamWidth);
             if (!finished) {
                 return {res, false};
             }
@@ -887,10 +888,10 @@ std::optional<Edge> getNonsnakeEdge(const Configuration& config) {
     return {};
 }
 
-std::pair<std::vector<Configuration>, bool> fixDocks(const Configuration& init) {
-    auto path = straightenSnake(init);
+std::pair<std::vector<Configuration>, bool> fixDocks(const Configuration& init, unsigned beamWidth) {
+    auto path = straightenSnake(init, beamWidth);
     auto missing = missingCircle(path.back());
-    auto [circle, finished] = connectArm(path.back(), missing, path.back().getFixedId(), path.back().getFixedId());
+    auto [circle, finished] = connectArm(path.back(), missing, path.back().getFixedId(), path.back().getFixedId(), beamWidth);
     if (!finished) {
         return {circle, false};
     }
@@ -911,7 +912,7 @@ std::pair<std::vector<Configuration>, bool> fixDocks(const Configuration& init)
         const auto& config = optDisjoined.value();
 
         Edge replaceEdg(invalid.id1(), invalid.side1(), ZMinus, North, ZMinus, invalid.side2(), invalid.id2());
-        auto [res, connected] = connectArm(config, replaceEdg, config.getFixedId(), config.getFixedId());
+        auto [res, connected] = connectArm(config, replaceEdg, config.getFixedId(), config.getFixedId(), beamWidth);
         if (!connected) {
             return {res, false};
         }
@@ -938,7 +939,7 @@ Configuration fixRots(const Configuration& init) {
     return executeIfValid(init, act).value();
 }
 
-std::pair<std::vector<Configuration>, bool> flattenCircle(const Configuration& init) {
+std::pair<std::vector<Configuration>, bool> flattenCircle(const Configuration& init, unsigned beamWidth) {
     std::optional<Edge> toRemove;
     for (const auto& optEdge : init.getSpanningSucc().at(init.getFixedId())) {
         if (!optEdge.has_value())
@@ -953,7 +954,7 @@ std::pair<std::vector<Configuration>, bool> flattenCircle(const Configuration& i
         throw std::logic_error("Bug in flattenCircle!");
     }
 
-    auto res = aerateConfig(optDisjoined.value());
+    auto res = aerateConfig(optDisjoined.value(), beamWidth);
 
     std::vector<Configuration> path = {optDisjoined.value()};
     vectorAppend(path, res);
@@ -5,6 +5,7 @@
 #include <legacy/configuration/Generators.h>
 #include <Algorithms.h>
 #include "MinMaxHeap.h"
+#include "SearchArena.h"
 #include "Snake_structs.h"
 #include <limits>
 #include <queue>
@@ -23,64 +24,80 @@ void vectorAppend(std::vector<T>& base, const std::vector<T>& toApp) {
     }
 }
 
+using SearchEvalPair = std::tuple<double, SearchArena::State*>;
+
 struct SnakeEvalCompare {
 public:
-    bool operator()(const EvalPair& a, const EvalPair& b) const {
+    bool operator()(const SearchEvalPair& a, const SearchEvalPair& b) const {
         return std::get<0>(a) < std::get<0>(b);
     }
 };
 
+/**
+ * \brief Beam width of limitedAstar which does not limit the frontier
+ */
+constexpr unsigned unlimitedBeamWidth = std::numeric_limits<unsigned>::max();
+
+/**
+ * \brief Beam-limited A* towards a configuration with zero score
+ *
+ * At most \p limit states are expanded and at most \p beamWidth states are kept
+ * in the frontier; the worst states are pruned from the frontier and their
+ * memory is reclaimed unless they lie on the path to a live state. A reclaimed
+ * state is queued again only when it is reached by a shorter path, so the
+ * search visits the same states as if all of them were kept.
+ *
+ * \returns path to the goal, or to the best configuration seen, and whether the
+ * goal was reached
+ */
 template<typename GenNext, typename Score>
-std::pair<std::vector<Configuration>, bool> limitedAstar(const Configuration& init, GenNext& genNext, Score& getScore, unsigned limit) {
+std::pair<std::vector<Configuration>, bool> limitedAstar(const Configuration& init, GenNext& genNext, Score& getScore,
+    unsigned limit, unsigned beamWidth = unlimitedBeamWidth)
+{
     unsigned step = 90;
     double path_pref = 0.1;
     double free_pref = 1 - path_pref;
-    ConfigPred pred;
-    ConfigPool pool;
-
-    // Already computed shortest distance from init to configuration.
-    ConfigValue initDist;
-
-    // Shortest distance from init through this configuration to goal.
-    ConfigValue goalDist;
+    ConfigurationHash hasher;
 
     double startDist = getScore(init);
 
     if (startDist == 0)
         return {std::vector<Configuration>{init}, true};
 
-    MinMaxHeap<EvalPair, SnakeEvalCompare> queue(limit);
+    SearchArena arena;
+    MinMaxHeap<SearchEvalPair, SnakeEvalCompare> queue(static_cast<int>(std::min(limit, beamWidth)));
 
-    const Configuration* pointer = pool.insert(init);
-    const Configuration* bestConfig = pointer;
+    SearchArena::State* startState = arena.insert(init, hasher(init));
+    startState->goalDist = startDist;
+    SearchArena::State* bestState = startState;
+    arena.acquire(bestState);
     double bestScore = startDist;
     double worstDist = startDist;
 
-    initDist[pointer] = 0;
-    goalDist[pointer] = startDist;
-    pred[pointer] = pointer;
     unsigned i = 0;
-    queue.push( {goalDist[pointer], pointer} );
-
+    arena.acquire(startState);
+    queue.push({startState->goalDist, startState});
 
+    std::vector<Configuration> nextCfgs;
     while (!queue.empty() && i++ < limit) {
+        // The reference of the queue entry is kept until the expansion ends
         const auto [d, current] = queue.popMin();
-        double currDist = initDist[current];
+        double currDist = current->initDist;
 
-        std::vector<Configuration> nextCfgs;
-        genNext(*current, nextCfgs, step);
+        nextCfgs.clear();
+        genNext(current->config, nextCfgs, step);
 
         for (const auto& next : nextCfgs) {
-            const Configuration* pointerNext;
             double newEval = getScore(next);
             double newDist = path_pref * (currDist + 1) + free_pref * newEval;
             bool update = false;
 
-            if (newEval != 0 && limit <= queue.size() + i) {
+            if (newEval != 0 && (limit <= queue.size() + i || beamWidth <= queue.size())) {
                 if (newDist > worstDist)
                     continue;
                 if (!queue.empty()) {
-                    queue.popMax();
+                    const auto [_worstD, worstState] = queue.popMax();
+                    arena.release(worstState);
                     if (!queue.empty()) {
                         const auto [newWorstD, _worstConfig] = queue.max();
                         worstDist = newWorstD;
@@ -93,42 +110,49 @@ std::pair<std::vector<Configuration>, bool> limitedAstar(const Configuration& in
             if (newDist > worstDist)
                 worstDist = newDist;
 
-            if (!pool.has(next)) {
-                pointerNext = pool.insert(next);
-                initDist[pointerNext] = currDist + 1;
+            auto hash = hasher(next);
+            SearchArena::State* state = arena.find(next, hash);
+            if (!state) {
+                auto reclaimedDist = arena.reclaimedInitDist(next);
+                if (reclaimedDist && *reclaimedDist <= currDist + 1)
+                    continue;
+                state = arena.insert(next, hash);
+                state->initDist = currDist + 1;
                 update = true;
-            } else {
-                pointerNext = pool.get(next);
             }
 
             if (newEval < bestScore) {
                 bestScore = newEval;
-                bestConfig = pointerNext;
+                arena.acquire(state);
+                arena.release(bestState);
+                bestState = state;
             }
 
-            if ((currDist + 1 < initDist[pointerNext]) || update) {
-                initDist[pointerNext] = currDist + 1;
-                goalDist[pointerNext] = newDist;
-                pred[pointerNext] = current;
-                queue.push({newDist, pointerNext});
+            if ((currDist + 1 < state->initDist) || update) {
+                state->initDist = currDist + 1;
+                state->goalDist = newDist;
+                arena.setPred(state, current);
+                arena.acquire(state);
+                if (!queue.push({newDist, state}))
+                    arena.release(state);
             }
 
-            if (newEval == 0) {
-                auto path = createPath(pred, pointerNext);
-                return {path, true};
-            }
+            if (newEval == 0)
+                return {arena.path(state), true};
+
+            arena.releaseIfUnused(state);
         }
+        arena.release(current);
     }
-    auto path = createPath(pred, bestConfig);
-    return {path, false};
+    return {arena.path(bestState), false};
 }
 
 
-std::vector<Configuration> aerateConfig(const Configuration& init);
+std::vector<Configuration> aerateConfig(const Configuration& init, unsigned beamWidth = unlimitedBeamWidth);
 
-std::vector<Configuration> aerateFromRoot(const Configuration& init);
+std::vector<Configuration> aerateFromRoot(const Configuration& init, unsigned beamWidth = unlimitedBeamWidth);
 
-std::vector<Configuration> straightenSnake(const Configuration& init);
+std::vector<Configuration> straightenSnake(const Configuration& init, unsigned beamWidth = unlimitedBeamWidth);
 
 
 using chooseRootFunc = ID(const Configuration&);
@@ -163,15 +187,16 @@ inline Configuration treefy(const Configuration& init, chooseRootFunc chooseRoot
     return treed;
 }
 
-std::pair<std::vector<Configuration>, bool> connectArm(const Configuration& init, const Edge& connection, ID subroot1, ID subroot2);
+std::pair<std::vector<Configuration>, bool> connectArm(const Configuration& init, const Edge& connection, ID subroot1, ID subroot2,
+    unsigned beamWidth = unlimitedBeamWidth);
 
-std::pair<std::vector<Configuration>, bool> treeToChain(const Configuration& init);
+std::pair<std::vector<Configuration>, bool> treeToChain(const Configuration& init, unsigned beamWidth = unlimitedBeamWidth);
 
-std::pair<std::vector<Configuration>, bool> fixParity(const Configuration& init);
+std::pair<std::vector<Configuration>, bool> fixParity(const Configuration& init, unsigned beamWidth = unlimitedBeamWidth);
 
-std::pair<std::vector<Configuration>, bool> fixDocks(const Configuration& init);
+std::pair<std::vector<Configuration>, bool> fixDocks(const Configuration& init, unsigned beamWidth = unlimitedBeamWidth);
 
-std::pair<std::vector<Configuration>, bool> flattenCircle(const Configuration& init);
+std::pair<std::vector<Configuration>, bool> flattenCircle(const Configuration& init, unsigned beamWidth = unlimitedBeamWidth);
 
 using moment = std::chrono::time_point<std::chrono::system_clock>;
 
@@ -180,7 +205,13 @@ using ProgressCallback = std::function< void(
     std::optional<moment>, std::optional<moment>,
     std::optional<moment>, std::optional<moment>, size_t ) >;
 
-std::pair<std::vector<Configuration>, bool> reconfigToSnake(const Configuration& init, ProgressCallback progressCallback);
+/**
+ * \brief Reconfigure init to a flat snake
+ *
+ * \p beamWidth limits the frontier of all A* searches along the way.
+ */
+std::pair<std::vector<Configuration>, bool> reconfigToSnake(const Configuration& init, ProgressCallback progressCallback,
+    unsigned beamWidth = unlimitedBeamWidth);
 
 void appendMapped(std::vector<Configuration>& path1, const std::vector<Configuration>& path2);
 
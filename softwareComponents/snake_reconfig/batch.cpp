@@ -0,0 +1,384 @@
+#include "batch.h"
+#include "Snake_algorithms.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+std::string storePath( const std::vector< Configuration >& configs ) {
+    std::ostringstream file;
+    for ( const auto& conf : configs ) {
+        file << IO::toString( conf ) << std::endl;
+    }
+    return file.str();
+}
+
+std::vector< std::string > loadTaskSet( const std::filesystem::path& source ) {
+    std::vector< std::string > inputs;
+    if ( std::filesystem::is_directory( source ) ) {
+        for ( const auto& entry : std::filesystem::directory_iterator( source ) ) {
+            if ( entry.is_regular_file() )
+                inputs.push_back( entry.path().string() );
+        }
+        std::sort( inputs.begin(), inputs.end() );
+        return inputs;
+    }
+
+    std::ifstream f( source );
+    if ( !f )
+        throw std::runtime_error( "Cannot open task set " + source.string() );
+    auto taskSet = nlohmann::json::parse( f );
+    if ( !taskSet.is_array() )
+        throw std::runtime_error( "Task set has to be a JSON array" );
+    for ( const auto& task : taskSet ) {
+        if ( task.is_object() ) {
+            inputs.push_back( task.at( "input" ).get< std::string >() );
+        } else {
+            // Either a path or a command line with the input as the last argument
+            std::istringstream command( task.get< std::string >() );
+            std::string arg;
+            while ( command >> arg ) {}
+            if ( arg.empty() )
+                throw std::runtime_error( "Empty task in task set" );
+            inputs.push_back( arg );
+        }
+    }
+    return inputs;
+}
+
+namespace {
+
+using ProgressJsonCallback = std::function< void( const nlohmann::json& ) >;
+
+struct TaskResult {
+    // One of finished, failed, timeout, memory, crashed, error
+    std::string status = "error";
+    nlohmann::json result = nullptr;
+    nlohmann::json lastProgress = nullptr;
+    std::string error;
+    std::chrono::milliseconds wallTime{};
+};
+
+/**
+ * \brief Compute the reconfiguration and return the log object of a single run
+ */
+nlohmann::json runTask( const std::string& input, const BatchOptions& options,
+                        const ProgressJsonCallback& onProgress )
+{
+    std::ifstream initInput( input );
+    if ( !initInput )
+        throw std::runtime_error( "Cannot open input " + input );
+    Configuration init;
+    IO::readConfiguration( initInput, init );
+    init.computeMatrices();
+
+    nlohmann::json progress;
+    auto [ reconfigPath, success ] = reconfigToSnake( init, [ & ]( auto... args ) {
+        progress = logProgressJson( std::forward< decltype( args ) >( args )... );
+        onProgress( progress );
+    }, options.beamWidth );
+
+    progress[ "input" ] = input;
+    if ( success && options.storePaths )
+        progress[ "path" ] = storePath( reconfigPath );
+    return progress;
+}
+
+void setStatusFromResult( TaskResult& task ) {
+    task.status = task.result.value( "progress", -1 ) == 5 ? "finished" : "failed";
+}
+
+TaskResult runInThread( const std::string& input, const BatchOptions& options ) {
+    TaskResult task;
+    try {
+        task.result = runTask( input, options, []( const nlohmann::json& ) {} );
+        setStatusFromResult( task );
+    } catch ( const std::bad_alloc& ) {
+        task.status = "memory";
+    } catch ( const std::exception& e ) {
+        task.status = "error";
+        task.error = e.what();
+    }
+    return task;
+}
+
+void writeAll( int fd, const char* data, std::size_t size ) {
+    while ( size > 0 ) {
+        auto written = write( fd, data, size );
+        if ( written < 0 ) {
+            if ( errno == EINTR )
+                continue;
+            return;
+        }
+        data += written;
+        size -= static_cast< std::size_t >( written );
+    }
+}
+
+/**
+ * \brief Close all file descriptors except the standard ones and `keep`
+ *
+ * Other pool threads fork their own tasks concurrently, so the child may
+ * inherit the pipes of its siblings. A pipe reaches EOF only when all copies of
+ * its write end are closed, so the child must not keep them open.
+ */
+void closeForeignFds( int keep ) {
+    std::vector< int > fds;
+    std::error_code ec;
+    for ( const auto& entry : std::filesystem::directory_iterator( "/proc/self/fd", ec ) ) {
+        int fd = std::atoi( entry.path().filename().c_str() );
+        if ( fd > STDERR_FILENO && fd != keep )
+            fds.push_back( fd );
+    }
+    // The descriptor of the directory iterator is already closed, ignore it
+    for ( int fd : fds )
+        close( fd );
+}
+
+[[noreturn]] void runChild( int fd, const std::string& input, const BatchOptions& options ) {
+    closeForeignFds( fd );
+
+    // Each message is a single JSON line, so the parent knows the progress
+    // reached even if the child is killed
+    auto send = [ fd ]( const nlohmann::json& message ) {
+        auto line = message.dump() + "\n";
+        writeAll( fd, line.data(), line.size() );
+    };
+    try {
+        // The threads are started before the memory limit, their stacks count into it
+        restartGeneratorThreadsAfterFork();
+        if ( options.memoryLimitMiB ) {
+            rlimit limit;
+            limit.rlim_cur = limit.rlim_max = *options.memoryLimitMiB << 20;
+            setrlimit( RLIMIT_AS, &limit );
+        }
+
+        auto result = runTask( input, options, [ & ]( const nlohmann::json& progress ) {
+            send( { { "progress", progress } } );
+        } );
+        send( { { "result", result } } );
+    } catch ( const std::bad_alloc& ) {
+        // Do not allocate when we are out of memory
+        static const char message[] = "{\"memory\":true}\n";
+        writeAll( fd, message, sizeof( message ) - 1 );
+    } catch ( const std::exception& e ) {
+        send( { { "error", e.what() } } );
+    }
+    close( fd );
+    _exit( 0 );
+}
+
+/**
+ * \brief Run the task in a forked process with memory limit and timeout
+ *
+ * The child is forked from the already running batch, so it pays neither the
+ * process startup nor the dynamic loading.
+ */
+TaskResult runIsolated( const std::string& input, const BatchOptions& options ) {
+    int fds[ 2 ];
+    if ( pipe2( fds, O_CLOEXEC ) != 0 )
+        throw std::system_error( errno, std::generic_category(), "Cannot create pipe" );
+    pid_t pid = fork();
+    if ( pid < 0 ) {
+        close( fds[ 0 ] );
+        close( fds[ 1 ] );
+        throw std::system_error( errno, std::generic_category(), "Cannot fork" );
+    }
+    if ( pid == 0 )
+        runChild( fds[ 1 ], input, options );
+    close( fds[ 1 ] );
+
+    TaskResult task;
+    bool received = false;
+    auto processLine = [ & ]( const std::string& line ) {
+        auto message = nlohmann::json::parse( line, nullptr, false );
+        if ( message.is_discarded() )
+            return;
+        if ( message.contains( "progress" ) ) {
+            task.lastProgress = message[ "progress" ];
+        } else if ( message.contains( "result" ) ) {
+            task.result = message[ "result" ];
+            setStatusFromResult( task );
+            received = true;
+        } else if ( message.contains( "memory" ) ) {
+            task.status = "memory";
+            received = true;
+        } else if ( message.contains( "error" ) ) {
+            task.status = "error";
+            task.error = message[ "error" ].get< std::string >();
+            received = true;
+        }
+    };
+
+    auto deadline = std::chrono::steady_clock::now()
+                  + options.timeout.value_or( std::chrono::seconds::zero() );
+    bool timedOut = false;
+    std::string buffer;
+    // Stop at the final record, the child only exits after sending it
+    while ( !received ) {
+        int waitMs = -1;
+        if ( options.timeout ) {
+            auto remaining = std::chrono::duration_cast< std::chrono::milliseconds >(
+                deadline - std::chrono::steady_clock::now() );
+            if ( remaining.count() <= 0 ) {
+                timedOut = true;
+                kill( pid, SIGKILL );
+                break;
+            }
+            waitMs = static_cast< int >( std::min< long long >( remaining.count(), 1000 ) );
+        }
+        pollfd pfd{ fds[ 0 ], POLLIN, 0 };
+        int ready = poll( &pfd, 1, waitMs );
+        if ( ready < 0 && errno == EINTR )
+            continue;
+        if ( ready == 0 )
+            continue;
+        char chunk[ 4096 ];
+        auto count = read( fds[ 0 ], chunk, sizeof( chunk ) );
+        if ( count < 0 && errno == EINTR )
+            continue;
+        if ( count <= 0 )
+            break;
+        buffer.append( chunk, static_cast< std::size_t >( count ) );
+        std::size_t lineEnd;
+        while ( !received && ( lineEnd = buffer.find( '\n' ) ) != std::string::npos ) {
+            processLine( buffer.substr( 0, lineEnd ) );
+            buffer.erase( 0, lineEnd + 1 );
+        }
+    }
+    close( fds[ 0 ] );
+
+    int status = 0;
+    while ( waitpid( pid, &status, 0 ) < 0 && errno == EINTR ) {}
+
+    if ( received )
+        return task;
+    if ( timedOut ) {
+        task.status = "timeout";
+    } else if ( WIFSIGNALED( status ) ) {
+        // Allocation failures outside of operator new end up here as well
+        task.status = options.memoryLimitMiB ? "memory" : "crashed";
+        task.error = "Killed by signal " + std::to_string( WTERMSIG( status ) );
+    } else {
+        task.status = "crashed";
+        task.error = "Exited with status " + std::to_string( WEXITSTATUS( status ) )
+                   + " without a result";
+    }
+    return task;
+}
+
+/**
+ * \brief Thread-safe writer of the batch log
+ */
+class BatchLog {
+public:
+    BatchLog( std::ostream& out, BatchLogFormat format ): _out( out ), _format( format ) {
+        if ( _format == BatchLogFormat::Json )
+            _out << "{\"tasks\": [\n";
+        else
+            _out << "input;status;wallTime;progress;aerate;tts;parity;docks;circle;pathLen\n";
+        _out.flush();
+    }
+
+    void write( const std::string& input, const TaskResult& task ) {
+        std::lock_guard lock( _mutex );
+        if ( _format == BatchLogFormat::Json )
+            _writeJson( input, task );
+        else
+            _writeCsv( input, task );
+        _out.flush();
+    }
+
+    void finish() {
+        if ( _format == BatchLogFormat::Json )
+            _out << "\n]}\n";
+        _out.flush();
+    }
+
+private:
+    void _writeJson( const std::string& input, const TaskResult& task ) {
+        nlohmann::json j = {
+            { "input", input },
+            { "status", task.status },
+            { "wallTime", task.wallTime.count() },
+            { "result", task.result }
+        };
+        if ( !task.lastProgress.is_null() && task.result.is_null() )
+            j[ "lastProgress" ] = task.lastProgress;
+        if ( !task.error.empty() )
+            j[ "error" ] = task.error;
+        if ( !_first )
+            _out << ",\n";
+        _first = false;
+        _out << j.dump();
+    }
+
+    void _writeCsv( const std::string& input, const TaskResult& task ) {
+        const auto& progress = task.result.is_null() ? task.lastProgress : task.result;
+        _out << input << ";" << task.status << ";" << task.wallTime.count();
+        for ( auto key : { "progress", "aerate", "tts", "parity", "docks", "circle", "pathLen" } ) {
+            _out << ";";
+            if ( progress.is_object() && progress.contains( key ) && !progress[ key ].is_null() )
+                _out << progress[ key ].dump();
+        }
+        _out << "\n";
+    }
+
+    std::ostream& _out;
+    BatchLogFormat _format;
+    std::mutex _mutex;
+    bool _first = true;
+};
+
+} // namespace
+
+int runBatch( const std::vector< std::string >& inputs, const BatchOptions& options,
+              std::ostream& log )
+{
+    bool isolate = options.timeout.has_value() || options.memoryLimitMiB.has_value();
+    BatchLog batchLog( log, options.format );
+    std::atomic< std::size_t > nextTask = 0;
+    std::atomic< int > unfinished = 0;
+
+    auto worker = [ & ] {
+        for ( auto i = nextTask++; i < inputs.size(); i = nextTask++ ) {
+            auto start = std::chrono::steady_clock::now();
+            TaskResult task;
+            try {
+                task = isolate ? runIsolated( inputs[ i ], options ) : runInThread( inputs[ i ], options );
+            } catch ( const std::exception& e ) {
+                task.status = "error";
+                task.error = e.what();
+            }
+            task.wallTime = std::chrono::duration_cast< std::chrono::milliseconds >(
+                std::chrono::steady_clock::now() - start );
+            if ( task.status != "finished" )
+                unfinished++;
+            batchLog.write( inputs[ i ], task );
+        }
+    };
+
+    {
+        std::vector< std::jthread > workers;
+        for ( unsigned i = 0; i < std::max( options.jobs, 1u ); i++ )
+            workers.emplace_back( worker );
+    }
+    batchLog.finish();
+    return unfinished;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <legacy/configuration/Configuration.h>
+#include "Snake_algorithms.h"
+
+enum class BatchLogFormat { Json, Csv };
+
+struct BatchOptions {
+    unsigned jobs = 1;
+    // Tasks run in forked worker processes when any of the limits is set
+    std::optional< std::chrono::seconds > timeout;
+    std::optional< std::size_t > memoryLimitMiB;
+    BatchLogFormat format = BatchLogFormat::Json;
+    bool storePaths = true;
+    unsigned beamWidth = unlimitedBeamWidth;
+};
+
+std::string storePath( const std::vector< Configuration >& configs );
+
+/**
+ * \brief Collect input files of a batch
+ *
+ * The source is either a directory (all regular files in it are inputs) or a
+ * task-set JSON. The task set is an array whose items are either paths, objects
+ * with an "input" field, or snakeReconfig command lines as produced by
+ * `experiments/snake_reconfig/generateTaskSet.py`; the last argument of a
+ * command line is the input.
+ */
+std::vector< std::string > loadTaskSet( const std::filesystem::path& source );
+
+/**
+ * \brief Run reconfigToSnake on all inputs using a pool of `options.jobs` threads
+ *
+ * Results are streamed into `log` as soon as each task is done. In the JSON
+ * format, the log is an object with "tasks" array; each task carries its
+ * "input", "status", "wallTime" and the "result" in the format of
+ * logProgressJson (extended by "input" and "path" like the log of a single
+ * run). The result is null for tasks that hit a limit, their last reported
+ * progress is stored in "lastProgress" instead.
+ *
+ * \returns number of tasks that did not finish successfully
+ */
+int runBatch( const std::vector< std::string >& inputs, const BatchOptions& options,
+              std::ostream& log );
@@ -1,8 +1,5 @@
 set -x
-LOG=log.csv
-touch $LOG
-FILES=../data/snakeBench/*
-for f in $FILES
-do
-    ./snake_reconfig/snakeReconfig $f $LOG "${f}.out"
-done
+LOG=log.json
+# All inputs are processed in a single process, see snakeReconfig --help for
+# the thread count and per-task limits
+./snake_reconfig/snakeReconfig --batch ../data/snakeBench --log $LOG "$@"
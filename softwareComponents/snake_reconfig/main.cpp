@@ -1,25 +1,40 @@
+#include <algorithm>
 #include <exception>
 #include <fstream>
 #include <tuple>
 #include <iomanip>
 #include <sstream>
+#include <thread>
 #include <legacy/configuration/Configuration.h>
 #include <legacy/configuration/IO.h>
 #include "Snake_algorithms.h"
+#include "batch.h"
 #include <dimcli/cli.h>
 
 Dim::Cli cli;
-auto& inputCfgFile = cli.opt< std::string >( "<INPUT_CFG>" );
+auto& inputCfgFile = cli.opt< std::string >( "[INPUT_CFG]" );
 auto& logFile = cli.opt< std::string >( "l log" );
 auto& outputFile = cli.opt< std::string >( "[OUTPUT_FILE]" );
 
-std::string storePath(const std::vector<Configuration>& configs ) {
-    std::ostringstream file;
-    for (const auto& conf : configs) {
-        file << IO::toString( conf ) << std::endl;
-    }
-    return file.str();
-}
+auto& batchSource = cli.opt< std::string >( "batch" )
+    .desc( "Task-set JSON or directory of inputs to process in a single run,"
+           " exits with 1 if any of the tasks does not finish" );
+auto& jobs = cli.opt< unsigned >( "j jobs", std::max( std::thread::hardware_concurrency(), 1u ) )
+    .desc( "Number of tasks processed in parallel in batch mode" );
+auto& timeout = cli.opt< unsigned >( "timeout", 0 )
+    .desc( "Per-task timeout in seconds in batch mode, 0 for none" );
+auto& memoryLimit = cli.opt< unsigned >( "memory", 0 )
+    .desc( "Per-task memory cap in MiB in batch mode, 0 for none" );
+auto& successorThreads = cli.opt< unsigned >( "threads", 1 )
+    .desc( "Threads generating successors within a task, 0 for all hardware threads" );
+auto& beamWidth = cli.opt< unsigned >( "beam", 0 )
+    .desc( "Maximal number of states kept in the frontier of each A* search, 0 for no limit" );
+auto& storePaths = cli.opt< bool >( "paths", true )
+    .desc( "Store reconfiguration paths in the batch log, --no-paths to omit them" );
+auto& logFormat = cli.opt< std::string >( "format", "json" )
+    .choice( "json", "json" )
+    .choice( "csv", "csv" )
+    .desc( "Format of the batch log" );
 
 nlohmann::json gCurrentProgress;
 std::string gLogPath;
@@ -32,11 +47,54 @@ void finishLog() {
     f << std::setw( 4 ) << gCurrentProgress << "\n";
 }
 
+unsigned beamWidthOrUnlimited() {
+    return *beamWidth == 0 ? unlimitedBeamWidth : *beamWidth;
+}
+
+int runBatchMode() {
+    BatchOptions options;
+    options.jobs = *jobs;
+    if ( *timeout != 0 )
+        options.timeout = std::chrono::seconds( *timeout );
+    if ( *memoryLimit != 0 )
+        options.memoryLimitMiB = *memoryLimit;
+    options.format = *logFormat == "csv" ? BatchLogFormat::Csv : BatchLogFormat::Json;
+    options.storePaths = *storePaths;
+    options.beamWidth = beamWidthOrUnlimited();
+
+    auto inputs = loadTaskSet( *batchSource );
+    int unfinished = 0;
+    if ( !logFile ) {
+        unfinished = runBatch( inputs, options, std::cout );
+    } else {
+        std::ofstream log( *logFile );
+        if ( !log ) {
+            std::cerr << "Cannot open log file " << *logFile << "\n";
+            return 1;
+        }
+        unfinished = runBatch( inputs, options, log );
+    }
+    if ( unfinished > 0 ) {
+        std::cerr << unfinished << " of " << inputs.size() << " tasks did not finish\n";
+        return 1;
+    }
+    return 0;
+}
+
 int main(int argc, char* argv[])
 {
     if ( !cli.parse( argc, argv ) )
         return cli.printError( std::cerr );
 
+    setGeneratorThreads( *successorThreads );
+
+    if ( batchSource )
+        return runBatchMode();
+    if ( !inputCfgFile ) {
+        std::cerr << "Either INPUT_CFG or --batch has to be specified\n";
+        return 1;
+    }
+
     gLogPath = *logFile;
 
     finishLog();
@@ -49,7 +107,7 @@ int main(int argc, char* argv[])
     auto [reconfigPath, success] = reconfigToSnake(init, [&]( auto... args ) {
         gCurrentProgress = logProgressJson( std::forward< decltype( args ) >( args )... );
         finishLog();
-    });
+    }, beamWidthOrUnlimited());
 
     auto path = storePath( reconfigPath );
 
@@ -64,4 +122,4 @@ int main(int argc, char* argv[])
     finishLog();
 
     return 0;
-}
\ No newline at end of file
+}
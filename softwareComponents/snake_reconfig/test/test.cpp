@@ -1,5 +1,7 @@
 #include <catch2/catch.hpp>
 #include "../MinMaxHeap.h"
+#include "../Snake_algorithms.h"
+#include <sstream>
 
 class IntComp{
 public:
@@ -145,3 +147,207 @@ TEST_CASE("Unique Ptr to Ints") {
     REQUIRE(*min == 10);
     REQUIRE(mmh.empty());
 }
+
+class CountingNextGen {
+public:
+    void operator()(const Configuration& config, std::vector<Configuration>& res, unsigned step) {
+        ++expansions;
+        gen(config, res, step);
+    }
+
+    SimpleNextGen gen;
+    unsigned expansions = 0;
+};
+
+Configuration m10Config() {
+    std::istringstream input(
+        "C\n"
+        "M 9 0 0 90\nM 8 90 90 0\nM 7 0 90 90\nM 6 0 0 -90\nM 5 0 0 180\n"
+        "M 4 0 0 180\nM 3 0 -90 180\nM 2 90 -90 0\nM 1 90 90 90\nM 0 90 0 90\n"
+        "E 8 B -Z N -Z A 9\nE 7 B -Z N -Z A 8\nE 6 B +X W +X A 7\nE 5 B -Z N -Z A 6\n"
+        "E 4 A -X E +X B 5\nE 2 B -Z E +X A 3\nE 0 A +X S -X B 6\nE 0 A -X W -X B 3\n"
+        "E 0 B -Z N -Z A 1\n");
+    Configuration init;
+    IO::readConfiguration(input, init);
+    init.computeMatrices();
+    return init;
+}
+
+TEST_CASE("Beam width limits limitedAstar") {
+    Configuration init = m10Config();
+    const unsigned limit = 30;
+
+    CountingNextGen unlimitedGen;
+    SpaceGridScore unlimitedScore(unsigned(init.getIDs().size()));
+    auto [unlimitedPath, unlimitedFound] = limitedAstar(init, unlimitedGen, unlimitedScore, limit);
+    REQUIRE(!unlimitedFound);
+    REQUIRE(unlimitedGen.expansions == limit);
+
+    // A single state in the frontier is dropped as soon as all its successors are worse
+    CountingNextGen beamGen;
+    SpaceGridScore beamScore(unsigned(init.getIDs().size()));
+    auto [beamPath, beamFound] = limitedAstar(init, beamGen, beamScore, limit, 1);
+    REQUIRE(beamGen.expansions < limit);
+    REQUIRE(!beamPath.empty());
+    REQUIRE(beamPath.front() == init);
+}
+
+class ReferenceEvalCompare {
+public:
+    bool operator()(const EvalPair& a, const EvalPair& b) const {
+        return std::get<0>(a) < std::get<0>(b);
+    }
+};
+
+// limitedAstar as it was before the states were kept in SearchArena - all the
+// configurations ever seen stay in the pool
+template<typename GenNext, typename Score>
+std::pair<std::vector<Configuration>, bool> referenceAstar(const Configuration& init, GenNext& genNext, Score& getScore, unsigned limit) {
+    unsigned step = 90;
+    double path_pref = 0.1;
+    double free_pref = 1 - path_pref;
+    ConfigPred pred;
+    ConfigPool pool;
+    ConfigValue initDist;
+    ConfigValue goalDist;
+
+    double startDist = getScore(init);
+    if (startDist == 0)
+        return {std::vector<Configuration>{init}, true};
+
+    MinMaxHeap<EvalPair, ReferenceEvalCompare> queue(limit);
+    const Configuration* pointer = pool.insert(init);
+    const Configuration* bestConfig = pointer;
+    double bestScore = startDist;
+    double worstDist = startDist;
+
+    initDist[pointer] = 0;
+    goalDist[pointer] = startDist;
+    pred[pointer] = pointer;
+    unsigned i = 0;
+    queue.push( {goalDist[pointer], pointer} );
+
+    while (!queue.empty() && i++ < limit) {
+        const auto [d, current] = queue.popMin();
+        double currDist = initDist[current];
+
+        std::vector<Configuration> nextCfgs;
+        genNext(*current, nextCfgs, step);
+
+        for (const auto& next : nextCfgs) {
+            const Configuration* pointerNext;
+            double newEval = getScore(next);
+            double newDist = path_pref * (currDist + 1) + free_pref * newEval;
+            bool update = false;
+
+            if (newEval != 0 && limit <= queue.size() + i) {
+                if (newDist > worstDist)
+                    continue;
+                if (!queue.empty()) {
+                    queue.popMax();
+                    if (!queue.empty()) {
+                        const auto [newWorstD, _worstConfig] = queue.max();
+                        worstDist = newWorstD;
+                    } else {
+                        worstDist = newDist;
+                    }
+                }
+            }
+
+            if (newDist > worstDist)
+                worstDist = newDist;
+
+            if (!pool.has(next)) {
+                pointerNext = pool.insert(next);
+                initDist[pointerNext] = currDist + 1;
+                update = true;
+            } else {
+                pointerNext = pool.get(next);
+            }
+
+            if (newEval < bestScore) {
+                bestScore = newEval;
+                bestConfig = pointerNext;
+            }
+
+            if ((currDist + 1 < initDist[pointerNext]) || update) {
+                initDist[pointerNext] = currDist + 1;
+                goalDist[pointerNext] = newDist;
+                pred[pointerNext] = current;
+                queue.push({newDist, pointerNext});
+            }
+
+            if (newEval == 0)
+                return {createPath(pred, pointerNext), true};
+        }
+    }
+    return {createPath(pred, bestConfig), false};
+}
+
+TEST_CASE("limitedAstar with unlimited beam matches the search keeping all states") {
+    Configuration init = m10Config();
+    auto limit = GENERATE(10u, 30u, 100u, 300u);
+    CAPTURE(limit);
+
+    CountingNextGen referenceGen;
+    SpaceGridScore referenceScore(unsigned(init.getIDs().size()));
+    auto [referencePath, referenceFound] = referenceAstar(init, referenceGen, referenceScore, limit);
+
+    CountingNextGen arenaGen;
+    SpaceGridScore arenaScore(unsigned(init.getIDs().size()));
+    auto [arenaPath, arenaFound] = limitedAstar(init, arenaGen, arenaScore, limit);
+
+    REQUIRE(arenaGen.expansions == referenceGen.expansions);
+    REQUIRE(arenaFound == referenceFound);
+    REQUIRE(arenaPath == referencePath);
+}
+
+TEST_CASE("SearchArena reclaims unreferenced states") {
+    Configuration a;
+    a.addModule(0, 0, 0, 1);
+    Configuration b;
+    b.addModule(90, 0, 0, 1);
+    Configuration c;
+    c.addModule(0, 90, 0, 1);
+
+    SearchArena arena;
+    auto* root = arena.insert(a, 1);
+    arena.acquire(root);
+    auto* child = arena.insert(b, 2);
+    child->initDist = 1;
+    arena.setPred(child, root);
+    arena.acquire(child);
+    REQUIRE(arena.path(child) == std::vector<Configuration>{a, b});
+
+    // The child keeps its predecessor alive
+    arena.release(root);
+    REQUIRE(arena.size() == 2);
+    REQUIRE(arena.find(a, 1) == root);
+    REQUIRE(!arena.reclaimedInitDist(a));
+
+    // Releasing the child reclaims the whole chain
+    arena.release(child);
+    REQUIRE(arena.size() == 0);
+    REQUIRE(arena.find(a, 1) == nullptr);
+    REQUIRE(arena.find(b, 2) == nullptr);
+    REQUIRE(arena.reclaimedInitDist(a) == 0);
+    REQUIRE(arena.reclaimedInitDist(b) == 1);
+    REQUIRE(!arena.reclaimedInitDist(c));
+
+    // Configurations differing only in the edges are told apart
+    Configuration pair;
+    pair.addModule(0, 0, 0, 1);
+    pair.addModule(0, 0, 0, 2);
+    Configuration connected = pair;
+    connected.addEdge({1, A, XPlus, North, XMinus, B, 2});
+    REQUIRE(ConfigurationHash()(pair) == ConfigurationHash()(connected));
+    REQUIRE(SearchArena::fingerprint(pair) != SearchArena::fingerprint(connected));
+
+    // Reclaimed slots are reused
+    auto* other = arena.insert(c, 3);
+    REQUIRE(arena.find(c, 3) == other);
+    REQUIRE(arena.size() == 1);
+    REQUIRE(arena.capacity() == 2);
+    arena.releaseIfUnused(other);
+    REQUIRE(arena.size() == 0);
+}
@@ -1,14 +1,68 @@
 #pragma once
 
 #include <stm32g0xx_hal_crc.h>
+#include <drivers/dma.hpp>
+#include <function2/function2.hpp>
 #include <system/assert.hpp>
+#include <system/softCrc.hpp>
 
+/**
+ * Driver for the hardware CRC unit. The unit is configured to produce the same
+ * checksums as SoftCrc.
+ *
+ * Short buffers are best computed synchronously via compute(). Large buffers
+ * can be fed to the unit via DMA using computeAsync(), which leaves the CPU
+ * free during the computation. As there is only a single unit, computeAsync()
+ * falls back to SoftCrc when the unit is busy or no DMA channel was attached.
+ */
 class Crc {
 public:
+    using Callback = fu2::unique_function< void( uint32_t ) >;
+
     static uint32_t compute( uint8_t *begin, int length ) {
+        assert( !busy() && "CRC unit is busy with DMA computation" );
         return HAL_CRC_Calculate( &instance()._periph,
             reinterpret_cast< uint32_t *>( begin ), length );
     }
+
+    /**
+     * Attach a DMA channel used for feeding data in computeAsync().
+     */
+    static void useDma( Dma::Channel channel ) {
+        instance()._setupDma( std::move( channel ) );
+    }
+
+    /**
+     * Return true if there is a DMA computation in progress.
+     */
+    static bool busy() {
+        return instance()._busy;
+    }
+
+    /**
+     * Compute the CRC of given buffer and pass it to the callback.
+     *
+     * If the buffer is fed via DMA, the callback is invoked from the DMA
+     * interrupt and the buffer has to remain valid until then. Otherwise, the
+     * callback is invoked before the function returns.
+     */
+    static void computeAsync( const uint8_t *begin, int length, Callback callback ) {
+        Crc& self = instance();
+        if ( !self._dma || self._busy || length < self._dmaThreshold ) {
+            callback( SoftCrc::compute( begin, length ) );
+            return;
+        }
+        self._startDma( begin, length, std::move( callback ) );
+    }
+
+    /**
+     * Set the minimal length of a buffer to be fed via DMA; shorter buffers
+     * are computed in software as the DMA setup overhead dominates.
+     */
+    static void setDmaThreshold( int length ) {
+        instance()._dmaThreshold = length;
+    }
+
 private:
     Crc() {
         _periph.Instance = CRC;
@@ -28,5 +82,46 @@ private:
         return crc;
     }
 
+    void _setupDma( Dma::Channel channel ) {
+        _dma = std::move( channel );
+        assert( _dma );
+        _dma.disable();
+
+        // Memory-to-memory transfer: the "peripheral" side is the source
+        // buffer, the "memory" side is the data register of the CRC unit
+        LL_DMA_SetPeriphRequest( _dma, _dma, LL_DMAMUX_REQ_MEM2MEM );
+        LL_DMA_SetDataTransferDirection( _dma, _dma, LL_DMA_DIRECTION_MEMORY_TO_MEMORY );
+        _dma.setPriority( LL_DMA_PRIORITY_LOW );
+        LL_DMA_SetMode( _dma, _dma, LL_DMA_MODE_NORMAL );
+        LL_DMA_SetPeriphIncMode( _dma, _dma, LL_DMA_PERIPH_INCREMENT );
+        LL_DMA_SetMemoryIncMode( _dma, _dma, LL_DMA_MEMORY_NOINCREMENT );
+        LL_DMA_SetPeriphSize( _dma, _dma, LL_DMA_PDATAALIGN_BYTE );
+        LL_DMA_SetMemorySize( _dma, _dma, LL_DMA_MDATAALIGN_BYTE );
+        LL_DMA_SetMemoryAddress( _dma, _dma, uint32_t( &_periph.Instance->DR ) );
+
+        _dma.onComplete( [&] {
+            _dma.disable();
+            uint32_t crc = _periph.Instance->DR;
+            Callback callback = std::move( _callback );
+            _busy = false;
+            callback( crc );
+        } );
+        _dma.enableInterrupt();
+    }
+
+    void _startDma( const uint8_t *begin, int length, Callback callback ) {
+        assert( !_dma.isEnabled() );
+        _busy = true;
+        _callback = std::move( callback );
+        __HAL_CRC_DR_RESET( &_periph );
+        LL_DMA_SetPeriphAddress( _dma, _dma, uint32_t( begin ) );
+        LL_DMA_SetDataLength( _dma, _dma, length );
+        _dma.enable();
+    }
+
     CRC_HandleTypeDef _periph;
+    Dma::Channel _dma;
+    Callback _callback;
+    volatile bool _busy = false;
+    int _dmaThreshold = 64;
 };
@@ -36,33 +36,24 @@ public:
     void clear() noexcept { _container.clear(); }
 
     std::pair< iterator, bool > insert( const_reference value ) {
-        auto it = find( value.first );
-        if ( it != cend() )
+        auto it = std::lower_bound( begin(), end(), value.first, keyComparator() );
+        if ( it != end() && !Compare()( value.first, it->first ) )
             return { it, false };
-        _container.push_back( value );
-        std::sort( begin(), end(), comparator() );
-        return { find( value.first ), true };
+        return { _container.insert( it, value ), true };
     }
 
     template< class... Args >
     std::pair< iterator, bool > emplace( Args&&... args ) {
-        _container.emplace_back( std::forward< Args >( args )... );
-        auto it = std::lower_bound( begin(), end() - 1, _container.back(), comparator() );
-        if ( it == end() - 1 || it->first != _container.back().first ) {
-            auto key = _container.back().first;
-            std::sort( begin(), end(), comparator() );
-            return { find( key ), true };
-        }
-        auto key = it->first;
-        _container.pop_back();
-        return { find( key ), false };
+        value_type value( std::forward< Args >( args )... );
+        auto it = std::lower_bound( begin(), end(), value.first, keyComparator() );
+        if ( it != end() && !Compare()( value.first, it->first ) )
+            return { it, false };
+        return { _container.insert( it, std::move( value ) ), true };
     }
 
-    void erase( iterator pos ) {
-        using std::swap;
-        swap( *pos, _container.back() );
-        _container.pop_back();
-        std::sort( begin(), end(), comparator() );
+    // Keep the order by shifting the tail instead of re-sorting
+    iterator erase( iterator pos ) {
+        return _container.erase( pos );
     }
 
     size_type erase( const key_type& key ) {
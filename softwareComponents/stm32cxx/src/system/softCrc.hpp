@@ -0,0 +1,85 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace detail {
+
+using SoftCrcTables = std::array< std::array< uint32_t, 256 >, 8 >;
+
+constexpr SoftCrcTables buildSoftCrcTables( uint32_t polynomial ) {
+    SoftCrcTables tables{};
+    for ( uint32_t i = 0; i != 256; i++ ) {
+        uint32_t crc = i << 24;
+        for ( int j = 0; j != 8; j++ )
+            crc = ( crc & 0x80000000 ) ? ( crc << 1 ) ^ polynomial : crc << 1;
+        tables[ 0 ][ i ] = crc;
+    }
+    for ( int k = 1; k != 8; k++ ) {
+        for ( uint32_t i = 0; i != 256; i++ ) {
+            uint32_t prev = tables[ k - 1 ][ i ];
+            tables[ k ][ i ] = ( prev << 8 ) ^ tables[ 0 ][ prev >> 24 ];
+        }
+    }
+    return tables;
+}
+
+} // namespace detail
+
+/**
+ * Software implementation of CRC32 which produces the same checksums as the
+ * hardware CRC unit in its default configuration (see drivers/crc.hpp) - i.e.,
+ * polynomial 0x04C11DB7, initial value 0xFFFFFFFF, no input nor output
+ * reflection and no final XOR (known as CRC-32/MPEG-2).
+ *
+ * The computation uses slicing-by-8 tables, so it processes eight bytes per
+ * step. The tables are computed at compile time and take 8 KiB of flash.
+ *
+ * The implementation does not depend on HAL, so it can be used on the host
+ * (e.g., in tests or in tools working with blobs) or as a fallback on MCUs
+ * when the hardware unit is busy.
+ */
+class SoftCrc {
+public:
+    static constexpr uint32_t POLYNOMIAL = 0x04C11DB7;
+    static constexpr uint32_t INIT = 0xFFFFFFFF;
+
+    static uint32_t compute( const uint8_t *begin, int length ) {
+        return update( INIT, begin, length );
+    }
+
+    /**
+     * Continue computation of a CRC given the value computed for the
+     * preceding data.
+     */
+    static uint32_t update( uint32_t crc, const uint8_t *data, int length ) {
+        const auto& t = _tables;
+        for ( ; length >= 8; length -= 8, data += 8 ) {
+            crc ^= uint32_t( data[ 0 ] ) << 24 | uint32_t( data[ 1 ] ) << 16
+                 | uint32_t( data[ 2 ] ) << 8  | uint32_t( data[ 3 ] );
+            crc = t[ 7 ][ crc >> 24 ] ^ t[ 6 ][ ( crc >> 16 ) & 0xFF ]
+                ^ t[ 5 ][ ( crc >> 8 ) & 0xFF ] ^ t[ 4 ][ crc & 0xFF ]
+                ^ t[ 3 ][ data[ 4 ] ] ^ t[ 2 ][ data[ 5 ] ]
+                ^ t[ 1 ][ data[ 6 ] ] ^ t[ 0 ][ data[ 7 ] ];
+        }
+        for ( ; length > 0; length--, data++ )
+            crc = ( crc << 8 ) ^ t[ 0 ][ ( crc >> 24 ) ^ *data ];
+        return crc;
+    }
+
+    /**
+     * Reference bit-by-bit implementation. Slow, intended only for testing.
+     */
+    static uint32_t computeBitwise( const uint8_t *data, int length ) {
+        uint32_t crc = INIT;
+        for ( ; length > 0; length--, data++ ) {
+            crc ^= uint32_t( *data ) << 24;
+            for ( int i = 0; i != 8; i++ )
+                crc = ( crc & 0x80000000 ) ? ( crc << 1 ) ^ POLYNOMIAL : crc << 1;
+        }
+        return crc;
+    }
+
+private:
+    static constexpr detail::SoftCrcTables _tables = detail::buildSoftCrcTables( POLYNOMIAL );
+};
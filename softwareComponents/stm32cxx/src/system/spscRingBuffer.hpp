@@ -0,0 +1,134 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+/**
+ * Lock-free ring buffer for a single producer and a single consumer.
+ *
+ * Unlike RingBuffer, the storage is a part of the object and the capacity is
+ * fixed at compile time, so no allocator is needed. The producer (push_back,
+ * emplace_back) and the consumer (pop_front, try_pop_front, front) can run
+ * concurrently - e.g., one in an interrupt and the other one in the main loop,
+ * or in two threads on the host. Each side is allowed to have only a single
+ * context operating on it at a time.
+ *
+ * Head and tail are free-running counters; the capacity has to be a power of
+ * two so the counters can wrap around. The whole capacity is usable.
+ */
+template < typename T, int Capacity >
+class SpscRingBuffer {
+    static_assert( Capacity > 0 && ( Capacity & ( Capacity - 1 ) ) == 0,
+        "Capacity has to be a power of two" );
+    static_assert( std::atomic< uint32_t >::is_always_lock_free );
+
+#if defined( __x86_64__ ) || defined( __i386__ ) || defined( __aarch64__ )
+    // Keep producer and consumer indices on separate cache lines
+    static constexpr std::size_t _indexAlignment = 64;
+#else
+    // There is no cache on MCUs, do not waste memory
+    static constexpr std::size_t _indexAlignment = alignof( std::atomic< uint32_t > );
+#endif
+    static constexpr uint32_t _mask = Capacity - 1;
+
+public:
+    SpscRingBuffer() = default;
+    SpscRingBuffer( const SpscRingBuffer& ) = delete;
+    SpscRingBuffer& operator=( const SpscRingBuffer& ) = delete;
+
+    static constexpr int capacity() {
+        return Capacity;
+    }
+
+    /**
+     * Return the number of elements. When called concurrently with the other
+     * side, the value is only a snapshot.
+     */
+    int size() const {
+        uint32_t tail = _tail.load( std::memory_order_acquire );
+        uint32_t head = _head.load( std::memory_order_acquire );
+        return int( tail - head );
+    }
+
+    int available() const {
+        return capacity() - size();
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    bool full() const {
+        return size() == capacity();
+    }
+
+    // Producer side
+
+    bool push_back( T val ) {
+        return emplace_back( std::move( val ) );
+    }
+
+    template < typename... Args >
+    bool emplace_back( Args&&... args ) {
+        uint32_t tail = _tail.load( std::memory_order_relaxed );
+        if ( tail - _cachedHead == Capacity ) {
+            _cachedHead = _head.load( std::memory_order_acquire );
+            if ( tail - _cachedHead == Capacity )
+                return false;
+        }
+        _data[ tail & _mask ] = T( std::forward< Args >( args )... );
+        _tail.store( tail + 1, std::memory_order_release );
+        return true;
+    }
+
+    // Consumer side
+
+    T& front() {
+        assert( !_consumerEmpty() );
+        return _data[ _head.load( std::memory_order_relaxed ) & _mask ];
+    }
+
+    T pop_front() {
+        assert( !_consumerEmpty() );
+        uint32_t head = _head.load( std::memory_order_relaxed );
+        T val = std::move( _data[ head & _mask ] );
+        _head.store( head + 1, std::memory_order_release );
+        return val;
+    }
+
+    std::optional< T > try_pop_front() {
+        if ( _consumerEmpty() )
+            return std::nullopt;
+        return pop_front();
+    }
+
+    /**
+     * Drop all elements. Has to be called from the consumer side.
+     */
+    void clear() {
+        while ( !_consumerEmpty() )
+            pop_front();
+    }
+
+private:
+    bool _consumerEmpty() {
+        uint32_t head = _head.load( std::memory_order_relaxed );
+        if ( head != _cachedTail )
+            return false;
+        _cachedTail = _tail.load( std::memory_order_acquire );
+        return head == _cachedTail;
+    }
+
+    // Written by consumer, read by producer
+    alignas( _indexAlignment ) std::atomic< uint32_t > _head = 0;
+    uint32_t _cachedTail = 0; // Consumer's view of _tail
+    // Written by producer, read by consumer
+    alignas( _indexAlignment ) std::atomic< uint32_t > _tail = 0;
+    uint32_t _cachedHead = 0; // Producer's view of _head
+    alignas( _indexAlignment ) alignas( T ) std::array< T, Capacity > _data;
+};
@@ -0,0 +1,107 @@
+// Timing of conversions between VoxelWorld and RofiWorld on large worlds.
+//
+// Usage: bench-voxel [repetitions]
+//
+// The worlds are planes of parallel rows of universal modules,
+// so every module is connected to its neighbours in the row and across rows.
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "voxel.hpp"
+
+namespace
+{
+using rofi::voxel::Axis;
+using rofi::voxel::Direction;
+using rofi::voxel::JointPosition;
+using rofi::voxel::Voxel;
+using rofi::voxel::VoxelWorld;
+
+/**
+ * @brief Builds a plane of rows of \p rowLength modules with about \p bodyCount bodies
+ */
+auto buildPlane( int bodyCount, int rowLength = 50 ) -> VoxelWorld
+{
+    int rowCount = std::max( 1, bodyCount / ( 2 * rowLength ) );
+
+    auto world = VoxelWorld();
+    for ( int y = 0; y < rowCount; y++ ) {
+        for ( int i = 0; i < rowLength; i++ ) {
+            world.bodies.push_back( Voxel{ .pos = { 2 * i, y, 0 },
+                                           .other_body_dir = { .axis = Axis::X, .is_positive = true },
+                                           .is_shoe_rotated = false,
+                                           .joint_pos = JointPosition::Zero } );
+            world.bodies.push_back( Voxel{ .pos = { 2 * i + 1, y, 0 },
+                                           .other_body_dir = { .axis = Axis::X, .is_positive = false },
+                                           .is_shoe_rotated = false,
+                                           .joint_pos = JointPosition::Zero } );
+        }
+    }
+    return world;
+}
+
+/**
+ * @brief Returns average milliseconds per call of \p f
+ */
+template < typename F >
+auto measure( int repetitions, F && f ) -> double
+{
+    auto start = std::chrono::steady_clock::now();
+    for ( int i = 0; i != repetitions; i++ ) {
+        f();
+    }
+    std::chrono::duration< double, std::milli > elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / repetitions;
+}
+
+void report( size_t bodyCount, const std::string & operation, double ms )
+{
+    std::cout << std::left << std::setw( 8 ) << bodyCount << std::setw( 16 ) << operation
+              << std::right << std::setw( 12 ) << std::fixed << std::setprecision( 3 ) << ms
+              << "\n";
+}
+
+void fail( const std::string & message )
+{
+    std::cerr << message << "\n";
+    std::exit( EXIT_FAILURE );
+}
+
+} // namespace
+
+int main( int argc, char * argv[] )
+{
+    int repetitions = argc > 1 ? std::stoi( argv[ 1 ] ) : 5;
+
+    std::cout << std::left << std::setw( 8 ) << "bodies" << std::setw( 16 ) << "operation"
+              << std::right << std::setw( 12 ) << "ms" << "\n";
+    for ( int bodyCount : { 1000, 4000, 10000 } ) {
+        auto voxelWorld = buildPlane( bodyCount );
+
+        report( voxelWorld.bodies.size(), "toRofiWorld", measure( repetitions, [ & ] {
+                    if ( !voxelWorld.toRofiWorld() ) {
+                        fail( "toRofiWorld failed" );
+                    }
+                } ) );
+        report( voxelWorld.bodies.size(), "toRofiWorld(1)", measure( repetitions, [ & ] {
+                    if ( !voxelWorld.toRofiWorld( true ) ) {
+                        fail( "toRofiWorld by one failed" );
+                    }
+                } ) );
+
+        // Modules fixed by one avoid accumulating rounding errors along long chains
+        auto rofiWorld = voxelWorld.toRofiWorld( true );
+        if ( !rofiWorld || !rofiWorld->prepare() ) {
+            fail( "Cannot prepare the rofi world" );
+        }
+        report( voxelWorld.bodies.size(), "fromRofiWorld", measure( repetitions, [ & ] {
+                    if ( !VoxelWorld::fromRofiWorld( *rofiWorld ) ) {
+                        fail( "fromRofiWorld failed" );
+                    }
+                } ) );
+    }
+}
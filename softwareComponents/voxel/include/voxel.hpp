@@ -1,7 +1,7 @@
 #pragma once
 
 #include <concepts>
-#include <map>
+#include <span>
 #include <optional>
 #include <string_view>
 #include <vector>
@@ -13,8 +13,10 @@
 #include "atoms/result.hpp"
 #include "atoms/units.hpp"
 #include "atoms/unreachable.hpp"
+#include "configuration/builder.hpp"
 #include "configuration/rofiworld.hpp"
 #include "configuration/universalModule.hpp"
+#include "voxel/position_map.hpp"
 
 
 namespace rofi::voxel
@@ -131,6 +133,14 @@ struct Direction {
 
     auto operator<=>( const Direction & ) const = default;
 
+    /**
+     * @brief Index of the direction in range [0, 6)
+     */
+    auto index() const -> size_t
+    {
+        return size_t( fromAxis( axis ) ) * 2 + ( is_positive ? 1 : 0 );
+    }
+
     Axis axis = {};
     bool is_positive = {};
 };
@@ -288,7 +298,7 @@ public:
             return std::move( shoeA ).assume_error_result();
         }
         auto shoeB = fromBodyComponent( rofiModule.getBodyB(), rofiModule.getBeta() );
-        if ( !shoeA ) {
+        if ( !shoeB ) {
             return std::move( shoeB ).assume_error_result();
         }
         return atoms::result_value( std::array{ *shoeA, *shoeB } );
@@ -492,9 +502,10 @@ public:
 
 struct VoxelWorld {
 private:
-    // Mapping (connectorPos, connectorDir) -> (component, orientationVector)
-    using ConnectorMap = std::map< std::pair< Position, Direction >,
-                                   std::pair< rofi::configuration::Component, Direction > >;
+    // Module index in the builder and connector index in the module
+    using ConnectorRef = std::pair< rofi::configuration::RofiWorldBuilder::ModuleIdx, int >;
+    // Mapping (connectorPos, connectorDir.index()) -> (connector, orientationVector)
+    using ConnectorMap = PositionMap< std::pair< ConnectorRef, Direction > >;
 
 public:
     static auto fromRofiWorld( const rofi::configuration::RofiWorld & rofiWorld )
@@ -530,59 +541,71 @@ private:
         return voxelBody.other_body_dir.is_positive;
     }
 
-    auto posToBodiesMap() const -> atoms::Result< std::map< Position, Voxel > >
+    auto bodyPositions() const -> std::vector< Position >
     {
-        auto bodiesMap = std::map< Position, Voxel >();
+        auto positions = std::vector< Position >();
+        positions.reserve( bodies.size() );
         for ( const auto & voxelBody : bodies ) {
-            auto inserted = bodiesMap.emplace( voxelBody.pos, voxelBody );
-            if ( !inserted.second ) {
+            positions.push_back( voxelBody.pos );
+        }
+        return positions;
+    }
+
+    auto posToBodiesMap( std::span< const Position > positions ) const
+            -> atoms::Result< PositionMap< Voxel > >
+    {
+        auto bodiesMap = PositionMap< Voxel >( positions );
+        for ( const auto & voxelBody : bodies ) {
+            if ( !bodiesMap.emplace( voxelBody.pos, 0, voxelBody ) ) {
                 return atoms::result_error< std::string >( "Multiple bodies at the same position" );
             }
         }
         return atoms::result_value( std::move( bodiesMap ) );
     }
 
-    static void connectModules( ConnectorMap & connectorMap )
+    static void connectModules(
+            rofi::configuration::RofiWorldBuilder & builder,
+            const ConnectorMap & connectorMap,
+            std::span< const std::pair< Position, Direction > > positiveConnectors )
     {
-        for ( const auto & [ connPosDir, connWithOri ] : connectorMap ) {
-            const auto & [ connPos, connDir ] = connPosDir;
-            if ( !connDir.is_positive ) {
-                // Select each connection only once
+        // Only connectors in positive directions are visited to select each connection once
+        for ( const auto & [ connPos, connDir ] : positiveConnectors ) {
+            assert( connDir.is_positive );
+            const auto * otherConnWithOri = connectorMap.find( connDir.movePosition( connPos ),
+                                                               connDir.opposite().index() );
+            if ( !otherConnWithOri ) {
                 continue;
             }
 
-            auto otherConnDirPos = std::pair{ connDir.movePosition( connPos ), connDir.opposite() };
-            auto otherConnWithOri = connectorMap.find( otherConnDirPos );
-            if ( otherConnWithOri == connectorMap.end() ) {
-                continue;
-            }
-
-            const auto & [ conn, connOri ] = connWithOri;
-            const auto & [ otherConn, otherConnOri ] = otherConnWithOri->second;
+            const auto & [ conn, connOri ] = *connectorMap.find( connPos, connDir.index() );
+            const auto & [ otherConn, otherConnOri ] = *otherConnWithOri;
 
             assert( connDir.axis != connOri.axis );
             assert( connDir.axis != otherConnOri.axis );
 
             auto orientation = Voxel::getConnOrientation( connDir, connOri, otherConnOri );
-            rofi::configuration::connect( conn, otherConn, orientation );
+            builder.addRoficomJoint( conn.first, conn.second, otherConn.first, otherConn.second, orientation );
         }
     }
 
-    auto fixInSpace( Voxel bodyToFixate, ConnectorMap & connectorMap ) const
+    static auto fixInSpace( rofi::configuration::RofiWorldBuilder & builder,
+                            Voxel bodyToFixate,
+                            const ConnectorMap & connectorMap )
             -> atoms::Result< std::monostate >
     {
-        auto connIt = connectorMap.find(
-                std::pair{ bodyToFixate.pos, bodyToFixate.xPlusConnDirection().opposite() } );
-        if ( connIt == connectorMap.end() ) {
+        const auto * connWithOri = connectorMap.find(
+                bodyToFixate.pos, bodyToFixate.xPlusConnDirection().opposite().index() );
+        if ( !connWithOri ) {
             return atoms::result_error< std::string >( "Couldn't find body's X- connector" );
         }
-        auto conn = connIt->second;
+        const auto & conn = *connWithOri;
         auto refPoint = toMatrixVector( bodyToFixate.pos );
         auto rotation = bodyToFixate.getXPlusConnMatrixRotation();
 
-        rofi::configuration::connect< rofi::configuration::RigidJoint >( conn.first,
-                                                                         refPoint,
-                                                                         rotation );
+        builder.addSpaceJoint< rofi::configuration::RigidJoint >( conn.first.first,
+                                                                  conn.first.second,
+                                                                  refPoint,
+                                                                  rotation );
         return atoms::result_value( std::monostate{} );
     }
 
@@ -594,57 +617,68 @@ public:
             return atoms::result_error< std::string >( "VoxelWorld cannot be empty" );
         }
 
-        auto bodiesMapResult = posToBodiesMap();
+        // Both maps are sized from the bounding box of the bodies,
+        // connectors are at the positions of their bodies
+        auto positions = bodyPositions();
+        auto bodiesMapResult = posToBodiesMap( positions );
         if ( !bodiesMapResult ) {
             return std::move( bodiesMapResult ).assume_error_result();
         }
         const auto bodiesMap = std::move( *bodiesMapResult );
         auto moduleId = rofi::configuration::ModuleId( 1 );
-        auto connectorMap = ConnectorMap();
+        auto connectorMap = ConnectorMap( positions, 6 );
+        auto positiveConnectors = std::vector< std::pair< Position, Direction > >();
 
-        auto rofiWorld = rofi::configuration::RofiWorld();
+        auto builder = rofi::configuration::RofiWorldBuilder();
+        builder.reserve( bodies.size() / 2, 3 * bodies.size() / 2 );
         for ( const auto & voxelBody : bodies ) {
             if ( !isModuleRepr( voxelBody ) ) {
                 continue;
             }
 
-            if ( !bodiesMap.contains( voxelBody.getOtherBodyPos() ) ) {
+            const auto * otherBody = bodiesMap.find( voxelBody.getOtherBodyPos() );
+            if ( !otherBody ) {
                 return atoms::result_error< std::string >( "Invalid world" );
             }
             auto shoeA = voxelBody;
-            auto shoeB = bodiesMap.at( voxelBody.getOtherBodyPos() );
+            auto shoeB = *otherBody;
 
-            auto & mod = rofiWorld.insert( Voxel::toRofiModule( shoeA, shoeB, moduleId++ ) );
+            auto mod = builder.addModule( Voxel::toRofiModule( shoeA, shoeB, moduleId++ ) );
 
             for ( auto conn : Voxel::getConnectors( shoeA, shoeB ) ) {
-                auto inserted = connectorMap.emplace( std::pair{ conn.pos, conn.dir },
-                                                      std::pair{ mod.getConnector( conn.name ),
+                auto connector = rofi::configuration::UniversalModule::translateComponent( conn.name );
+                auto inserted = connectorMap.emplace( conn.pos,
+                                                      conn.dir.index(),
+                                                      std::pair{ ConnectorRef{ mod, connector },
                                                                  conn.oriVec } );
-                if ( !inserted.second ) {
+                if ( !inserted ) {
                     return atoms::result_error< std::string >(
                             "Multiple connectors at the same position and direction" );
                 }
+                if ( conn.dir.is_positive ) {
+                    positiveConnectors.emplace_back( conn.pos, conn.dir );
+                }
             }
         }
 
         if ( fixateModulesByOne ) {
             for ( const auto & body : bodies ) {
-                auto fixInSpaceResult = fixInSpace( body, connectorMap );
+                auto fixInSpaceResult = fixInSpace( builder, body, connectorMap );
                 if ( !fixInSpaceResult ) {
                     return std::move( fixInSpaceResult ).assume_error_result();
                 }
             }
         } else {
-            connectModules( connectorMap );
+            connectModules( builder, connectorMap, positiveConnectors );
 
             assert( !bodies.empty() );
-            auto fixInSpaceResult = fixInSpace( bodies.front(), connectorMap );
+            auto fixInSpaceResult = fixInSpace( builder, bodies.front(), connectorMap );
             if ( !fixInSpaceResult ) {
                 return std::move( fixInSpaceResult ).assume_error_result();
             }
         }
 
-        return atoms::result_value( std::move( rofiWorld ) );
+        return atoms::result_value( builder.build() );
     }
 
     bool operator==( const VoxelWorld & ) const = default;
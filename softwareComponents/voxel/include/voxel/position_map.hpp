@@ -0,0 +1,176 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+
+namespace rofi::voxel
+{
+/**
+ * @brief Map from (position, slot) to `T` for keys on a 3D integer grid.
+ *
+ * The map is sized up front from the positions that will be inserted.
+ * If their bounding box is small compared to their count, the values are
+ * stored in a dense grid indexed directly by the position. Otherwise an
+ * open-addressing hash table with linear probing is used.
+ *
+ * Each position has `slotCount` independent slots,
+ * e.g. one per connector direction.
+ */
+template < typename T >
+class PositionMap {
+public:
+    using Position = std::array< int, 3 >;
+
+    /**
+     * @brief Creates an empty map for keys at \p positions .
+     * Only keys at these positions can be inserted, any position can be looked up.
+     */
+    explicit PositionMap( std::span< const Position > positions, size_t slotCount = 1 )
+            : _slotCount( slotCount )
+    {
+        assert( slotCount > 0 );
+        if ( positions.empty() ) {
+            // Empty box, all positions are outside
+            _min = { 1, 1, 1 };
+            _entries.resize( 1 );
+            return;
+        }
+
+        _min = _max = positions.front();
+        for ( const auto & pos : positions ) {
+            for ( size_t i = 0; i < 3; i++ ) {
+                _min[ i ] = std::min( _min[ i ], pos[ i ] );
+                _max[ i ] = std::max( _max[ i ], pos[ i ] );
+            }
+        }
+
+        auto volume = size_t( 1 );
+        for ( size_t i = 0; i < 3; i++ ) {
+            auto size = size_t( int64_t( _max[ i ] ) - _min[ i ] + 1 );
+            _sizes[ i ] = size;
+            volume = volume > maxDenseVolume / size ? maxDenseVolume + 1 : volume * size;
+        }
+
+        _dense = volume <= std::min( maxDenseVolume, denseFactor * positions.size() + 1024 );
+        if ( _dense ) {
+            _entries.resize( volume * _slotCount + 1 );
+        } else {
+            _entries.resize( std::bit_ceil( 2 * positions.size() * _slotCount ) );
+        }
+    }
+
+    /**
+     * @brief Returns the value at ( \p pos, \p slot ) or nullptr if there is none.
+     */
+    auto find( const Position & pos, size_t slot = 0 ) -> T *
+    {
+        auto & entry = _entries[ _indexOf( pos, slot ) ];
+        return entry ? &entry->second : nullptr;
+    }
+    auto find( const Position & pos, size_t slot = 0 ) const -> const T *
+    {
+        return const_cast< PositionMap * >( this )->find( pos, slot );
+    }
+
+    bool contains( const Position & pos, size_t slot = 0 ) const
+    {
+        return find( pos, slot ) != nullptr;
+    }
+
+    /**
+     * @brief Inserts \p value at ( \p pos, \p slot ) if there is no value yet.
+     * @returns whether the value was inserted
+     */
+    bool emplace( const Position & pos, size_t slot, T value )
+    {
+        assert( !_dense || _inBox( pos ) );
+        auto & entry = _entries[ _indexOf( pos, slot ) ];
+        if ( entry ) {
+            return false;
+        }
+        entry.emplace( Key{ pos, slot }, std::move( value ) );
+        _size++;
+        assert( _dense || 2 * _size <= _entries.size() );
+        return true;
+    }
+
+    auto size() const -> size_t
+    {
+        return _size;
+    }
+
+    bool isDense() const
+    {
+        return _dense;
+    }
+
+private:
+    using Key = std::pair< Position, size_t >;
+
+    static constexpr size_t maxDenseVolume = size_t( 1 ) << 26;
+    static constexpr size_t denseFactor = 8;
+
+    bool _inBox( const Position & pos ) const
+    {
+        for ( size_t i = 0; i < 3; i++ ) {
+            if ( pos[ i ] < _min[ i ] || pos[ i ] > _max[ i ] ) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static auto _hash( const Position & pos, size_t slot ) -> uint64_t
+    {
+        auto h = uint64_t( uint32_t( pos[ 0 ] ) ) * 0x9E3779B97F4A7C15ull;
+        h ^= uint64_t( uint32_t( pos[ 1 ] ) ) * 0xC2B2AE3D27D4EB4Full;
+        h ^= uint64_t( uint32_t( pos[ 2 ] ) ) * 0x165667B19E3779F9ull;
+        h ^= uint64_t( slot ) * 0x27D4EB2F165667C5ull;
+        return h ^ ( h >> 29 );
+    }
+
+    // Index of the entry for the key or of the empty entry where it belongs
+    auto _indexOf( const Position & pos, size_t slot ) const -> size_t
+    {
+        assert( slot < _slotCount );
+        if ( _dense ) {
+            if ( !_inBox( pos ) ) {
+                // Positions outside of the box are never inserted,
+                // the last entry is reserved as always empty
+                assert( !_entries.back() );
+                return _entries.size() - 1;
+            }
+            auto index = size_t( pos[ 0 ] - _min[ 0 ] );
+            index = index * _sizes[ 1 ] + size_t( pos[ 1 ] - _min[ 1 ] );
+            index = index * _sizes[ 2 ] + size_t( pos[ 2 ] - _min[ 2 ] );
+            return index * _slotCount + slot;
+        }
+
+        auto mask = _entries.size() - 1;
+        for ( auto index = _hash( pos, slot ) & mask;; index = ( index + 1 ) & mask ) {
+            const auto & entry = _entries[ index ];
+            if ( !entry || entry->first == Key{ pos, slot } ) {
+                return index;
+            }
+        }
+    }
+
+    size_t _slotCount;
+    bool _dense = true;
+    Position _min = {};
+    Position _max = {};
+    std::array< size_t, 3 > _sizes = {};
+    std::vector< std::optional< std::pair< Key, T > > > _entries;
+    size_t _size = 0;
+};
+
+} // namespace rofi::voxel
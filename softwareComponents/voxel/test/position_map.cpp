@@ -0,0 +1,65 @@
+#include "voxel/position_map.hpp"
+
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+
+namespace
+{
+using rofi::voxel::PositionMap;
+using Position = PositionMap< int >::Position;
+
+TEST_CASE( "PositionMap" )
+{
+    SECTION( "Dense grid" )
+    {
+        auto positions = std::vector< Position >{ { 0, 0, 0 }, { 1, -2, 3 }, { -1, 0, 1 } };
+        auto map = PositionMap< int >( positions, 6 );
+        CHECK( map.isDense() );
+
+        CHECK( map.emplace( { 1, -2, 3 }, 5, 42 ) );
+        CHECK_FALSE( map.emplace( { 1, -2, 3 }, 5, 7 ) );
+        CHECK( map.emplace( { 1, -2, 3 }, 0, 1 ) );
+        CHECK( map.size() == 2 );
+
+        REQUIRE( map.find( { 1, -2, 3 }, 5 ) );
+        CHECK( *map.find( { 1, -2, 3 }, 5 ) == 42 );
+        CHECK( *map.find( { 1, -2, 3 }, 0 ) == 1 );
+        CHECK_FALSE( map.find( { 1, -2, 3 }, 1 ) );
+        CHECK_FALSE( map.find( { 0, 0, 0 }, 5 ) );
+        CHECK_FALSE( map.find( { 2, -2, 3 }, 5 ) );
+        CHECK_FALSE( map.find( { -100, 0, 0 }, 0 ) );
+    }
+
+    SECTION( "Sparse positions use hash" )
+    {
+        auto positions = std::vector< Position >();
+        for ( int i = 0; i < 100; i++ ) {
+            positions.push_back( { i * 1000, -i * 1000, i } );
+        }
+        auto map = PositionMap< int >( positions );
+        CHECK_FALSE( map.isDense() );
+
+        for ( int i = 0; i < 100; i++ ) {
+            CHECK( map.emplace( positions[ i ], 0, i ) );
+        }
+        CHECK_FALSE( map.emplace( positions[ 42 ], 0, 0 ) );
+        CHECK( map.size() == 100 );
+
+        for ( int i = 0; i < 100; i++ ) {
+            REQUIRE( map.find( positions[ i ] ) );
+            CHECK( *map.find( positions[ i ] ) == i );
+        }
+        CHECK_FALSE( map.find( { 1, 1, 1 } ) );
+    }
+
+    SECTION( "Empty" )
+    {
+        auto map = PositionMap< int >( {} );
+        CHECK_FALSE( map.find( { 0, 0, 0 } ) );
+        CHECK( map.size() == 0 );
+    }
+}
+
+} // namespace
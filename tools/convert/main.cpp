@@ -1,5 +1,10 @@
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <filesystem>
 #include <iostream>
+#include <thread>
+#include <vector>
 
 #include <atoms/cmdline_utils.hpp>
 #include <dimcli/cli.h>
@@ -23,6 +28,7 @@ static auto & inputWorldFormat = command.opt< rofi::parsing::RofiWorldFormat >(
                                          .desc( "Format of the input world file" )
                                          .choice( rofi::parsing::RofiWorldFormat::Json, "json" )
                                          .choice( rofi::parsing::RofiWorldFormat::Voxel, "voxel" )
+                                         .choice( rofi::parsing::RofiWorldFormat::Binary, "binary" )
                                          .choice( rofi::parsing::RofiWorldFormat::Old, "old" );
 static auto & outputWorldFormat = command.opt< rofi::parsing::RofiWorldFormat >(
                                                  "of output-format" )
@@ -30,10 +36,13 @@ static auto & outputWorldFormat = command.opt< rofi::parsing::RofiWorldFormat >(
                                           .desc( "Format of the output world file" )
                                           .choice( rofi::parsing::RofiWorldFormat::Json, "json" )
                                           .choice( rofi::parsing::RofiWorldFormat::Voxel, "voxel" )
+                                          .choice( rofi::parsing::RofiWorldFormat::Binary, "binary" )
                                           .choice( rofi::parsing::RofiWorldFormat::Old, "old" );
 
 static auto & sequence = command.opt< bool >( "seq sequence" )
                                  .desc( "Convert an array of worlds (default is a single world)" );
+static auto & jobs = command.opt< unsigned >( "j jobs", std::max( std::thread::hardware_concurrency(), 1u ) )
+                             .desc( "Number of worlds of a sequence converted in parallel" );
 static auto & byOne = command.opt< bool >( "b by-one" )
                               .desc( "Fixate all modules by themselves"
                                      " - no roficom connections will be made"
@@ -75,29 +84,156 @@ void convertSingleWorld( Dim::Cli & cli )
     }
 }
 
-void convertWorldSequence( Dim::Cli & cli )
+struct SequenceFailure {
+    std::string title;
+    std::string detail;
+};
+
+// Result of converting a single world of a sequence by a worker
+struct ConvertedWorld {
+    std::optional< SequenceFailure > failure;
+    // Kept only if the writer cannot encode the world on its own
+    std::optional< rofi::configuration::RofiWorld > rofiWorld;
+    std::string encoded;
+};
+
+ConvertedWorld convertFrame( const rofi::parsing::RofiWorldSeqReader & reader,
+                             const rofi::parsing::RofiWorldSeqWriter & writer,
+                             rofi::parsing::RofiWorldSeqReader::Frame frame )
 {
-    auto rofiWorldSeq = atoms::readInput( *inputWorldFile, []( std::istream & istr ) {
-        return rofi::parsing::parseRofiWorldSeq( istr, *inputWorldFormat, *byOne );
-    } );
-    if ( !rofiWorldSeq ) {
-        cli.fail( EXIT_FAILURE, "Error while reading input sequence", rofiWorldSeq.assume_error() );
-        return;
+    auto index = std::to_string( frame.index );
+    auto rofiWorld = reader.decode( std::move( frame ) );
+    if ( !rofiWorld ) {
+        return { .failure = SequenceFailure{ "Error while reading input sequence",
+                                             rofiWorld.assume_error() } };
     }
 
-    if ( auto valid = rofi::parsing::validateRofiWorldSeq( *rofiWorldSeq ); !valid ) {
-        static_assert( std::is_same_v< decltype( valid ), atoms::Result< std::monostate > > );
-        cli.fail( EXIT_FAILURE, "Invalid world sequence", valid.assume_error() );
-        return;
+    if ( auto valid = rofiWorld->validate(); !valid ) {
+        return { .failure = SequenceFailure{ "Invalid world sequence",
+                                             "Rofi world " + index
+                                                     + " is not valid: " + valid.assume_error() } };
     }
 
-    auto result = atoms::writeOutput( *outputWorldFile, [ &rofiWorldSeq ]( std::ostream & ostr ) {
-        return rofi::parsing::writeRofiWorldSeq( ostr, *rofiWorldSeq, *outputWorldFormat );
-    } );
-    if ( !result ) {
-        cli.fail( EXIT_FAILURE, "Error while writing world sequence", result.assume_error() );
-        return;
+    if ( !writer.encodesIndependently() ) {
+        return { .rofiWorld = std::move( *rofiWorld ) };
+    }
+    auto encoded = writer.encode( *rofiWorld );
+    if ( !encoded ) {
+        return { .failure = SequenceFailure{ "Error while writing world sequence",
+                                             "Error converting rofi world " + index + ": "
+                                                     + encoded.assume_error() } };
+    }
+    return { .encoded = std::move( *encoded ) };
+}
+
+/**
+ * Write the output through a temporary file next to \p outputFilePath which
+ * replaces it only if \p writeCallback succeeds, so that a failed conversion
+ * leaves the previous output intact.
+ * Returns the result of \p writeCallback.
+ */
+bool writeOutputOnSuccess( const std::filesystem::path & outputFilePath,
+                           std::invocable< std::ostream & > auto writeCallback )
+{
+    if ( outputFilePath == "-" ) {
+        return writeCallback( std::cout );
+    }
+
+    auto tmpFilePath = outputFilePath;
+    tmpFilePath += ".tmp";
+    auto success = false;
+    try {
+        success = atoms::writeOutput( tmpFilePath, writeCallback );
+    } catch ( ... ) {
+        auto ec = std::error_code();
+        std::filesystem::remove( tmpFilePath, ec );
+        throw;
+    }
+
+    if ( success ) {
+        std::filesystem::rename( tmpFilePath, outputFilePath );
+    } else {
+        auto ec = std::error_code();
+        std::filesystem::remove( tmpFilePath, ec );
     }
+    return success;
+}
+
+void convertWorldSequence( Dim::Cli & cli )
+{
+    // Worlds are read and written one batch at a time so that long sequences
+    // do not have to fit in memory. Worlds of a batch are decoded, validated
+    // and encoded in parallel and written in their original order.
+    auto threadCount = std::max( *jobs, 1u );
+    auto batchSize = size_t( 16 ) * threadCount;
+
+    atoms::readInput( *inputWorldFile, [ & ]( std::istream & istr ) {
+        auto reader = rofi::parsing::RofiWorldSeqReader( istr, *inputWorldFormat, *byOne );
+        writeOutputOnSuccess( *outputWorldFile, [ & ]( std::ostream & ostr ) {
+            auto writer = rofi::parsing::RofiWorldSeqWriter( ostr, *outputWorldFormat );
+            auto finished = false;
+            while ( !finished ) {
+                auto frames = std::vector< rofi::parsing::RofiWorldSeqReader::Frame >();
+                auto readFailure = std::optional< std::string >();
+                while ( frames.size() < batchSize ) {
+                    auto frame = reader.nextFrame();
+                    if ( !frame ) {
+                        readFailure = frame.assume_error();
+                        break;
+                    }
+                    if ( !*frame ) {
+                        finished = true;
+                        break;
+                    }
+                    frames.push_back( std::move( **frame ) );
+                }
+
+                // Each slot is written by a single worker
+                auto converted = std::vector< ConvertedWorld >( frames.size() );
+                auto nextFrame = std::atomic< size_t >( 0 );
+                auto worker = [ & ] {
+                    for ( auto i = nextFrame++; i < frames.size(); i = nextFrame++ ) {
+                        converted[ i ] = convertFrame( reader, writer, std::move( frames[ i ] ) );
+                    }
+                };
+                {
+                    auto workers = std::vector< std::jthread >();
+                    for ( unsigned i = 1; i < std::min( size_t( threadCount ), frames.size() ); i++ ) {
+                        workers.emplace_back( worker );
+                    }
+                    worker();
+                }
+
+                for ( auto & world : converted ) {
+                    if ( world.failure ) {
+                        cli.fail( EXIT_FAILURE, world.failure->title, world.failure->detail );
+                        return false;
+                    }
+                    if ( world.rofiWorld ) {
+                        if ( auto result = writer.write( *world.rofiWorld ); !result ) {
+                            cli.fail( EXIT_FAILURE,
+                                      "Error while writing world sequence",
+                                      result.assume_error() );
+                            return false;
+                        }
+                    } else {
+                        writer.writeEncoded( world.encoded );
+                    }
+                }
+
+                if ( readFailure ) {
+                    cli.fail( EXIT_FAILURE, "Error while reading input sequence", *readFailure );
+                    return false;
+                }
+            }
+            writer.finish();
+            if ( !ostr.flush() ) {
+                cli.fail( EXIT_FAILURE, "Error while writing world sequence" );
+                return false;
+            }
+            return true;
+        } );
+    } );
 }
 
 
@@ -81,6 +81,8 @@ int main( int argc, char** argv )
             s = strategy::pseudoinverse;
         } else if( arg == "-fabrik" ){
             s = strategy::fabrik;
+        } else if( arg == "-dls" ){
+            s = strategy::dls;
         } else if( arg == "-v" || arg == "--verbose" ){
             opt.verbose = true;
         } else if( arg == "-a" || arg == "--animate" ){
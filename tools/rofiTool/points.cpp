@@ -21,6 +21,7 @@ static auto & worldFormat = command.opt< rofi::parsing::RofiWorldFormat >( "f fo
                                     .desc( "Format of the world file" )
                                     .choice( rofi::parsing::RofiWorldFormat::Json, "json" )
                                     .choice( rofi::parsing::RofiWorldFormat::Voxel, "voxel" )
+                                    .choice( rofi::parsing::RofiWorldFormat::Binary, "binary" )
                                     .choice( rofi::parsing::RofiWorldFormat::Old, "old" );
 static auto & byOne = command.opt< bool >( "b by-one" )
                               .desc( "Fixate all modules by themselves"
@@ -23,6 +23,7 @@ static auto & worldFormat = command.opt< rofi::parsing::RofiWorldFormat >( "f fo
                                     .desc( "Format of the world file" )
                                     .choice( rofi::parsing::RofiWorldFormat::Json, "json" )
                                     .choice( rofi::parsing::RofiWorldFormat::Voxel, "voxel" )
+                                    .choice( rofi::parsing::RofiWorldFormat::Binary, "binary" )
                                     .choice( rofi::parsing::RofiWorldFormat::Old, "old" );
 static auto & sequence = command.opt< bool >( "seq sequence" )
                                  .desc( "Preview an array of worlds (default is a single world)" );
@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <thread>
+
+#include <atoms/cmdline_utils.hpp>
+#include <configuration/rofiworld.hpp>
+#include <dimcli/cli.h>
+#include <parsing/parsing.hpp>
+
+#include "rendering.hpp"
+
+
+void render( Dim::Cli & cli );
+
+static auto command = Dim::Cli()
+                              .command( "render" )
+                              .action( render )
+                              .desc( "Render a world sequence offscreen to numbered PNG images" );
+static auto & inputWorldFile = command.opt< std::filesystem::path >( "<input_world_file>" )
+                                       .defaultDesc( {} )
+                                       .desc( "Input world sequence file ('-' for standard input)" );
+static auto & outputDir = command.opt< std::filesystem::path >( "<output_dir>" )
+                                  .defaultDesc( {} )
+                                  .desc( "Directory for the rendered images" );
+static auto & worldFormat = command.opt< rofi::parsing::RofiWorldFormat >( "f format" )
+                                    .valueDesc( "world_format" )
+                                    .desc( "Format of the world file" )
+                                    .choice( rofi::parsing::RofiWorldFormat::Json, "json" )
+                                    .choice( rofi::parsing::RofiWorldFormat::Voxel, "voxel" )
+                                    .choice( rofi::parsing::RofiWorldFormat::Binary, "binary" )
+                                    .choice( rofi::parsing::RofiWorldFormat::Old, "old" );
+static auto & byOne = command.opt< bool >( "b by-one" )
+                              .desc( "Fixate all modules by themselves"
+                                     " - no roficom connections will be made"
+                                     " (only applicable for voxel format)" )
+                              .after( []( auto & cli, auto & opt, auto & ) {
+                                  if ( *opt ) {
+                                      if ( *worldFormat != rofi::parsing::RofiWorldFormat::Voxel ) {
+                                          cli.badUsage(
+                                                  "`by-one` is only applicable for voxel format" );
+                                          return false;
+                                      }
+                                  }
+                                  return true;
+                              } );
+static auto & width = command.opt< int >( "width", 1920 ).desc( "Width of the images in pixels" );
+static auto & height = command.opt< int >( "height", 1080 ).desc( "Height of the images in pixels" );
+static auto & framesPerStep = command.opt< size_t >( "s frames-per-step", 1 )
+                                      .desc( "Number of frames from one world of the sequence"
+                                             " to the next one (joint positions are interpolated)" );
+static auto & jobs = command.opt< unsigned >( "j jobs", std::max( std::thread::hardware_concurrency(), 1u ) )
+                             .desc( "Number of threads encoding the images" );
+
+void render( Dim::Cli & cli )
+{
+    if ( *width <= 0 || *height <= 0 ) {
+        cli.badUsage( "Image size has to be positive" );
+        return;
+    }
+    if ( *framesPerStep == 0 || *jobs == 0 ) {
+        cli.badUsage( "Number of frames per step and number of jobs have to be positive" );
+        return;
+    }
+
+    auto ec = std::error_code();
+    std::filesystem::create_directories( *outputDir, ec );
+    if ( ec ) {
+        cli.fail( EXIT_FAILURE, "Cannot create output directory " + outputDir->string(), ec.message() );
+        return;
+    }
+
+    auto settings = FrameSettings{ .outputDir = *outputDir,
+                                   .width = *width,
+                                   .height = *height,
+                                   .framesPerStep = *framesPerStep,
+                                   .encoderCount = *jobs };
+    // The sequence is read as it is rendered, so that it does not have to fit in memory
+    auto frameCount = atoms::readInput( *inputWorldFile, [ & ]( std::istream & istr ) {
+        auto reader = rofi::parsing::RofiWorldSeqReader( istr, *worldFormat, *byOne );
+        size_t index = 0;
+        auto nextWorld = [ & ]() -> atoms::Result< std::optional< rofi::configuration::RofiWorld > > {
+            auto world = reader.next();
+            if ( !world || !*world ) {
+                return world;
+            }
+            auto i = index++;
+            if ( ( *world )->modules().empty() ) {
+                return atoms::result_error( "Empty world " + std::to_string( i ) );
+            }
+
+            if ( ( *world )->referencePoints().empty() ) {
+                std::cerr << "No reference points found, fixing the world " + std::to_string( i )
+                                     + " in space\n";
+                rofi::parsing::fixateRofiWorld( **world );
+            }
+
+            if ( auto valid = ( *world )->validate(); !valid ) {
+                return atoms::result_error( "Invalid rofi world " + std::to_string( i ) + ": "
+                                            + valid.assume_error() );
+            }
+            return world;
+        };
+        return renderRofiWorldSequenceFrames( nextWorld, settings );
+    } );
+    if ( !frameCount ) {
+        cli.fail( EXIT_FAILURE, "Error while rendering sequence", frameCount.assume_error() );
+        return;
+    }
+    std::cerr << "Rendered " << *frameCount << " frames to " << outputDir->string() << "\n";
+}
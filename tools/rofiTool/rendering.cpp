@@ -1,8 +1,17 @@
 #include "rendering.hpp"
 
+#include <cmath>
+#include <iomanip>
+#include <optional>
+#include <sstream>
 #include <string_view>
+#include <thread>
+#include <vector>
 
+#include <atoms/concurrent_queue.hpp>
+#include <atoms/guarded.hpp>
 #include <atoms/resources.hpp>
+#include <configuration/binary.hpp>
 #include <isoreconfig/geometry.hpp>
 #include <isoreconfig/isomorphic.hpp>
 
@@ -11,19 +20,27 @@
 #include <vtkCallbackCommand.h>
 #include <vtkCamera.h>
 #include <vtkCylinderSource.h>
+#include <vtkDoubleArray.h>
+#include <vtkErrorCode.h>
+#include <vtkGlyph3DMapper.h>
+#include <vtkImageData.h>
 #include <vtkInteractorStyleTrackballCamera.h>
 #include <vtkMatrix4x4.h>
 #include <vtkNamedColors.h>
 #include <vtkNew.h>
 #include <vtkOBJReader.h>
 #include <vtkOrientationMarkerWidget.h>
-#include <vtkPolyDataMapper.h>
+#include <vtkPNGWriter.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
 #include <vtkProperty.h>
 #include <vtkRenderWindow.h>
 #include <vtkRenderWindowInteractor.h>
 #include <vtkRenderer.h>
 #include <vtkTransform.h>
 #include <vtkTransformPolyDataFilter.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkWindowToImageFilter.h>
 
 
 using namespace rofi::configuration;
@@ -83,6 +100,126 @@ vtkAlgorithmOutput * getComponentModel( ComponentType type )
     return cache.at( type )->GetOutputPort();
 }
 
+vtkAlgorithmOutput * getPointModel()
+{
+    static vtkSmartPointer< vtkTransformPolyDataFilter > cache;
+
+    if ( !cache ) {
+        // Load blender object
+        vtkNew< vtkOBJReader > reader;
+        ResourceFile modelFile = LOAD_RESOURCE_FILE( model_point_obj );
+        reader->SetFileName( modelFile.name().c_str() );
+        reader->Update();
+
+        vtkNew< vtkTransform > trans;
+        trans->RotateX( 90 );
+        cache = vtkSmartPointer< vtkTransformPolyDataFilter >::New();
+        cache->SetInputConnection( reader->GetOutputPort() );
+        cache->SetTransform( trans.Get() );
+        cache->Update();
+    }
+    return cache->GetOutputPort();
+}
+
+/**
+ * All instances of a single model rendered by a single actor
+ *
+ * Each instance has its own position and colour. The actor keeps the instance
+ * data alive after the InstancedModel is destroyed.
+ */
+class InstancedModel {
+public:
+    InstancedModel( vtkRenderer & renderer, vtkAlgorithmOutput * model, double scale = 1.0 / 95.0 )
+            : _positions( vtkSmartPointer< vtkPoints >::New() )
+            , _orientations( vtkSmartPointer< vtkDoubleArray >::New() )
+            , _colors( vtkSmartPointer< vtkUnsignedCharArray >::New() )
+            , _instances( vtkSmartPointer< vtkPolyData >::New() )
+    {
+        _orientations->SetName( "orientation" );
+        _orientations->SetNumberOfComponents( 3 );
+        _colors->SetName( "colour" );
+        _colors->SetNumberOfComponents( 3 );
+
+        _instances->SetPoints( _positions );
+        _instances->GetPointData()->AddArray( _orientations );
+        _instances->GetPointData()->SetScalars( _colors );
+
+        vtkNew< vtkGlyph3DMapper > mapper;
+        mapper->SetInputData( _instances );
+        mapper->SetSourceConnection( model );
+        // Orientation is given by angles as returned by vtkTransform::GetOrientation
+        mapper->SetOrientationArray( "orientation" );
+        mapper->SetOrientationModeToRotation();
+        mapper->SetScaling( true );
+        mapper->SetScaleModeToNoDataScaling();
+        mapper->SetScaleFactor( scale );
+        mapper->SetScalarModeToUsePointData();
+        mapper->ScalarVisibilityOn();
+
+        vtkNew< vtkActor > actor;
+        actor->SetMapper( mapper.Get() );
+        actor->GetProperty()->SetOpacity( 1.0 );
+        actor->GetProperty()->SetFrontfaceCulling( true );
+        actor->GetProperty()->SetBackfaceCulling( true );
+        renderer.AddActor( actor.Get() );
+    }
+
+    void add( const Matrix & position, std::array< double, 3 > colour )
+    {
+        double orientation[ 3 ];
+        vtkTransform::GetOrientation( orientation, convertMatrix( position ) );
+        _positions->InsertNextPoint( position( 0, 3 ), position( 1, 3 ), position( 2, 3 ) );
+        _orientations->InsertNextTuple( orientation );
+        _colors->InsertNextTuple3( std::round( colour[ 0 ] * 255 ),
+                                   std::round( colour[ 1 ] * 255 ),
+                                   std::round( colour[ 2 ] * 255 ) );
+        _instances->Modified();
+    }
+
+    // Removes all instances, the actor stays in the renderer
+    void clear()
+    {
+        _positions->Reset();
+        _orientations->Reset();
+        _colors->Reset();
+        _instances->Modified();
+    }
+
+private:
+    vtkSmartPointer< vtkPoints > _positions;
+    vtkSmartPointer< vtkDoubleArray > _orientations;
+    vtkSmartPointer< vtkUnsignedCharArray > _colors;
+    vtkSmartPointer< vtkPolyData > _instances;
+};
+
+/**
+ * Components of all modules rendered by a single actor per component type
+ */
+class ComponentInstances {
+public:
+    explicit ComponentInstances( vtkRenderer & renderer ) : _renderer( renderer ) {}
+
+    void add( ComponentType type, const Matrix & position, std::array< double, 3 > colour )
+    {
+        auto model = _models.find( type );
+        if ( model == _models.end() ) {
+            model = _models.emplace( type, InstancedModel( _renderer, getComponentModel( type ) ) ).first;
+        }
+        model->second.add( position, colour );
+    }
+
+    void clear()
+    {
+        for ( auto & [ type, model ] : _models ) {
+            model.clear();
+        }
+    }
+
+private:
+    vtkRenderer & _renderer;
+    std::map< ComponentType, InstancedModel > _models;
+};
+
 void setupRenderer( vtkRenderer & renderer )
 {
     renderer.SetBackground( 1.0, 1.0, 1.0 );
@@ -128,7 +265,7 @@ void addAxesWidget( vtkOrientationMarkerWidget & widget,
     widget.InteractiveOn();
 }
 
-void addModuleToScene( vtkRenderer & renderer,
+void addModuleToScene( ComponentInstances & componentInstances,
                        const Module & m,
                        const Matrix & mPosition,
                        int moduleIndex,
@@ -144,30 +281,11 @@ void addModuleToScene( vtkRenderer & renderer,
             cPosition = cPosition * matrices::translate( { -0.05, 0, 0 } );
         }
 
-        vtkNew< vtkTransform > posTrans;
-        posTrans->SetMatrix( convertMatrix( cPosition ) );
-
-        vtkNew< vtkTransformPolyDataFilter > filter;
-        filter->SetTransform( posTrans.Get() );
-        filter->SetInputConnection( getComponentModel( component.type ) );
-
-        vtkNew< vtkPolyDataMapper > frameMapper;
-        frameMapper->SetInputConnection( filter->GetOutputPort() );
-
-        vtkNew< vtkActor > frameActor;
-        frameActor->SetMapper( frameMapper.Get() );
-        frameActor->GetProperty()->SetColor( moduleColor.data() );
-        frameActor->GetProperty()->SetOpacity( 1.0 );
-        frameActor->GetProperty()->SetFrontfaceCulling( true );
-        frameActor->GetProperty()->SetBackfaceCulling( true );
-        frameActor->SetPosition( cPosition( 0, 3 ), cPosition( 1, 3 ), cPosition( 2, 3 ) );
-        frameActor->SetScale( 1.0 / 95.0 );
-
-        renderer.AddActor( frameActor.Get() );
+        componentInstances.add( component.type, cPosition, moduleColor );
     }
 }
 
-void buildRofiWorldScene( vtkRenderer & renderer, const RofiWorld & world )
+void addRofiWorldToScene( ComponentInstances & componentInstances, const RofiWorld & world )
 {
     assert( world.isPrepared() && "The rofi world has to be prepared" );
 
@@ -183,7 +301,7 @@ void buildRofiWorldScene( vtkRenderer & renderer, const RofiWorld & world )
     int index = 0;
     for ( auto & mInfo : world.modules() ) {
         assert( mInfo.absPosition && "The rofi world has to be prepared" );
-        addModuleToScene( renderer,
+        addModuleToScene( componentInstances,
                           *mInfo.module,
                           *mInfo.absPosition,
                           index,
@@ -192,6 +310,12 @@ void buildRofiWorldScene( vtkRenderer & renderer, const RofiWorld & world )
     }
 }
 
+void buildRofiWorldScene( vtkRenderer & renderer, const RofiWorld & world )
+{
+    auto componentInstances = ComponentInstances( renderer );
+    addRofiWorldToScene( componentInstances, world );
+}
+
 void renderRofiWorld( const RofiWorld & world, const std::string & displayName )
 {
     assert( world.isPrepared() && "The rofi world has to be prepared" );
@@ -358,45 +482,219 @@ void renderRofiWorldSequence( std::span< const RofiWorld > worlds, const std::st
     renderWindowInteractor->Start();
 }
 
-void addPointToScene( vtkRenderer & renderer,
-                      const Matrix & pointPosition,
-                      std::array< double, 3 > colour,
-                      double scale = 1.0 / 95.0 )
+// Returns true if the worlds consist of the same modules with the same connections
+// and differ only in joint positions
+bool onlyJointsDiffer( const RofiWorld & from, const RofiWorld & to )
+{
+    return binary::sameStructure( from, to ) && binary::sameConnections( from, to );
+}
+
+// Returns world with joint positions linearly interpolated between `from` (t = 0) and `to` (t = 1)
+// or `from` if such world is inconsistent
+RofiWorld interpolateJoints( const RofiWorld & from, const RofiWorld & to, float t )
+{
+    assert( onlyJointsDiffer( from, to ) );
+
+    auto world = from;
+    auto toModule = to.modules().begin();
+    for ( const auto & mInfo : from.modules() ) {
+        const auto & target = *( toModule++ )->module;
+        auto & module = *world.getModule( mInfo.module->getId() );
+        for ( size_t i = 0; i < module.joints().size(); i++ ) {
+            auto fromPositions = module.joints()[ i ].joint->positions();
+            auto toPositions = target.joints()[ i ].joint->positions();
+            assert( fromPositions.size() == toPositions.size() );
+
+            auto positions = std::vector< float >( fromPositions.size() );
+            for ( size_t j = 0; j < positions.size(); j++ ) {
+                positions[ j ] = fromPositions[ j ] + t * ( toPositions[ j ] - fromPositions[ j ] );
+            }
+            module.setJointPositions( static_cast< int >( i ), positions );
+        }
+    }
+
+    if ( !world.prepare() ) {
+        return from;
+    }
+    return world;
+}
+
+std::filesystem::path framePath( const std::filesystem::path & outputDir, size_t frameIndex )
+{
+    auto name = std::ostringstream();
+    name << "frame_" << std::setw( 6 ) << std::setfill( '0' ) << frameIndex << ".png";
+    return outputDir / name.str();
+}
+
+struct RenderedFrame {
+    size_t index;
+    int width;
+    int height;
+    std::vector< unsigned char > pixels; ///< RGB pixels, rows from the bottom
+};
+
+// Encodes rendered frames to PNG until an empty frame is received
+// Each encoder has its own writer, so multiple encoders can run in parallel
+void encodeFrames( atoms::ConcurrentQueue< std::optional< RenderedFrame > > & renderedFrames,
+                   atoms::ConcurrentQueue< std::vector< unsigned char > > & freeBuffers,
+                   const std::filesystem::path & outputDir,
+                   atoms::Guarded< std::optional< std::string > > & error )
+{
+    vtkNew< vtkUnsignedCharArray > pixels;
+    pixels->SetNumberOfComponents( 3 );
+    vtkNew< vtkImageData > image;
+    image->GetPointData()->SetScalars( pixels.Get() );
+    vtkNew< vtkPNGWriter > writer;
+    writer->SetInputData( image.Get() );
+
+    while ( auto frame = renderedFrames.pop() ) {
+        auto path = framePath( outputDir, frame->index );
+
+        // Wrap the buffer without copying, it is not freed by the array
+        pixels->SetArray( frame->pixels.data(), static_cast< vtkIdType >( frame->pixels.size() ), 1 );
+        image->SetDimensions( frame->width, frame->height, 1 );
+        image->Modified();
+        writer->SetFileName( path.c_str() );
+        writer->Write();
+
+        if ( writer->GetErrorCode() != vtkErrorCode::NoError ) {
+            error.visit( [ & ]( auto & e ) {
+                if ( !e ) {
+                    e = "Error while writing frame " + path.string();
+                }
+                return 0;
+            } );
+        }
+        freeBuffers.push( std::move( frame->pixels ) );
+    }
+}
+
+atoms::Result< size_t > renderRofiWorldSequenceFrames( const NextRofiWorld & nextWorld,
+                                                       const FrameSettings & settings )
 {
-    vtkNew< vtkTransform > posTrans;
-    posTrans->SetMatrix( convertMatrix( pointPosition ) );
-
-    vtkNew< vtkTransformPolyDataFilter > filter;
-    filter->SetTransform( posTrans.Get() );
-
-    // Load blender object
-    vtkNew< vtkOBJReader > reader;
-    ResourceFile modelFile = LOAD_RESOURCE_FILE( model_point_obj );
-    reader->SetFileName( modelFile.name().c_str() );
-    reader->Update();
-
-    vtkNew< vtkTransform > trans;
-    trans->RotateX( 90 );
-    vtkNew< vtkTransformPolyDataFilter > t;
-    t->SetInputConnection( reader->GetOutputPort() );
-    t->SetTransform( trans.Get() );
-    t->Update();
-
-    filter->SetInputConnection( t->GetOutputPort() );
-
-    vtkNew< vtkPolyDataMapper > frameMapper;
-    frameMapper->SetInputConnection( filter->GetOutputPort() );
-
-    vtkNew< vtkActor > frameActor;
-    frameActor->SetMapper( frameMapper.Get() );
-    frameActor->GetProperty()->SetColor( colour.data() );
-    frameActor->GetProperty()->SetOpacity( 1.0 );
-    frameActor->GetProperty()->SetFrontfaceCulling( true );
-    frameActor->GetProperty()->SetBackfaceCulling( true );
-    frameActor->SetPosition( pointPosition( 0, 3 ), pointPosition( 1, 3 ), pointPosition( 2, 3 ) );
-    frameActor->SetScale( scale );
-
-    renderer.AddActor( frameActor.Get() );
+    assert( settings.framesPerStep > 0 );
+    assert( settings.encoderCount > 0 );
+
+    auto first = nextWorld();
+    if ( !first ) {
+        return first.assume_error_result();
+    }
+    if ( !*first ) {
+        return atoms::result_error< std::string >( "No world in sequence" );
+    }
+
+    vtkNew< vtkRenderer > renderer;
+    setupRenderer( *renderer.Get() );
+    vtkNew< vtkRenderWindow > renderWindow;
+    renderWindow->SetOffScreenRendering( 1 );
+    renderWindow->SetSize( settings.width, settings.height );
+    renderWindow->AddRenderer( renderer.Get() );
+
+    // Models and actors stay resident, only the instances change between frames
+    auto componentInstances = ComponentInstances( *renderer.Get() );
+
+    vtkNew< vtkWindowToImageFilter > windowToImage;
+    windowToImage->SetInput( renderWindow.Get() );
+    windowToImage->SetInputBufferTypeToRGB();
+    windowToImage->ReadFrontBufferOff();
+
+    // Rendering of a frame overlaps with encoding of the previous ones,
+    // the number of frames in flight is limited by the number of buffers
+    auto renderedFrames = atoms::ConcurrentQueue< std::optional< RenderedFrame > >();
+    auto freeBuffers = atoms::ConcurrentQueue< std::vector< unsigned char > >();
+    for ( unsigned i = 0; i < 2 * settings.encoderCount; i++ ) {
+        freeBuffers.push( std::vector< unsigned char >() );
+    }
+    auto error = atoms::Guarded< std::optional< std::string > >();
+
+    size_t frameCount = 0;
+    {
+        auto encoders = std::vector< std::jthread >();
+        for ( unsigned i = 0; i < settings.encoderCount; i++ ) {
+            encoders.emplace_back( [ & ] {
+                encodeFrames( renderedFrames, freeBuffers, settings.outputDir, error );
+            } );
+        }
+
+        auto renderFrame = [ & ]( const RofiWorld & world ) {
+            componentInstances.clear();
+            addRofiWorldToScene( componentInstances, world );
+            if ( frameCount == 0 ) {
+                renderer->ResetCamera();
+            } else {
+                renderer->ResetCameraClippingRange();
+            }
+            renderWindow->Render();
+
+            windowToImage->Modified();
+            windowToImage->Update();
+            auto * image = windowToImage->GetOutput();
+            auto * pixels = vtkUnsignedCharArray::SafeDownCast( image->GetPointData()->GetScalars() );
+            assert( pixels );
+            assert( pixels->GetNumberOfComponents() == 3 );
+            int dimensions[ 3 ];
+            image->GetDimensions( dimensions );
+
+            auto buffer = freeBuffers.pop();
+            auto size = static_cast< size_t >( pixels->GetNumberOfValues() );
+            buffer.assign( pixels->GetPointer( 0 ), pixels->GetPointer( 0 ) + size );
+            renderedFrames.push( RenderedFrame{ .index = frameCount,
+                                                .width = dimensions[ 0 ],
+                                                .height = dimensions[ 1 ],
+                                                .pixels = std::move( buffer ) } );
+            frameCount++;
+        };
+        auto failed = [ & ] {
+            return error.visit( []( const auto & e ) { return e.has_value(); } );
+        };
+
+        auto stopEncoders = [ & ] {
+            for ( unsigned i = 0; i < settings.encoderCount; i++ ) {
+                renderedFrames.push( std::nullopt );
+            }
+        };
+
+        try {
+            auto from = std::move( **first );
+            while ( !failed() ) {
+                assert( from.isPrepared() && "All rofi worlds have to be prepared" );
+                assert( from.isValid() && "All rofi worlds have to be valid" );
+                renderFrame( from );
+
+                auto to = nextWorld();
+                if ( !to ) {
+                    error.visit( [ & ]( auto & e ) {
+                        if ( !e ) {
+                            e = to.assume_error();
+                        }
+                        return 0;
+                    } );
+                    break;
+                }
+                if ( !*to ) {
+                    break;
+                }
+
+                // Worlds with different connections are shown without transition
+                bool interpolate = onlyJointsDiffer( from, **to );
+                for ( size_t step = 1; step < settings.framesPerStep; step++ ) {
+                    auto t = static_cast< float >( step ) / static_cast< float >( settings.framesPerStep );
+                    renderFrame( interpolate ? interpolateJoints( from, **to, t ) : from );
+                }
+                from = std::move( **to );
+            }
+        } catch ( ... ) {
+            // The encoders are joined when leaving the scope, they have to stop first
+            stopEncoders();
+            throw;
+        }
+        stopEncoders();
+    }
+
+    if ( auto e = error.visit( []( const auto & e ) { return e; } ) ) {
+        return atoms::result_error( std::move( *e ) );
+    }
+    return atoms::result_value( frameCount );
 }
 
 void buildRofiWorldPointsScene( vtkRenderer & renderer, RofiWorld world, bool showModules )
@@ -429,19 +727,22 @@ void buildRofiWorldPointsScene( vtkRenderer & renderer, RofiWorld world, bool sh
     Positions pos = cloudToPositions( scoreToCloud( score ) );
     assert( pos.size() == pts[ 0 ].size() );
 
+    auto modulePoints = InstancedModel( renderer, getPointModel() );
+    auto connectorPoints = InstancedModel( renderer, getPointModel(), 1 / 90.0 );
+
     // Show module points (colour depends on index)
     assert( pts[ 0 ].size() >= pts[ 1 ].size() );
     for ( size_t i = 0; i < pts[ 0 ].size() - pts[ 1 ].size(); ++i ) {
-        addPointToScene( renderer, pos[ i ], getModuleColor( int( i ) ) );
+        modulePoints.add( pos[ i ], getModuleColor( int( i ) ) );
     }
 
     // Show connector points (green)
     for ( size_t i = pts[ 0 ].size() - pts[ 1 ].size(); i < pos.size(); ++i ) {
-        addPointToScene( renderer, pos[ i ], { 0, 1, 0 }, 1 / 90.0 );
+        connectorPoints.add( pos[ i ], { 0, 1, 0 } );
     }
 
     // Show centroid (black)
-    addPointToScene( renderer, centroid( pos ), { 0, 0, 0 } );
+    modulePoints.add( centroid( pos ), { 0, 0, 0 } );
 
     if ( !showModules )
         return;
@@ -471,24 +772,7 @@ void buildRofiWorldPointsScene( vtkRenderer & renderer, RofiWorld world, bool sh
     auto result = world.prepare();
     assert( result );
 
-    // get active (i.e. connected) connectors for each module within RofiWorld
-    std::map< ModuleId, std::set< int > > activeConns;
-    for ( const auto & roficom : world.roficomConnections() ) {
-        auto sourceId = world.getModule( roficom.sourceModule )->getId();
-        auto destId = world.getModule( roficom.destModule )->getId();
-        activeConns[ sourceId ].insert( roficom.sourceConnector );
-        activeConns[ destId ].insert( roficom.destConnector );
-    }
-    int index = 0;
-    for ( auto & mInfo : world.modules() ) {
-        assert( mInfo.absPosition && "The rofi world has to be prepared" );
-        addModuleToScene( renderer,
-                          *mInfo.module,
-                          *mInfo.absPosition,
-                          index,
-                          activeConns[ mInfo.module->getId() ] );
-        index++;
-    }
+    buildRofiWorldScene( renderer, world );
 }
 
 void renderPoints( RofiWorld world, const std::string & displayName, bool showModules )
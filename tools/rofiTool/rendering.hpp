@@ -1,7 +1,11 @@
 #pragma once
 
+#include <filesystem>
+#include <functional>
+#include <optional>
 #include <span>
 
+#include <atoms/result.hpp>
 #include <configuration/rofiworld.hpp>
 
 
@@ -12,3 +16,32 @@ void renderRofiWorldSequence( std::span< const rofi::configuration::RofiWorld >
 void renderPoints( rofi::configuration::RofiWorld world,
                    const std::string & displayName = "Points of Rofi world",
                    bool showModules = false );
+
+struct FrameSettings {
+    std::filesystem::path outputDir;
+    int width = 1920;
+    int height = 1080;
+    size_t framesPerStep = 1; ///< frames from one world of the sequence to the next one
+    unsigned encoderCount = 1; ///< number of threads encoding the images
+};
+
+/**
+ * Source of the worlds of a sequence, returns the next prepared and valid world
+ * or `std::nullopt` at the end of the sequence
+ */
+using NextRofiWorld = std::function< atoms::Result< std::optional< rofi::configuration::RofiWorld > >() >;
+
+/**
+ * Render frames of a world sequence offscreen and write them to `settings.outputDir`
+ * as numbered PNG images (`frame_000000.png`, ...)
+ *
+ * The worlds are read from `nextWorld` as they are rendered, so that only two
+ * consecutive worlds are kept in memory.
+ * Joint positions are interpolated between consecutive worlds that differ only in joints,
+ * other worlds are shown without transition. Running without a display requires VTK
+ * built with offscreen support (OSMesa or EGL).
+ *
+ * Returns the number of written frames
+ */
+atoms::Result< size_t > renderRofiWorldSequenceFrames( const NextRofiWorld & nextWorld,
+                                                       const FrameSettings & settings );